@@ -0,0 +1,167 @@
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "../../common/fast_routing.h"
+
+// Route population time of Ipv4GlobalRoutingHelper ("global") against
+// common/fast_routing.h ("fast") for the star and chain topologies the
+// scenario programs build, over a range of sizes.
+//
+//   ./ns3 run "routing_setup_bench --topology=both --sizes=8,64,256,1024"
+//
+// Only the route population is timed; building the nodes, devices and
+// addresses is the same for both methods. The routes column is the number
+// of static plus global routing entries left on all nodes.
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("RoutingSetupBench");
+
+static uint32_t
+CountRoutes (void)
+{
+  Ipv4StaticRoutingHelper staticHelper;
+  uint32_t routes = 0;
+  for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+    {
+      Ptr<Ipv4> ipv4 = NodeList::GetNode (i)->GetObject<Ipv4> ();
+      routes += staticHelper.GetStaticRouting (ipv4)->GetNRoutes ();
+      Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (ipv4->GetRoutingProtocol ());
+      for (uint32_t j = 0; list && j < list->GetNRoutingProtocols (); ++j)
+        {
+          int16_t priority;
+          Ptr<Ipv4GlobalRouting> global = DynamicCast<Ipv4GlobalRouting> (list->GetRoutingProtocol (j, priority));
+          if (global)
+            {
+              routes += global->GetNRoutes ();
+            }
+        }
+    }
+  return routes;
+}
+
+// Builds the topology with n spokes or n chain nodes, populates the routes
+// and returns the seconds spent populating them.
+static double
+RunOnce (const std::string &topology, uint32_t n, bool fast, uint32_t &routes)
+{
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  InternetStackHelper internet;
+
+  std::chrono::steady_clock::duration elapsed;
+  if (topology == "star")
+    {
+      PointToPointStarHelper star (n, pointToPoint);
+      star.InstallStack (internet);
+      star.AssignIpv4Addresses (Ipv4AddressHelper ("10.1.1.0", "255.255.255.0"));
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      if (fast)
+        {
+          FastRouting::PopulateStar (star);
+        }
+      else
+        {
+          Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+        }
+      elapsed = std::chrono::steady_clock::now () - start;
+    }
+  else
+    {
+      NodeContainer nodes;
+      nodes.Create (n);
+      NetDeviceContainer devices;
+      for (uint32_t i = 0; i + 1 < n; ++i)
+        {
+          devices.Add (pointToPoint.Install (nodes.Get (i), nodes.Get (i + 1)));
+        }
+      internet.Install (nodes);
+      Ipv4AddressHelper ipv4;
+      ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+      for (uint32_t i = 0; i < devices.GetN (); i += 2)
+        {
+          ipv4.Assign (NetDeviceContainer (devices.Get (i), devices.Get (i + 1)));
+          ipv4.NewNetwork ();
+        }
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      if (fast)
+        {
+          FastRouting::PopulateChain (nodes, devices);
+        }
+      else
+        {
+          Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+        }
+      elapsed = std::chrono::steady_clock::now () - start;
+    }
+  routes = CountRoutes ();
+
+  // Empties the node list for the next run.
+  Simulator::Destroy ();
+  return std::chrono::duration<double> (elapsed).count ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string topology = "both";
+  std::string sizes = "8,32,128,512";
+  uint32_t repeat = 3;
+
+  CommandLine cmd;
+  cmd.AddValue ("topology", "star, chain or both", topology);
+  cmd.AddValue ("sizes", "Comma separated spoke counts (star) or node counts (chain)", sizes);
+  cmd.AddValue ("repeat", "Runs per size and method, the fastest one is reported", repeat);
+  cmd.Parse (argc, argv);
+
+  if (topology != "star" && topology != "chain" && topology != "both")
+    {
+      NS_FATAL_ERROR ("Unknown topology " << topology << ", expected star, chain or both");
+    }
+  std::vector<uint32_t> counts;
+  std::istringstream iss (sizes);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      uint32_t n = std::stoul (item);
+      NS_ABORT_MSG_IF (n < 2, "Sizes must be at least 2");
+      counts.push_back (n);
+    }
+
+  std::cout << "topology\tn\tmethod\troutes\tseconds" << std::endl;
+  const char *topologies[] = { "star", "chain" };
+  for (const char *t : topologies)
+    {
+      if (topology != "both" && topology != t)
+        {
+          continue;
+        }
+      for (uint32_t n : counts)
+        {
+          for (int fast = 0; fast <= 1; ++fast)
+            {
+              double best = 0;
+              uint32_t routes = 0;
+              for (uint32_t i = 0; i < repeat; ++i)
+                {
+                  double seconds = RunOnce (t, n, fast, routes);
+                  best = (i == 0 || seconds < best) ? seconds : best;
+                }
+              std::cout << t << "\t" << n << "\t" << (fast ? "fast" : "global") << "\t" << routes
+                        << "\t" << best << std::endl;
+            }
+        }
+    }
+
+  return 0;
+}
@@ -0,0 +1,327 @@
+#ifndef ADAPTATION_MONITOR_H
+#define ADAPTATION_MONITOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/traffic-control-module.h"
+
+namespace ns3 {
+
+// How the flows through a bottleneck adapt to its capacity changes.
+//
+// The bottleneck's rate, bytes sent, queue backlog (device queue plus the
+// queue disc, if any) and drops, and the bytes each flow delivered to the
+// sinks, are sampled every interval. A capacity change is detected by
+// comparing consecutive samples, so it does not matter what changed the
+// rate (LinkDynamics, a scenario's own event, ...). For each change and
+// each flow active after it, Write() reports:
+//
+//   reconverge_s     time until the flow's goodput over the smoothing
+//                    window stays within the tolerance of its fair share
+//                    (capacity / active flows) for the hold time; "-" when
+//                    it does not before the next change or the end
+//   peak_qdelay_ms   largest queueing delay (backlog / new capacity)
+//                    during the transition, next to base_qdelay_ms, the
+//                    mean over the second before the change
+//   drops            packets dropped at the bottleneck during the
+//                    transition
+//   lost_util        share of the new capacity not used during the
+//                    transition
+//
+// The transition runs from the change until the last flow has converged
+// (or the next change). Goodput excludes headers, so the tolerance has to
+// cover them (about 3% for 1460 byte segments).
+class AdaptationMonitor : public SimpleRefCount<AdaptationMonitor>
+{
+public:
+  AdaptationMonitor (Time interval = MilliSeconds (10), Time window = MilliSeconds (200),
+                     Time hold = MilliSeconds (500), double tolerance = 0.1)
+    : m_interval (interval),
+      m_window (std::max<int64_t> (1, window.GetTimeStep () / interval.GetTimeStep ())),
+      m_hold (std::max<int64_t> (1, hold.GetTimeStep () / interval.GetTimeStep ())),
+      m_tolerance (tolerance),
+      m_txBytes (0),
+      m_drops (0)
+  {
+  }
+
+  // The device whose transmit rate is the bottleneck (point-to-point or
+  // CSMA) and the queue disc installed on it, if any.
+  void SetBottleneck (Ptr<NetDevice> device, Ptr<QueueDisc> queueDisc = Ptr<QueueDisc> ())
+  {
+    m_device = device;
+    m_queueDisc = queueDisc;
+    device->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&AdaptationMonitor::PhyTxEnd, this));
+    PointerValue queue;
+    if (device->GetAttributeFailSafe ("TxQueue", queue))
+      {
+        m_queue = queue.Get<Queue<Packet> > ();
+        m_queue->TraceConnectWithoutContext ("Drop", MakeCallback (&AdaptationMonitor::QueueDrop, this));
+      }
+    if (queueDisc)
+      {
+        queueDisc->TraceConnectWithoutContext ("Drop", MakeCallback (&AdaptationMonitor::DiscDrop, this));
+      }
+  }
+
+  // One flow per sink, named after the source address and port of its
+  // first packet. Each sink's callback is bound to its own counter, so a
+  // packet costs one addition.
+  void MonitorSinks (ApplicationContainer sinks)
+  {
+    for (uint32_t i = 0; i < sinks.GetN (); ++i)
+      {
+        m_flows.push_back (SinkFlow ());
+        m_flowSamples.push_back (std::vector<uint64_t> (m_samples.size (), 0));
+        sinks.Get (i)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&AdaptationMonitor::SinkRx, &m_flows.back ()));
+      }
+  }
+
+  void SetMeta (const std::string &key, const std::string &value)
+  {
+    m_meta.push_back (std::make_pair (key, value));
+  }
+
+  void Start (Time start, Time stop)
+  {
+    m_stop = stop;
+    Simulator::Schedule (start - Simulator::Now (), &AdaptationMonitor::Poll, this);
+  }
+
+  // One line per change and flow, after "# key=value" metadata lines:
+  //   change time old_mbps new_mbps flow fair_mbps reconverge_s
+  //   base_qdelay_ms peak_qdelay_ms drops lost_util
+  bool Write (const std::string &path) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    for (const std::pair<std::string, std::string> &meta : m_meta)
+      {
+        out << "# " << meta.first << "=" << meta.second << "\n";
+      }
+    out << "change\ttime\told_mbps\tnew_mbps\tflow\tfair_mbps\treconverge_s\tbase_qdelay_ms\tpeak_qdelay_ms\tdrops\tlost_util\n";
+    uint32_t change = 0;
+    for (size_t i = 1; i < m_samples.size (); ++i)
+      {
+        if (m_samples[i].bps == m_samples[i - 1].bps)
+          {
+            continue;
+          }
+        size_t end = i + 1;
+        while (end < m_samples.size () && m_samples[end].bps == m_samples[i].bps)
+          {
+            ++end;
+          }
+        WriteChange (out, change++, i - 1, i, end);
+      }
+    return true;
+  }
+
+private:
+  struct Sample
+  {
+    double time;
+    uint64_t bps;
+    uint64_t txBytes;
+    uint64_t backlog;   // bytes
+    uint64_t drops;
+  };
+
+  struct SinkFlow
+  {
+    SinkFlow ()
+      : bytes (0)
+    {
+    }
+
+    uint64_t bytes;     // delivered so far
+    std::string name;   // "source:port", empty until the first packet
+  };
+
+  void PhyTxEnd (Ptr<const Packet> packet)
+  {
+    m_txBytes += packet->GetSize ();
+  }
+
+  void QueueDrop (Ptr<const Packet> packet)
+  {
+    ++m_drops;
+  }
+
+  void DiscDrop (Ptr<const QueueDiscItem> item)
+  {
+    ++m_drops;
+  }
+
+  static void SinkRx (SinkFlow *flow, Ptr<const Packet> packet, const Address &from)
+  {
+    flow->bytes += packet->GetSize ();
+    if (flow->name.empty ())
+      {
+        std::ostringstream oss;
+        InetSocketAddress address = InetSocketAddress::ConvertFrom (from);
+        oss << address.GetIpv4 () << ":" << address.GetPort ();
+        flow->name = oss.str ();
+      }
+  }
+
+  uint64_t GetRate () const
+  {
+    DataRateValue rate;
+    if (Ptr<CsmaChannel> csma = DynamicCast<CsmaChannel> (m_device->GetChannel ()))
+      {
+        csma->GetAttribute ("DataRate", rate);
+      }
+    else
+      {
+        m_device->GetAttribute ("DataRate", rate);
+      }
+    return rate.Get ().GetBitRate ();
+  }
+
+  void Poll ()
+  {
+    Sample sample;
+    sample.time = Simulator::Now ().GetSeconds ();
+    sample.bps = GetRate ();
+    sample.txBytes = m_txBytes;
+    sample.backlog = (m_queue ? m_queue->GetNBytes () : 0) + (m_queueDisc ? m_queueDisc->GetNBytes () : 0);
+    sample.drops = m_drops;
+    m_samples.push_back (sample);
+    for (uint32_t f = 0; f < m_flows.size (); ++f)
+      {
+        m_flowSamples[f].push_back (m_flows[f].bytes);
+      }
+    if (Simulator::Now () + m_interval <= m_stop)
+      {
+        Simulator::Schedule (m_interval, &AdaptationMonitor::Poll, this);
+      }
+  }
+
+  // Goodput of flow f over the smoothing window ending at sample j, bps.
+  double FlowRate (uint32_t f, size_t j) const
+  {
+    size_t from = j >= m_window ? j - m_window : 0;
+    double seconds = m_samples[j].time - m_samples[from].time;
+    return seconds > 0 ? (m_flowSamples[f][j] - m_flowSamples[f][from]) * 8 / seconds : 0;
+  }
+
+  // Change from sample before to sample first, new rate until sample end.
+  void WriteChange (std::ostream &out, uint32_t change, size_t before, size_t first, size_t end) const
+  {
+    double capacity = m_samples[first].bps;
+
+    // Flows that delivered anything after the change share the capacity.
+    std::vector<uint32_t> active;
+    for (uint32_t f = 0; f < m_flows.size (); ++f)
+      {
+        if (m_flowSamples[f][end - 1] > m_flowSamples[f][before])
+          {
+            active.push_back (f);
+          }
+      }
+    double fair = active.empty () ? capacity : capacity / active.size ();
+
+    std::vector<double> reconverge (active.size (), -1);
+    size_t transitionEnd = first;
+    bool allConverged = true;
+    for (uint32_t a = 0; a < active.size (); ++a)
+      {
+        size_t run = 0;
+        for (size_t j = first; j < end; ++j)
+          {
+            bool within = std::abs (FlowRate (active[a], j) - fair) <= m_tolerance * fair
+                          && j >= first + m_window;
+            run = within ? run + 1 : 0;
+            if (run == m_hold)
+              {
+                size_t converged = j + 1 - m_hold;
+                reconverge[a] = m_samples[converged].time - m_samples[first].time;
+                transitionEnd = std::max (transitionEnd, converged);
+                break;
+              }
+          }
+        allConverged = allConverged && reconverge[a] >= 0;
+      }
+    if (!allConverged || active.empty ())
+      {
+        transitionEnd = end - 1;
+      }
+
+    double baseDelay = 0;
+    uint32_t baseSamples = 0;
+    for (size_t j = before; m_samples[j].bps == m_samples[before].bps
+                            && m_samples[j].time > m_samples[before].time - 1.0; --j)
+      {
+        baseDelay += m_samples[j].backlog * 8.0 / m_samples[j].bps;
+        ++baseSamples;
+        if (j == 0)
+          {
+            break;
+          }
+      }
+    baseDelay = baseSamples ? baseDelay / baseSamples : 0;
+    double peakDelay = 0;
+    for (size_t j = first; j <= transitionEnd; ++j)
+      {
+        peakDelay = std::max (peakDelay, m_samples[j].backlog * 8.0 / capacity);
+      }
+    uint64_t drops = m_samples[transitionEnd].drops - m_samples[before].drops;
+    double seconds = m_samples[transitionEnd].time - m_samples[before].time;
+    double used = (m_samples[transitionEnd].txBytes - m_samples[before].txBytes) * 8.0;
+    double lost = seconds > 0 ? std::max (0.0, 1 - used / (capacity * seconds)) : 0;
+
+    std::ostringstream head;
+    head << change << "\t" << m_samples[first].time << "\t" << m_samples[before].bps / 1e6 << "\t" << capacity / 1e6;
+    std::ostringstream tail;
+    tail << "\t" << baseDelay * 1e3 << "\t" << peakDelay * 1e3 << "\t" << drops << "\t" << lost << "\n";
+    if (active.empty ())
+      {
+        out << head.str () << "\t-\t" << fair / 1e6 << "\t-" << tail.str ();
+      }
+    for (uint32_t a = 0; a < active.size (); ++a)
+      {
+        out << head.str () << "\t" << m_flows[active[a]].name << "\t" << fair / 1e6 << "\t";
+        if (reconverge[a] >= 0)
+          {
+            out << reconverge[a];
+          }
+        else
+          {
+            out << "-";
+          }
+        out << tail.str ();
+      }
+  }
+
+  Time m_interval;
+  size_t m_window;     // samples
+  size_t m_hold;       // samples
+  double m_tolerance;
+  Time m_stop;
+  Ptr<NetDevice> m_device;
+  Ptr<Queue<Packet> > m_queue;
+  Ptr<QueueDisc> m_queueDisc;
+  uint64_t m_txBytes;
+  uint64_t m_drops;
+  std::vector<Sample> m_samples;
+  std::deque<SinkFlow> m_flows;   // a deque keeps the bound counters in place
+  std::vector<std::vector<uint64_t> > m_flowSamples;   // [flow][sample] bytes delivered
+  std::vector<std::pair<std::string, std::string> > m_meta;
+};
+
+} // namespace ns3
+
+#endif /* ADAPTATION_MONITOR_H */
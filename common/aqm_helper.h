@@ -0,0 +1,232 @@
+#ifndef AQM_HELPER_H
+#define AQM_HELPER_H
+
+#include <fstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/traffic-control-module.h"
+
+namespace ns3 {
+
+// Bottleneck queue management for the scenario programs.
+//
+// FIFO keeps the old setup: a DropTail device queue of the configured size
+// and whatever Ipv4AddressHelper::Assign installs by default. RED, FqCoDel
+// and PIE install the queue disc on the given devices through a
+// TrafficControlHelper and shrink the device queue to one packet, so the
+// backlog builds up in the queue disc where the AQM can act on it.
+//
+// ECN is the step marking queue DCTCP expects: RED with MinTh = MaxTh = K
+// packets and QW = 1, so every ECN capable packet that arrives to an
+// instantaneous queue of K packets or more is marked instead of dropped.
+// It only marks if the endpoints negotiate ECN; EnableEcn() turns that on
+// for every TCP socket.
+//
+// Install() has to run after the internet stack is installed and before
+// the addresses are assigned (Assign adds the default root queue disc to
+// devices that have none).
+class AqmHelper
+{
+public:
+  AqmHelper (const std::string &kind, const std::string &limit, uint32_t ecnThreshold = 5)
+    : m_kind (kind),
+      m_limit (limit),
+      m_ecnThreshold (ecnThreshold)
+  {
+  }
+
+  static bool IsKnown (const std::string &kind)
+  {
+    return kind == "FIFO" || kind == "RED" || kind == "FqCoDel" || kind == "PIE" || kind == "ECN";
+  }
+
+  bool IsFifo () const
+  {
+    return m_kind == "FIFO";
+  }
+
+  bool IsEcn () const
+  {
+    return m_kind == "ECN";
+  }
+
+  // ECN negotiation on every TCP socket created afterwards, senders and
+  // receivers alike.
+  static void EnableEcn ()
+  {
+    Config::SetDefault ("ns3::TcpSocketBase::UseEcn", StringValue ("On"));
+  }
+
+  // MaxSize for the device transmit queue.
+  std::string GetDeviceQueueSize () const
+  {
+    return IsFifo () ? m_limit : "1p";
+  }
+
+  // Installs the queue disc on devices; a no-op for FIFO. The attributes
+  // not set here come from Config::SetDefault.
+  QueueDiscContainer Install (NetDeviceContainer devices) const
+  {
+    if (IsFifo ())
+      {
+        return QueueDiscContainer ();
+      }
+    TrafficControlHelper tch;
+    if (IsEcn ())
+      {
+        tch.SetRootQueueDisc ("ns3::RedQueueDisc",
+                              "MaxSize", QueueSizeValue (QueueSize (m_limit)),
+                              "MinTh", DoubleValue (m_ecnThreshold),
+                              "MaxTh", DoubleValue (m_ecnThreshold),
+                              "QW", DoubleValue (1),
+                              "Gentle", BooleanValue (false),
+                              "UseEcn", BooleanValue (true),
+                              "UseHardDrop", BooleanValue (false));
+      }
+    else
+      {
+        tch.SetRootQueueDisc (GetTypeName (), "MaxSize", QueueSizeValue (QueueSize (m_limit)));
+      }
+    return tch.Install (devices);
+  }
+
+  // Fixes the random streams of the RED and PIE drop decisions; returns
+  // the number of streams used.
+  static int64_t AssignStreams (QueueDiscContainer queueDiscs, int64_t stream)
+  {
+    int64_t current = stream;
+    for (uint32_t i = 0; i < queueDiscs.GetN (); ++i)
+      {
+        if (Ptr<RedQueueDisc> red = DynamicCast<RedQueueDisc> (queueDiscs.Get (i)))
+          {
+            current += red->AssignStreams (current);
+          }
+        else if (Ptr<PieQueueDisc> pie = DynamicCast<PieQueueDisc> (queueDiscs.Get (i)))
+          {
+            current += pie->AssignStreams (current);
+          }
+      }
+    return current - stream;
+  }
+
+  // Adds the packets received, marked and dropped by queueDiscs and the
+  // share of them that was marked to a run metrics file
+  // (common/run_metrics.h).
+  static bool AppendMetrics (const std::string &path, QueueDiscContainer queueDiscs)
+  {
+    std::ofstream out (path.c_str (), std::ios::app);
+    if (!out)
+      {
+        return false;
+      }
+    uint64_t received = 0;
+    uint64_t marked = 0;
+    uint64_t dropped = 0;
+    for (uint32_t i = 0; i < queueDiscs.GetN (); ++i)
+      {
+        const QueueDisc::Stats &stats = queueDiscs.Get (i)->GetStats ();
+        received += stats.nTotalReceivedPackets;
+        marked += stats.nTotalMarkedPackets;
+        dropped += stats.nTotalDroppedPackets;
+      }
+    out << "queue_packets\t" << received << "\n";
+    out << "queue_marks\t" << marked << "\n";
+    out << "queue_drops\t" << dropped << "\n";
+    out << "mark_ratio\t" << (received ? double (marked) / received : 0) << "\n";
+    return true;
+  }
+
+private:
+  std::string GetTypeName () const
+  {
+    if (m_kind == "RED" || m_kind == "ECN")
+      {
+        return "ns3::RedQueueDisc";
+      }
+    if (m_kind == "FqCoDel")
+      {
+        return "ns3::FqCoDelQueueDisc";
+      }
+    if (m_kind == "PIE")
+      {
+        return "ns3::PieQueueDisc";
+      }
+    NS_FATAL_ERROR ("Unknown queue " << m_kind << ", expected FIFO, RED, FqCoDel, PIE or ECN");
+    return "";
+  }
+
+  std::string m_kind;
+  std::string m_limit;
+  uint32_t m_ecnThreshold;   // packets
+};
+
+// Writes queue disc length changes, drops and ECN marks as tab separated
+// lines:
+//   <time s> <queue id> len  <packets>
+//   <time s> <queue id> drop <reason>
+//   <time s> <queue id> mark <reason>
+class AqmTraceSink : public SimpleRefCount<AqmTraceSink>
+{
+public:
+  void Open (const std::string &path)
+  {
+    AsciiTraceHelper ascii;
+    m_stream = ascii.CreateFileStream (path);
+  }
+
+  void Connect (Ptr<QueueDisc> queueDisc, uint32_t id)
+  {
+    Ptr<QueueTracer> tracer = Create<QueueTracer> (m_stream, id);
+    m_tracers.push_back (tracer);
+    queueDisc->TraceConnectWithoutContext ("PacketsInQueue", MakeCallback (&QueueTracer::Length, tracer));
+    queueDisc->TraceConnectWithoutContext ("DropBeforeEnqueue", MakeCallback (&QueueTracer::Drop, tracer));
+    queueDisc->TraceConnectWithoutContext ("DropAfterDequeue", MakeCallback (&QueueTracer::Drop, tracer));
+    queueDisc->TraceConnectWithoutContext ("Mark", MakeCallback (&QueueTracer::Mark, tracer));
+  }
+
+  void Connect (QueueDiscContainer queueDiscs)
+  {
+    for (uint32_t i = 0; i < queueDiscs.GetN (); ++i)
+      {
+        Connect (queueDiscs.Get (i), i);
+      }
+  }
+
+private:
+  class QueueTracer : public SimpleRefCount<QueueTracer>
+  {
+  public:
+    QueueTracer (Ptr<OutputStreamWrapper> stream, uint32_t id)
+      : m_stream (stream),
+        m_id (id)
+    {
+    }
+
+    void Length (uint32_t oldValue, uint32_t newValue)
+    {
+      *m_stream->GetStream () << Simulator::Now ().GetSeconds () << "\t" << m_id << "\tlen\t" << newValue << "\n";
+    }
+
+    void Drop (Ptr<const QueueDiscItem> item, const char *reason)
+    {
+      *m_stream->GetStream () << Simulator::Now ().GetSeconds () << "\t" << m_id << "\tdrop\t" << reason << "\n";
+    }
+
+    void Mark (Ptr<const QueueDiscItem> item, const char *reason)
+    {
+      *m_stream->GetStream () << Simulator::Now ().GetSeconds () << "\t" << m_id << "\tmark\t" << reason << "\n";
+    }
+
+  private:
+    Ptr<OutputStreamWrapper> m_stream;
+    uint32_t m_id;
+  };
+
+  Ptr<OutputStreamWrapper> m_stream;
+  std::vector<Ptr<QueueTracer> > m_tracers;
+};
+
+} // namespace ns3
+
+#endif /* AQM_HELPER_H */
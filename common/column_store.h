@@ -0,0 +1,446 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+// Columnar on-disk format for run results (cwnd series, per-flow receive
+// counters) that is read back through mmap, so comparing the whole
+// slide5/slide6 matrix does not re-parse dozens of text files.
+//
+// One .cols file holds one series: a set of equally long columns plus
+// "key=value" metadata describing the run (slide, scenario, queue, tcp,
+// series, ...). Layout, native byte order:
+//
+//   ColumnFileHeader
+//   metaBytes of "key=value\n" text, padded to 8 bytes
+//   nColumns ColumnDesc
+//   column data, each column 8-byte aligned
+//
+// Written by the scenario programs (csma_ethernet/two_hop) and by
+// tools/cwnd_import.cc for the existing .cwnd files, queried with
+// tools/cwnd_query.cc. No ns-3 dependency.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum ColumnType
+{
+  COLUMN_F64 = 1,
+  COLUMN_U32 = 2,
+  COLUMN_U64 = 3,
+};
+
+struct ColumnFileHeader
+{
+  char magic[8];           // "NSCOLUMN"
+  uint32_t version;
+  uint32_t nColumns;
+  uint64_t nRows;
+  uint32_t metaBytes;      // including padding
+  uint32_t reserved;
+};
+
+struct ColumnDesc
+{
+  char name[24];           // NUL terminated
+  uint32_t type;           // ColumnType
+  uint32_t reserved;
+  uint64_t offset;         // from the start of the file
+};
+
+static const uint32_t COLUMN_FILE_VERSION = 1;
+
+template <typename T> struct ColumnTypeOf;
+template <> struct ColumnTypeOf<double> { static const uint32_t value = COLUMN_F64; };
+template <> struct ColumnTypeOf<uint32_t> { static const uint32_t value = COLUMN_U32; };
+template <> struct ColumnTypeOf<uint64_t> { static const uint32_t value = COLUMN_U64; };
+
+inline uint32_t
+ColumnTypeSize (uint32_t type)
+{
+  return type == COLUMN_U32 ? 4 : 8;
+}
+
+// Collects metadata and columns, then writes them in one go. The column
+// vectors are referenced, not copied, and have to outlive Write().
+class ColumnFileWriter
+{
+public:
+  void SetMeta (const std::string &key, const std::string &value)
+  {
+    m_meta[key] = value;
+  }
+
+  template <typename T>
+  void AddColumn (const std::string &name, const std::vector<T> &values)
+  {
+    Column column;
+    column.name = name;
+    column.type = ColumnTypeOf<T>::value;
+    column.data = values.data ();
+    column.rows = values.size ();
+    m_columns.push_back (column);
+  }
+
+  bool Write (const std::string &path) const
+  {
+    uint64_t rows = m_columns.empty () ? 0 : m_columns[0].rows;
+    for (const Column &column : m_columns)
+      {
+        if (column.rows != rows || column.name.size () >= sizeof (ColumnDesc ().name))
+          {
+            return false;
+          }
+      }
+
+    std::string meta;
+    for (std::map<std::string, std::string>::const_iterator it = m_meta.begin (); it != m_meta.end (); ++it)
+      {
+        meta += it->first + "=" + it->second + "\n";
+      }
+    meta.resize (Align (meta.size ()), '\0');
+
+    ColumnFileHeader header;
+    std::memset (&header, 0, sizeof (header));
+    std::memcpy (header.magic, "NSCOLUMN", 8);
+    header.version = COLUMN_FILE_VERSION;
+    header.nColumns = m_columns.size ();
+    header.nRows = rows;
+    header.metaBytes = meta.size ();
+
+    std::vector<ColumnDesc> descs (m_columns.size ());
+    uint64_t offset = sizeof (header) + meta.size () + descs.size () * sizeof (ColumnDesc);
+    for (size_t i = 0; i < m_columns.size (); ++i)
+      {
+        std::memset (&descs[i], 0, sizeof (ColumnDesc));
+        std::strncpy (descs[i].name, m_columns[i].name.c_str (), sizeof (descs[i].name) - 1);
+        descs[i].type = m_columns[i].type;
+        descs[i].offset = offset;
+        offset += Align (rows * ColumnTypeSize (m_columns[i].type));
+      }
+
+    std::FILE *file = std::fopen (path.c_str (), "wb");
+    if (!file)
+      {
+        return false;
+      }
+    bool ok = std::fwrite (&header, sizeof (header), 1, file) == 1
+              && std::fwrite (meta.data (), 1, meta.size (), file) == meta.size ()
+              && (descs.empty () || std::fwrite (descs.data (), sizeof (ColumnDesc), descs.size (), file) == descs.size ());
+    static const char zeros[8] = { 0 };
+    for (size_t i = 0; ok && i < m_columns.size (); ++i)
+      {
+        size_t bytes = rows * ColumnTypeSize (m_columns[i].type);
+        ok = std::fwrite (m_columns[i].data, 1, bytes, file) == bytes
+             && std::fwrite (zeros, 1, Align (bytes) - bytes, file) == Align (bytes) - bytes;
+      }
+    return std::fclose (file) == 0 && ok;
+  }
+
+private:
+  struct Column
+  {
+    std::string name;
+    uint32_t type;
+    const void *data;
+    uint64_t rows;
+  };
+
+  static uint64_t Align (uint64_t n)
+  {
+    return (n + 7) & ~uint64_t (7);
+  }
+
+  std::map<std::string, std::string> m_meta;
+  std::vector<Column> m_columns;
+};
+
+// Read-only view of one .cols file through mmap.
+class ColumnFile
+{
+public:
+  ColumnFile ()
+    : m_base (0),
+      m_size (0)
+  {
+  }
+
+  ~ColumnFile ()
+  {
+    Close ();
+  }
+
+  ColumnFile (const ColumnFile &) = delete;
+  ColumnFile &operator= (const ColumnFile &) = delete;
+
+  bool Open (const std::string &path)
+  {
+    Close ();
+    int fd = ::open (path.c_str (), O_RDONLY);
+    if (fd < 0)
+      {
+        return false;
+      }
+    struct stat st;
+    if (::fstat (fd, &st) != 0 || static_cast<size_t> (st.st_size) < sizeof (ColumnFileHeader))
+      {
+        ::close (fd);
+        return false;
+      }
+    void *base = ::mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close (fd);
+    if (base == MAP_FAILED)
+      {
+        return false;
+      }
+    m_base = static_cast<const char *> (base);
+    m_size = st.st_size;
+    m_path = path;
+    if (!Validate ())
+      {
+        Close ();
+        return false;
+      }
+    return true;
+  }
+
+  void Close ()
+  {
+    if (m_base)
+      {
+        ::munmap (const_cast<char *> (m_base), m_size);
+      }
+    m_base = 0;
+    m_size = 0;
+    m_meta.clear ();
+  }
+
+  const std::string &GetPath () const
+  {
+    return m_path;
+  }
+
+  uint64_t GetRows () const
+  {
+    return Header ()->nRows;
+  }
+
+  // Empty string when the key is not set.
+  std::string GetMeta (const std::string &key) const
+  {
+    std::map<std::string, std::string>::const_iterator it = m_meta.find (key);
+    return it == m_meta.end () ? std::string () : it->second;
+  }
+
+  const std::map<std::string, std::string> &GetAllMeta () const
+  {
+    return m_meta;
+  }
+
+  // Null when the column does not exist or has a different type.
+  template <typename T>
+  const T *GetColumn (const std::string &name) const
+  {
+    const ColumnDesc *descs = Descs ();
+    for (uint32_t i = 0; i < Header ()->nColumns; ++i)
+      {
+        if (name == descs[i].name && descs[i].type == ColumnTypeOf<T>::value)
+          {
+            return reinterpret_cast<const T *> (m_base + descs[i].offset);
+          }
+      }
+    return 0;
+  }
+
+private:
+  const ColumnFileHeader *Header () const
+  {
+    return reinterpret_cast<const ColumnFileHeader *> (m_base);
+  }
+
+  const ColumnDesc *Descs () const
+  {
+    return reinterpret_cast<const ColumnDesc *> (m_base + sizeof (ColumnFileHeader) + Header ()->metaBytes);
+  }
+
+  bool Validate ()
+  {
+    const ColumnFileHeader *header = Header ();
+    if (std::memcmp (header->magic, "NSCOLUMN", 8) != 0 || header->version != COLUMN_FILE_VERSION)
+      {
+        return false;
+      }
+    uint64_t descEnd = sizeof (ColumnFileHeader) + uint64_t (header->metaBytes)
+                       + uint64_t (header->nColumns) * sizeof (ColumnDesc);
+    if (descEnd > m_size)
+      {
+        return false;
+      }
+    const ColumnDesc *descs = Descs ();
+    for (uint32_t i = 0; i < header->nColumns; ++i)
+      {
+        if (descs[i].offset % 8 || descs[i].offset + header->nRows * ColumnTypeSize (descs[i].type) > m_size
+            || std::memchr (descs[i].name, '\0', sizeof (descs[i].name)) == 0)
+          {
+            return false;
+          }
+      }
+
+    const char *p = m_base + sizeof (ColumnFileHeader);
+    const char *end = p + header->metaBytes;
+    while (p < end && *p)
+      {
+        const char *eol = static_cast<const char *> (std::memchr (p, '\n', end - p));
+        if (!eol)
+          {
+            break;
+          }
+        const char *eq = static_cast<const char *> (std::memchr (p, '=', eol - p));
+        if (eq)
+          {
+            m_meta[std::string (p, eq)] = std::string (eq + 1, eol);
+          }
+        p = eol + 1;
+      }
+    return true;
+  }
+
+  const char *m_base;
+  size_t m_size;
+  std::string m_path;
+  std::map<std::string, std::string> m_meta;
+};
+
+// All .cols files of one directory, selectable by metadata.
+class ColumnStore
+{
+public:
+  ~ColumnStore ()
+  {
+    for (ColumnFile *file : m_files)
+      {
+        delete file;
+      }
+  }
+
+  // Maps every readable .cols file in dir; returns the number added.
+  size_t OpenDirectory (const std::string &dir)
+  {
+    DIR *d = ::opendir (dir.c_str ());
+    if (!d)
+      {
+        return 0;
+      }
+    std::vector<std::string> names;
+    while (struct dirent *entry = ::readdir (d))
+      {
+        std::string name = entry->d_name;
+        if (name.size () > 5 && name.compare (name.size () - 5, 5, ".cols") == 0)
+          {
+            names.push_back (name);
+          }
+      }
+    ::closedir (d);
+    std::sort (names.begin (), names.end ());
+    size_t added = 0;
+    for (const std::string &name : names)
+      {
+        added += Add (dir + "/" + name) ? 1 : 0;
+      }
+    return added;
+  }
+
+  bool Add (const std::string &path)
+  {
+    ColumnFile *file = new ColumnFile;
+    if (!file->Open (path))
+      {
+        delete file;
+        return false;
+      }
+    m_files.push_back (file);
+    return true;
+  }
+
+  // Files whose metadata matches every key=value pair in where.
+  std::vector<const ColumnFile *>
+  Select (const std::vector<std::pair<std::string, std::string> > &where) const
+  {
+    std::vector<const ColumnFile *> result;
+    for (const ColumnFile *file : m_files)
+      {
+        bool match = true;
+        for (const std::pair<std::string, std::string> &cond : where)
+          {
+            if (file->GetMeta (cond.first) != cond.second)
+              {
+                match = false;
+                break;
+              }
+          }
+        if (match)
+          {
+            result.push_back (file);
+          }
+      }
+    return result;
+  }
+
+  size_t GetN () const
+  {
+    return m_files.size ();
+  }
+
+private:
+  std::vector<ColumnFile *> m_files;
+};
+
+// Summary of a cwnd series ("time", "old", "new" columns) over [from, to].
+struct CwndStats
+{
+  uint64_t changes;
+  double mean;             // time weighted, bytes
+  uint32_t max;
+  uint32_t last;
+};
+
+inline bool
+ComputeCwndStats (const ColumnFile &file, double from, double to, CwndStats &stats)
+{
+  const double *time = file.GetColumn<double> ("time");
+  const uint32_t *cwnd = file.GetColumn<uint32_t> ("new");
+  if (!time || !cwnd)
+    {
+      return false;
+    }
+  uint64_t n = file.GetRows ();
+  uint64_t i = std::lower_bound (time, time + n, from) - time;
+  stats.changes = 0;
+  stats.last = i > 0 ? cwnd[i - 1] : 0;
+  stats.max = stats.last;
+  double area = 0;
+  double t = from;
+  for (; i < n && time[i] <= to; ++i)
+    {
+      area += stats.last * (time[i] - t);
+      t = time[i];
+      stats.last = cwnd[i];
+      stats.max = std::max (stats.max, cwnd[i]);
+      stats.changes++;
+    }
+  area += stats.last * (to - t);
+  stats.mean = to > from ? area / (to - from) : stats.last;
+  return true;
+}
+
+#endif /* COLUMN_STORE_H */
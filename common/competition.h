@@ -0,0 +1,229 @@
+#ifndef COMPETITION_H
+#define COMPETITION_H
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+
+namespace ns3 {
+
+// Several congestion control variants sharing one bottleneck in one run.
+//
+// CreateSocket() picks the variant per socket through
+// TcpL4Protocol::CreateSocket (TypeId) instead of the global
+// TcpL4Protocol::SocketType default, so any mix of variants can run side by
+// side. Each flow needs a sink of its own; Write() reports per flow and per
+// variant the goodput over the measurement window, its share of the total,
+// the mean and minimum RTT and the queueing delay (mean minus minimum
+// RTT), and Jain's fairness index over the flows and over the variants
+// (mean goodput per flow of each variant).
+class Competition : public SimpleRefCount<Competition>
+{
+public:
+  // Splits "ns3::TcpCubic,ns3::TcpNewReno" into checked TypeIds.
+  static std::vector<TypeId> ParseVariants (const std::string &list)
+  {
+    std::vector<TypeId> variants;
+    std::istringstream iss (list);
+    std::string name;
+    while (std::getline (iss, name, ','))
+      {
+        if (name.empty ())
+          {
+            continue;
+          }
+        if (name.find ("::") == std::string::npos)
+          {
+            name = "ns3::" + name;
+          }
+        TypeId tid;
+        NS_ABORT_MSG_IF (!TypeId::LookupByNameFailSafe (name, &tid),
+                         "Unknown congestion control TypeId " << name);
+        variants.push_back (tid);
+      }
+    return variants;
+  }
+
+  static Ptr<Socket> CreateSocket (Ptr<Node> node, TypeId congestionControl)
+  {
+    Ptr<TcpL4Protocol> tcp = node->GetObject<TcpL4Protocol> ();
+    NS_ABORT_MSG_IF (!tcp, "Node " << node->GetId () << " has no TCP");
+    return tcp->CreateSocket (congestionControl);
+  }
+
+  // Goodput is counted between from and to; call before Start.
+  void SetWindow (Time from, Time to)
+  {
+    m_from = from;
+    m_to = to;
+  }
+
+  // socket sends to sink; variant names the flow's group in the report.
+  void AddFlow (const std::string &variant, Ptr<Socket> socket, Ptr<PacketSink> sink)
+  {
+    Flow flow;
+    flow.variant = variant;
+    flow.sink = sink;
+    m_flows.push_back (flow);
+    socket->TraceConnectWithoutContext ("RTT", MakeBoundCallback (&Competition::RttChange, this,
+                                                                  uint32_t (m_flows.size () - 1)));
+  }
+
+  uint32_t GetNFlows () const
+  {
+    return m_flows.size ();
+  }
+
+  // Schedules the reading of the sinks at the window's edges.
+  void Start ()
+  {
+    if (!m_from.IsZero ())
+      {
+        Simulator::Schedule (m_from - Simulator::Now (), &Competition::Snapshot, this, true);
+      }
+    Simulator::Schedule (m_to - Simulator::Now (), &Competition::Snapshot, this, false);
+  }
+
+  static double JainIndex (const std::vector<double> &x)
+  {
+    double sum = 0;
+    double squares = 0;
+    for (double v : x)
+      {
+        sum += v;
+        squares += v * v;
+      }
+    return squares > 0 ? sum * sum / (x.size () * squares) : 0;
+  }
+
+  // "# key=value" lines (metadata, flows, jain_flows, jain_variants), then
+  //   variant flow throughput_mbps share mean_rtt_ms min_rtt_ms qdelay_ms
+  // one line per flow, and one per variant with flow "all" (throughput
+  // summed, RTTs averaged over its flows).
+  bool Write (const std::string &path, const std::vector<std::pair<std::string, std::string> > &meta) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    double seconds = (m_to - m_from).GetSeconds ();
+    std::vector<double> mbps;
+    double total = 0;
+    std::vector<std::string> order;
+    std::map<std::string, std::vector<uint32_t> > variants;
+    for (uint32_t i = 0; i < m_flows.size (); ++i)
+      {
+        const Flow &flow = m_flows[i];
+        mbps.push_back (seconds > 0 ? (flow.rxEnd - flow.rxStart) * 8.0 / seconds / 1e6 : 0);
+        total += mbps.back ();
+        if (variants.find (flow.variant) == variants.end ())
+          {
+            order.push_back (flow.variant);
+          }
+        variants[flow.variant].push_back (i);
+      }
+    std::vector<double> perVariant;
+    for (const std::string &variant : order)
+      {
+        double sum = 0;
+        for (uint32_t i : variants[variant])
+          {
+            sum += mbps[i];
+          }
+        perVariant.push_back (sum / variants[variant].size ());
+      }
+
+    for (const std::pair<std::string, std::string> &kv : meta)
+      {
+        out << "# " << kv.first << "=" << kv.second << "\n";
+      }
+    out << "# flows=" << m_flows.size () << "\n";
+    out << "# jain_flows=" << JainIndex (mbps) << "\n";
+    out << "# jain_variants=" << JainIndex (perVariant) << "\n";
+    out << "variant\tflow\tthroughput_mbps\tshare\tmean_rtt_ms\tmin_rtt_ms\tqdelay_ms\n";
+    for (uint32_t i = 0; i < m_flows.size (); ++i)
+      {
+        const Flow &flow = m_flows[i];
+        double mean = flow.rttSamples ? flow.rttSum / flow.rttSamples : 0;
+        out << flow.variant << "\t" << i << "\t" << mbps[i] << "\t" << (total > 0 ? mbps[i] / total : 0)
+            << "\t" << mean * 1e3 << "\t" << flow.rttMin * 1e3 << "\t" << (mean - flow.rttMin) * 1e3 << "\n";
+      }
+    for (const std::string &variant : order)
+      {
+        double sum = 0;
+        double mean = 0;
+        double min = 0;
+        const std::vector<uint32_t> &flows = variants.find (variant)->second;
+        for (uint32_t i : flows)
+          {
+            const Flow &flow = m_flows[i];
+            sum += mbps[i];
+            mean += flow.rttSamples ? flow.rttSum / flow.rttSamples : 0;
+            min += flow.rttMin;
+          }
+        mean /= flows.size ();
+        min /= flows.size ();
+        out << variant << "\tall\t" << sum << "\t" << (total > 0 ? sum / total : 0) << "\t" << mean * 1e3
+            << "\t" << min * 1e3 << "\t" << (mean - min) * 1e3 << "\n";
+      }
+    return true;
+  }
+
+private:
+  struct Flow
+  {
+    Flow ()
+      : rxStart (0),
+        rxEnd (0),
+        rttSum (0),
+        rttMin (0),
+        rttSamples (0)
+    {
+    }
+
+    std::string variant;
+    Ptr<PacketSink> sink;
+    uint64_t rxStart;   // sink bytes at the window's edges
+    uint64_t rxEnd;
+    double rttSum;      // seconds, over RTT updates inside the window
+    double rttMin;
+    uint32_t rttSamples;
+  };
+
+  static void RttChange (Competition *competition, uint32_t flow, Time oldRtt, Time newRtt)
+  {
+    Time now = Simulator::Now ();
+    if (now < competition->m_from || now > competition->m_to || newRtt.IsZero ())
+      {
+        return;
+      }
+    Flow &f = competition->m_flows[flow];
+    double rtt = newRtt.GetSeconds ();
+    f.rttMin = f.rttSamples ? std::min (f.rttMin, rtt) : rtt;
+    f.rttSum += rtt;
+    ++f.rttSamples;
+  }
+
+  void Snapshot (bool start)
+  {
+    for (Flow &flow : m_flows)
+      {
+        (start ? flow.rxStart : flow.rxEnd) = flow.sink->GetTotalRx ();
+      }
+  }
+
+  std::vector<Flow> m_flows;
+  Time m_from;
+  Time m_to;
+};
+
+} // namespace ns3
+
+#endif /* COMPETITION_H */
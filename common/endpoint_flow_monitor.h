@@ -0,0 +1,240 @@
+#ifndef ENDPOINT_FLOW_MONITOR_H
+#define ENDPOINT_FLOW_MONITOR_H
+
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "flow_hash_table.h"
+#include "latency_tag.h"
+#include "run_metrics.h"
+
+namespace ns3 {
+
+// Opt-in alternative to FlowMonitorHelper::InstallAll for runs that only
+// need the end to end numbers of a few flows: the scenario registers the
+// flows of interest up front (Watch) and installs the monitor on their end
+// nodes only, so transit hops see no probes at all, and packets of other
+// flows are neither tagged nor counted.
+//
+// A packet's five tuple is looked up in a FlowHashTable
+// (common/flow_hash_table.h); the first packet of an unknown tuple is
+// matched against the watch list once and the answer is cached, so later
+// packets cost one hash lookup. Each distinct tuple that matches becomes
+// one flow with FlowMonitor::FlowStats, numbered from 1 in order of first
+// packet, so the existing FlowMonitor loops and WriteRunMetrics
+// work on it unchanged.
+//
+// Without probes on the path, drops are not seen where they happen: lost
+// packets are those sent and never received, including the ones still in
+// flight when the run stops. timesForwarded stays zero.
+class EndpointFlowMonitor : public SimpleRefCount<EndpointFlowMonitor>
+{
+public:
+  // Watches the packets to destination:destinationPort; source
+  // Ipv4Address::GetAny () and port 0 match any.
+  void Watch (Ipv4Address destination, uint16_t destinationPort, Ipv4Address source = Ipv4Address::GetAny ())
+  {
+    Filter filter;
+    filter.source = source;
+    filter.destination = destination;
+    filter.destinationPort = destinationPort;
+    m_filters.push_back (filter);
+  }
+
+  // Installs the probes on the senders and receivers of the watched flows.
+  void Install (NodeContainer endpoints)
+  {
+    for (NodeContainer::Iterator it = endpoints.Begin (); it != endpoints.End (); ++it)
+      {
+        Ptr<Ipv4L3Protocol> ipv4 = (*it)->GetObject<Ipv4L3Protocol> ();
+        NS_ABORT_MSG_IF (!ipv4, "EndpointFlowMonitor: node " << (*it)->GetId () << " has no IPv4 stack");
+        ipv4->TraceConnectWithoutContext ("SendOutgoing", MakeCallback (&EndpointFlowMonitor::Sent, this));
+        ipv4->TraceConnectWithoutContext ("LocalDeliver", MakeCallback (&EndpointFlowMonitor::Delivered, this));
+      }
+  }
+
+  void Install (Ptr<Node> endpoint)
+  {
+    Install (NodeContainer (endpoint));
+  }
+
+  // Same container as FlowMonitor::GetFlowStats, built on demand.
+  FlowMonitor::FlowStatsContainer GetFlowStats () const
+  {
+    FlowMonitor::FlowStatsContainer stats;
+    for (uint32_t i = 0; i < m_flows.size (); ++i)
+      {
+        FlowMonitor::FlowStats flow = m_flows[i].stats;
+        flow.lostPackets = flow.txPackets > flow.rxPackets ? flow.txPackets - flow.rxPackets : 0;
+        stats[i + 1] = flow;
+      }
+    return stats;
+  }
+
+  Ipv4FlowClassifier::FiveTuple FindFlow (FlowId flowId) const
+  {
+    NS_ABORT_MSG_IF (flowId == 0 || flowId > m_flows.size (), "EndpointFlowMonitor: unknown flow " << flowId);
+    return m_flows[flowId - 1].tuple;
+  }
+
+  uint32_t GetNFlows () const
+  {
+    return m_flows.size ();
+  }
+
+private:
+  struct Filter
+  {
+    Ipv4Address source;
+    Ipv4Address destination;
+    uint16_t destinationPort;
+  };
+
+  struct Flow
+  {
+    Ipv4FlowClassifier::FiveTuple tuple;
+    FlowMonitor::FlowStats stats;
+  };
+
+  static constexpr int32_t NOT_WATCHED = -1;
+
+  static bool Key (const Ipv4Header &header, Ptr<const Packet> packet, FlowKey &key)
+  {
+    key.source = header.GetSource ().Get ();
+    key.destination = header.GetDestination ().Get ();
+    key.protocol = header.GetProtocol ();
+    key.sourcePort = 0;
+    key.destinationPort = 0;
+    if (key.protocol == UdpL4Protocol::PROT_NUMBER)
+      {
+        UdpHeader udp;
+        if (!packet->PeekHeader (udp))
+          {
+            return false;
+          }
+        key.sourcePort = udp.GetSourcePort ();
+        key.destinationPort = udp.GetDestinationPort ();
+      }
+    else if (key.protocol == TcpL4Protocol::PROT_NUMBER)
+      {
+        TcpHeader tcp;
+        if (!packet->PeekHeader (tcp))
+          {
+            return false;
+          }
+        key.sourcePort = tcp.GetSourcePort ();
+        key.destinationPort = tcp.GetDestinationPort ();
+      }
+    return true;
+  }
+
+  // Flow index of the tuple, or NOT_WATCHED; unknown tuples are matched
+  // against the watch list and remembered either way.
+  int32_t Classify (const Ipv4Header &header, Ptr<const Packet> packet)
+  {
+    FlowKey key;
+    if (!Key (header, packet, key))
+      {
+        return NOT_WATCHED;
+      }
+    if (int32_t *index = m_table.Find (key))
+      {
+        return *index;
+      }
+    int32_t index = NOT_WATCHED;
+    for (const Filter &filter : m_filters)
+      {
+        if (filter.destination == header.GetDestination ()
+            && (filter.destinationPort == 0 || filter.destinationPort == key.destinationPort)
+            && (filter.source == Ipv4Address::GetAny () || filter.source == header.GetSource ()))
+          {
+            index = m_flows.size ();
+            Flow flow;
+            flow.stats.txBytes = 0;
+            flow.stats.rxBytes = 0;
+            flow.stats.txPackets = 0;
+            flow.stats.rxPackets = 0;
+            flow.stats.lostPackets = 0;
+            flow.stats.timesForwarded = 0;
+            flow.tuple.sourceAddress = header.GetSource ();
+            flow.tuple.destinationAddress = header.GetDestination ();
+            flow.tuple.protocol = key.protocol;
+            flow.tuple.sourcePort = key.sourcePort;
+            flow.tuple.destinationPort = key.destinationPort;
+            m_flows.push_back (flow);
+            break;
+          }
+      }
+    return m_table.Insert (key, index);
+  }
+
+  void Sent (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface)
+  {
+    int32_t index = Classify (header, packet);
+    if (index == NOT_WATCHED)
+      {
+        return;
+      }
+    Time now = Simulator::Now ();
+    LatencyTag tag;
+    if (!packet->FindFirstMatchingByteTag (tag))
+      {
+        tag.m_sent = now.GetNanoSeconds ();
+        packet->AddByteTag (tag);
+      }
+    FlowMonitor::FlowStats &stats = m_flows[index].stats;
+    if (stats.txPackets == 0)
+      {
+        stats.timeFirstTxPacket = now;
+      }
+    stats.timeLastTxPacket = now;
+    ++stats.txPackets;
+    stats.txBytes += packet->GetSize () + header.GetSerializedSize ();
+  }
+
+  void Delivered (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface)
+  {
+    int32_t index = Classify (header, packet);
+    LatencyTag tag;
+    if (index == NOT_WATCHED || !packet->FindFirstMatchingByteTag (tag))
+      {
+        return;
+      }
+    Time now = Simulator::Now ();
+    Time delay = now - NanoSeconds (tag.m_sent);
+    FlowMonitor::FlowStats &stats = m_flows[index].stats;
+    if (stats.rxPackets == 0)
+      {
+        stats.timeFirstRxPacket = now;
+      }
+    else
+      {
+        stats.jitterSum += delay > stats.lastDelay ? delay - stats.lastDelay : stats.lastDelay - delay;
+      }
+    stats.timeLastRxPacket = now;
+    stats.lastDelay = delay;
+    stats.delaySum += delay;
+    ++stats.rxPackets;
+    stats.rxBytes += packet->GetSize () + header.GetSerializedSize ();
+  }
+
+  std::vector<Filter> m_filters;
+  std::vector<Flow> m_flows;
+  FlowHashTable<int32_t> m_table;
+};
+
+// WriteRunMetrics (common/run_metrics.h) from the watched flows.
+inline bool
+WriteRunMetrics (const std::string &path, Ptr<EndpointFlowMonitor> monitor, uint16_t sinkPort,
+                 const ReplicationOptions &replication, uint16_t nPorts = 1)
+{
+  return WriteRunMetrics (path, monitor->GetFlowStats (),
+                          [monitor] (FlowId id) { return monitor->FindFlow (id); },
+                          sinkPort, replication, nPorts);
+}
+
+} // namespace ns3
+
+#endif /* ENDPOINT_FLOW_MONITOR_H */
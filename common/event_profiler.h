@@ -0,0 +1,416 @@
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <cxxabi.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+// Where the wall clock time of a run goes, per kind of event.
+//
+// ProfilingScheduler wraps the real scheduler (MapScheduler by default) and
+// sees every event as the simulator takes it out to run it. The time from
+// one RemoveNext to the next is charged to the event taken out first:
+// its own execution plus the scheduling of whatever it scheduled. Events
+// are told apart by the callback they run (the EventImpl type, which names
+// the target class and member function signature, though not the member
+// function itself) and the node of their context, and put in one of these
+// categories by the target class:
+//
+//   tcp          TcpSocketBase and congestion control (RTO, delayed ACK,
+//                persist and pacing timers, segment processing)
+//   application  Application subclasses (OnOff, BulkSend, PacketSink, ...)
+//   channel      channels, net devices, queues and queue discs
+//   ip           the IPv4/ARP layer
+//   other        everything else (trace samplers, monitors, Stop, ...)
+//   cancelled    events cancelled before their time (not run)
+//
+// MakeEvent keeps the member function inside a type-erased closure, so
+// member functions of one class with the same signature share a type. The
+// TCP timers are told apart anyway: an event of a TcpSocketBase member is
+// matched against the EventIds the sockets of its node keep for their
+// timers (RTO, delayed ACK, persist, last ACK, TIME_WAIT, pending data),
+// which names the member it runs. Events carry their node but not the
+// device they concern, so there is no per-device breakdown.
+//
+// It also samples the scheduler queue depth every interval of simulated
+// time. One profile per process, as there is one simulator.
+//
+//   EventProfiler::Enable (Seconds (0.1));   // before Simulator::Run
+//   ...
+//   Simulator::Run ();
+//   EventProfiler::Write (prefix + "_profile.tsv", prefix + "_queue_depth.tsv");
+class EventProfiler
+{
+public:
+  struct Entry
+  {
+    Entry ()
+      : events (0),
+        wallNs (0)
+    {
+    }
+
+    uint64_t events;
+    uint64_t wallNs;
+  };
+
+  struct Key
+  {
+    std::type_index type;
+    const char *member;           // TCP timer member function, or 0
+    uint32_t context;
+    bool cancelled;
+
+    bool operator== (const Key &other) const
+    {
+      return type == other.type && member == other.member && context == other.context
+             && cancelled == other.cancelled;
+    }
+  };
+
+  struct KeyHash
+  {
+    size_t operator() (const Key &key) const
+    {
+      return key.type.hash_code () * 31 + std::hash<const char *> () (key.member) * 7 + key.context * 2
+             + key.cancelled;
+    }
+  };
+
+  struct Profile
+  {
+    Profile ()
+      : running (false),
+        current { std::type_index (typeid (void)), 0, 0, false },
+        depth (0),
+        nextSample (0),
+        sampleTs (0)
+    {
+    }
+
+    bool running;                 // an event taken out is being charged
+    Key current;
+    std::chrono::steady_clock::time_point start;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::unordered_map<std::type_index, bool> socketTypes;   // events of TcpSocketBase members
+    uint64_t depth;               // events in the scheduler
+    uint64_t nextSample;          // timestamp of the next depth sample
+    uint64_t sampleTs;            // sample interval in timestamp units
+    std::vector<std::pair<uint64_t, uint64_t> > samples;   // timestamp, depth
+  };
+
+  static Profile &Get ()
+  {
+    static Profile profile;
+    return profile;
+  }
+
+  // Installs the profiling scheduler around schedulerType; depth samples
+  // every sampleInterval of simulated time (zero: none).
+  static void Enable (Time sampleInterval, std::string schedulerType = "ns3::MapScheduler");
+
+  // Charges the event being run so far; called by Write.
+  static void Stop ()
+  {
+    Profile &profile = Get ();
+    if (profile.running)
+      {
+        Charge (profile, std::chrono::steady_clock::now ());
+        profile.running = false;
+      }
+  }
+
+  // The events and wall time of every (category, target, member, node),
+  // most expensive first:
+  //   category target member node events wall_ms share mean_us callback
+  // where target is the class of member function events, member the TCP
+  // timer ("-" for other events) and callback the full event type; and the
+  // queue depth samples as "time depth" lines.
+  static bool Write (const std::string &profilePath, const std::string &depthPath)
+  {
+    Stop ();
+    Profile &profile = Get ();
+    std::vector<std::pair<Key, Entry> > rows (profile.entries.begin (), profile.entries.end ());
+    std::sort (rows.begin (), rows.end (),
+               [] (const std::pair<Key, Entry> &a, const std::pair<Key, Entry> &b) {
+                 return a.second.wallNs > b.second.wallNs;
+               });
+    uint64_t totalNs = 0;
+    uint64_t totalEvents = 0;
+    for (const std::pair<Key, Entry> &row : rows)
+      {
+        totalNs += row.second.wallNs;
+        totalEvents += row.second.events;
+      }
+
+    std::ofstream out (profilePath.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    out << "# events=" << totalEvents << "\n";
+    out << "# wall_s=" << totalNs / 1e9 << "\n";
+    out << "category\ttarget\tmember\tnode\tevents\twall_ms\tshare\tmean_us\tcallback\n";
+    for (const std::pair<Key, Entry> &row : rows)
+      {
+        std::string callback = Demangle (row.first.type);
+        std::string target = TargetClass (callback);
+        out << (row.first.cancelled ? "cancelled" : Category (target)) << "\t" << (target.empty () ? "-" : target)
+            << "\t" << (row.first.member ? row.first.member : "-") << "\t";
+        if (row.first.context == Simulator::NO_CONTEXT)
+          {
+            out << "-";
+          }
+        else
+          {
+            out << row.first.context;
+          }
+        out << "\t" << row.second.events << "\t" << row.second.wallNs / 1e6 << "\t"
+            << (totalNs ? double (row.second.wallNs) / totalNs : 0) << "\t"
+            << row.second.wallNs / 1e3 / row.second.events << "\t" << callback << "\n";
+      }
+
+    if (profile.sampleTs == 0)
+      {
+        return true;
+      }
+    std::ofstream depth (depthPath.c_str ());
+    if (!depth)
+      {
+        return false;
+      }
+    depth << "time\tdepth\n";
+    for (const std::pair<uint64_t, uint64_t> &sample : profile.samples)
+      {
+        depth << TimeStep (sample.first).GetSeconds () << "\t" << sample.second << "\n";
+      }
+    return true;
+  }
+
+  static void Charge (Profile &profile, std::chrono::steady_clock::time_point now)
+  {
+    Entry &entry = profile.entries[profile.current];
+    ++entry.events;
+    entry.wallNs += std::chrono::duration_cast<std::chrono::nanoseconds> (now - profile.start).count ();
+  }
+
+  // The TCP timer whose EventId holds impl, among the sockets of the node
+  // with id context, or 0. Only for events of TcpSocketBase members.
+  static const char *TcpTimer (Profile &profile, const EventImpl *impl, uint32_t context)
+  {
+    std::type_index type (typeid (*impl));
+    std::unordered_map<std::type_index, bool>::iterator known = profile.socketTypes.find (type);
+    if (known == profile.socketTypes.end ())
+      {
+        known = profile.socketTypes.insert (std::make_pair (type, TargetClass (Demangle (type)) == "ns3::TcpSocketBase"))
+                  .first;
+      }
+    if (!known->second || context >= NodeList::GetNNodes ())
+      {
+        return 0;
+      }
+    Ptr<TcpL4Protocol> tcp = NodeList::GetNode (context)->GetObject<TcpL4Protocol> ();
+    if (!tcp)
+      {
+        return 0;
+      }
+    ObjectVectorValue sockets;
+    tcp->GetAttribute ("SocketList", sockets);
+    for (ObjectVectorValue::Iterator it = sockets.Begin (); it != sockets.End (); ++it)
+      {
+        Ptr<TcpSocketBase> socket = DynamicCast<TcpSocketBase> (it->second);
+        if (const char *name = socket ? TcpTimers::Find (*socket, impl) : 0)
+          {
+            return name;
+          }
+      }
+    return 0;
+  }
+
+private:
+  // The timer EventIds are protected members of TcpSocketBase; a derived
+  // class may name them, and the member pointers work on any socket.
+  class TcpTimers : public TcpSocketBase
+  {
+  public:
+    static const char *Find (const TcpSocketBase &socket, const EventImpl *impl)
+    {
+      static const std::pair<EventId TcpSocketBase::*, const char *> timers[] = {
+        { &TcpTimers::m_retxEvent, "ReTxTimeout" },
+        { &TcpTimers::m_delAckEvent, "DelAckTimeout" },
+        { &TcpTimers::m_persistEvent, "PersistTimeout" },
+        { &TcpTimers::m_lastAckEvent, "LastAckTimeout" },
+        { &TcpTimers::m_timewaitEvent, "TimeWait" },
+        { &TcpTimers::m_sendPendingDataEvent, "SendPendingData" },
+      };
+      for (const std::pair<EventId TcpSocketBase::*, const char *> &timer : timers)
+        {
+          if ((socket.*timer.first).PeekEventImpl () == impl)
+            {
+              return timer.second;
+            }
+        }
+      return 0;
+    }
+  };
+
+  static std::string Demangle (const std::type_index &type)
+  {
+    int status = 0;
+    char *name = abi::__cxa_demangle (type.name (), 0, 0, &status);
+    std::string result = status == 0 && name ? name : type.name ();
+    std::free (name);
+    return result;
+  }
+
+  // The class of a member function event: MakeEvent names the member
+  // function pointer type, "... (ns3::TcpSocketBase::*)(...) ...".
+  static std::string TargetClass (const std::string &target)
+  {
+    std::string::size_type member = target.find ("::*)");
+    if (member == std::string::npos)
+      {
+        return "";
+      }
+    std::string::size_type open = target.rfind ('(', member);
+    return open == std::string::npos ? "" : target.substr (open + 1, member - open - 1);
+  }
+
+  static std::string Category (const std::string &cls)
+  {
+    static const std::pair<const char *, const char *> categories[] = {
+      { "Tcp", "tcp" },
+      { "Application", "application" },
+      { "OnOff", "application" },
+      { "BulkSend", "application" },
+      { "PacketSink", "application" },
+      { "UdpClient", "application" },
+      { "UdpServer", "application" },
+      { "UdpEcho", "application" },
+      { "MyApp", "application" },
+      { "Channel", "channel" },
+      { "NetDevice", "channel" },
+      { "Queue", "channel" },
+      { "Backoff", "channel" },
+      { "Ipv4", "ip" },
+      { "Arp", "ip" },
+    };
+    for (const std::pair<const char *, const char *> &category : categories)
+      {
+        if (!cls.empty () && cls.find (category.first) != std::string::npos)
+          {
+            return category.second;
+          }
+      }
+    return "other";
+  }
+};
+
+// Scheduler decorator feeding EventProfiler; see there.
+class ProfilingScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::ProfilingScheduler")
+      .SetParent<Scheduler> ()
+      .SetGroupName ("Core")
+      .AddConstructor<ProfilingScheduler> ()
+      .AddAttribute ("Inner", "Scheduler doing the actual work",
+                     TypeIdValue (MapScheduler::GetTypeId ()),
+                     MakeTypeIdAccessor (&ProfilingScheduler::SetInner),
+                     MakeTypeIdChecker ())
+      ;
+    return tid;
+  }
+
+  ProfilingScheduler ()
+  {
+    m_inner = CreateObject<MapScheduler> ();
+  }
+
+  void SetInner (TypeId type)
+  {
+    ObjectFactory factory;
+    factory.SetTypeId (type);
+    m_inner = factory.Create<Scheduler> ();
+  }
+
+  virtual void Insert (const Event &ev)
+  {
+    ++EventProfiler::Get ().depth;
+    m_inner->Insert (ev);
+  }
+
+  virtual bool IsEmpty (void) const
+  {
+    return m_inner->IsEmpty ();
+  }
+
+  virtual Event PeekNext (void) const
+  {
+    return m_inner->PeekNext ();
+  }
+
+  virtual Event RemoveNext (void)
+  {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now ();
+    EventProfiler::Profile &profile = EventProfiler::Get ();
+    if (profile.running)
+      {
+        EventProfiler::Charge (profile, now);
+      }
+    Event ev = m_inner->RemoveNext ();
+    if (profile.sampleTs)
+      {
+        while (ev.key.m_ts >= profile.nextSample)
+          {
+            profile.samples.push_back (std::make_pair (profile.nextSample, profile.depth));
+            profile.nextSample += profile.sampleTs;
+          }
+      }
+    --profile.depth;
+    const char *timer = ev.impl->IsCancelled () ? 0 : EventProfiler::TcpTimer (profile, ev.impl, ev.key.m_context);
+    profile.current = EventProfiler::Key { std::type_index (typeid (*ev.impl)), timer, ev.key.m_context,
+                                           ev.impl->IsCancelled () };
+    // Looking the timer up is the profiler's cost, not the event's.
+    profile.start = timer ? std::chrono::steady_clock::now () : now;
+    profile.running = true;
+    return ev;
+  }
+
+  virtual void Remove (const Event &ev)
+  {
+    --EventProfiler::Get ().depth;
+    m_inner->Remove (ev);
+  }
+
+private:
+  Ptr<Scheduler> m_inner;
+};
+
+inline void
+EventProfiler::Enable (Time sampleInterval, std::string schedulerType)
+{
+  Profile &profile = Get ();
+  profile.sampleTs = sampleInterval.IsStrictlyPositive () ? sampleInterval.GetTimeStep () : 0;
+  ObjectFactory factory;
+  factory.SetTypeId (ProfilingScheduler::GetTypeId ());
+  factory.Set ("Inner", TypeIdValue (TypeId::LookupByName (schedulerType)));
+  Simulator::SetScheduler (factory);
+}
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -0,0 +1,483 @@
+#ifndef FAILURE_INJECTOR_H
+#define FAILURE_INJECTOR_H
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "replication.h"
+
+namespace ns3 {
+
+// Drops every received packet while its device or channel is out, and
+// otherwise defers to the error model the device had before.
+class OutageErrorModel : public ErrorModel
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::OutageErrorModel")
+      .SetParent<ErrorModel> ()
+      .AddConstructor<OutageErrorModel> ();
+    return tid;
+  }
+
+  OutageErrorModel ()
+    : m_outages (0)
+  {
+  }
+
+  void SetInner (Ptr<ErrorModel> inner)
+  {
+    m_inner = inner;
+  }
+
+  void Down ()
+  {
+    ++m_outages;
+  }
+
+  void Up ()
+  {
+    --m_outages;
+  }
+
+private:
+  virtual bool DoCorrupt (Ptr<Packet> p)
+  {
+    return m_outages > 0 || (m_inner && m_inner->IsCorrupt (p));
+  }
+
+  virtual void DoReset (void)
+  {
+    if (m_inner)
+      {
+        m_inner->Reset ();
+      }
+  }
+
+  Ptr<ErrorModel> m_inner;
+  uint32_t m_outages;
+};
+
+// Outage schedules for the failure scenarios.
+//
+// Targets are named interfaces (Ipv4 SetDown/SetUp, which also takes the
+// routes through them away), devices or channels (every packet received
+// on them is dropped; routing is left alone). Outages come from
+// AddOutage, a script (--failures) with one "<start s> <duration s>
+// <target>" line per outage, random picks of distinct targets, or
+// exponential up/repair times (--mtbf/--mttr), all drawn from the
+// STREAM_FAILURES block so a (--seed, --run) pair always fails the same
+// elements at the same times.
+//
+// Overlapping outages of one target keep it out until the last one ends.
+// All changes due at the same time are applied by one simulator event,
+// outages before repairs.
+//
+// With MonitorSinks, WriteReport gives the received throughput before,
+// during and after each outage window (each as long as the window).
+class FailureInjector : public SimpleRefCount<FailureInjector>
+{
+public:
+  FailureInjector ()
+    : m_mtbf (0),
+      m_mttr (1),
+      m_rxBytes (0),
+      m_scheduled (false)
+  {
+    m_pick = CreateObject<UniformRandomVariable> ();
+    m_pick->SetStream (STREAM_FAILURES);
+    m_upTime = CreateObject<ExponentialRandomVariable> ();
+    m_upTime->SetStream (STREAM_FAILURES + 1);
+    m_repairTime = CreateObject<ExponentialRandomVariable> ();
+    m_repairTime->SetStream (STREAM_FAILURES + 2);
+  }
+
+  void AddCommandLineOptions (CommandLine &cmd)
+  {
+    cmd.AddValue ("failures", "Outage script: \"<start s> <duration s> <target>\" per line", m_script);
+    cmd.AddValue ("mtbf", "Mean time between failures of every target in seconds (0: no random failures)", m_mtbf);
+    cmd.AddValue ("mttr", "Mean time to repair in seconds", m_mttr);
+  }
+
+  // Loads --failures and draws the --mtbf/--mttr outages of every target
+  // between start and stop. Call after the targets are added.
+  void ApplyOptions (Time start, Time stop)
+  {
+    if (!m_script.empty ())
+      {
+        LoadScript (m_script);
+      }
+    if (m_mtbf > 0)
+      {
+        AddMtbf (0, m_targets.size (), Seconds (m_mtbf), Seconds (m_mttr), start, stop);
+      }
+  }
+
+  uint32_t AddInterface (const std::string &name, Ptr<Node> node, uint32_t ifIndex)
+  {
+    Target target (name, INTERFACE);
+    target.node = node;
+    target.ifIndex = ifIndex;
+    return AddTarget (target);
+  }
+
+  uint32_t AddDevice (const std::string &name, Ptr<NetDevice> device)
+  {
+    Target target (name, DEVICE);
+    target.devices.push_back (device);
+    return AddTarget (target);
+  }
+
+  uint32_t AddChannel (const std::string &name, Ptr<Channel> channel)
+  {
+    Target target (name, CHANNEL);
+    for (uint32_t i = 0; i < channel->GetNDevices (); ++i)
+      {
+        target.devices.push_back (channel->GetDevice (i));
+      }
+    return AddTarget (target);
+  }
+
+  // The spoke interfaces of a star as "spoke0", "spoke1", ...; returns the
+  // id of spoke0, the others follow.
+  uint32_t AddStarSpokes (PointToPointStarHelper &star)
+  {
+    uint32_t first = m_targets.size ();
+    for (uint32_t i = 0; i < star.SpokeCount (); ++i)
+      {
+        Ptr<Node> spoke = star.GetSpokeNode (i);
+        int32_t ifIndex = spoke->GetObject<Ipv4> ()->GetInterfaceForAddress (star.GetSpokeIpv4Address (i));
+        NS_ABORT_MSG_IF (ifIndex < 0, "Spoke " << i << " has no address assigned");
+        std::ostringstream oss;
+        oss << "spoke" << i;
+        AddInterface (oss.str (), spoke, ifIndex);
+      }
+    return first;
+  }
+
+  // The links of a chain (devices 2i and 2i+1 are the ends of link i) as
+  // channel targets "link0", "link1", ...; returns the id of link0.
+  uint32_t AddChainLinks (NetDeviceContainer devices)
+  {
+    uint32_t first = m_targets.size ();
+    for (uint32_t i = 0; 2 * i < devices.GetN (); ++i)
+      {
+        std::ostringstream oss;
+        oss << "link" << i;
+        AddChannel (oss.str (), devices.Get (2 * i)->GetChannel ());
+      }
+    return first;
+  }
+
+  uint32_t GetNTargets () const
+  {
+    return m_targets.size ();
+  }
+
+  // Called after an interface target is set up again, e.g. with
+  // FastRouting::RestoreDefaultRoute.
+  void SetInterfaceUpCallback (Callback<void, Ptr<Node>, uint32_t> callback)
+  {
+    m_interfaceUp = callback;
+  }
+
+  void AddOutage (uint32_t target, Time start, Time duration)
+  {
+    NS_ABORT_MSG_IF (m_scheduled, "Outages have to be added before Schedule");
+    NS_ABORT_MSG_IF (target >= m_targets.size (), "Unknown failure target " << target);
+    NS_ABORT_MSG_IF (duration.IsNegative () || start.IsNegative (), "Outage with negative start or duration");
+    Window window;
+    window.target = target;
+    window.start = start;
+    window.end = start + duration;
+    m_windows.push_back (window);
+  }
+
+  void LoadScript (const std::string &path)
+  {
+    std::ifstream in (path.c_str ());
+    NS_ABORT_MSG_IF (!in, "Cannot read failure script " << path);
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline (in, line))
+      {
+        ++lineNumber;
+        line = line.substr (0, line.find ('#'));
+        std::istringstream iss (line);
+        double start;
+        double duration;
+        std::string name;
+        if (!(iss >> start))
+          {
+            continue; // blank or comment
+          }
+        NS_ABORT_MSG_IF (!(iss >> duration >> name),
+                         path << ":" << lineNumber << ": expected <start s> <duration s> <target>");
+        std::map<std::string, uint32_t>::const_iterator it = m_names.find (name);
+        NS_ABORT_MSG_IF (it == m_names.end (), path << ":" << lineNumber << ": unknown target " << name);
+        AddOutage (it->second, Seconds (start), Seconds (duration));
+      }
+  }
+
+  // Takes k distinct targets of [first, first + count) out for duration.
+  void AddRandomOutages (uint32_t first, uint32_t count, uint32_t k, Time start, Time duration)
+  {
+    std::vector<uint32_t> ids (count);
+    for (uint32_t i = 0; i < count; ++i)
+      {
+        ids[i] = first + i;
+      }
+    for (uint32_t i = 0; i < std::min (k, count); ++i)
+      {
+        std::swap (ids[i], ids[m_pick->GetInteger (i, count - 1)]);
+        AddOutage (ids[i], start, duration);
+      }
+  }
+
+  // Alternating exponential up and repair times for each target of
+  // [first, first + count), for outages starting in [start, stop).
+  void AddMtbf (uint32_t first, uint32_t count, Time mtbf, Time mttr, Time start, Time stop)
+  {
+    for (uint32_t target = first; target < first + count; ++target)
+      {
+        Time t = start + Seconds (m_upTime->GetValue (mtbf.GetSeconds (), 0));
+        while (t < stop)
+          {
+            Time repair = Seconds (m_repairTime->GetValue (mttr.GetSeconds (), 0));
+            AddOutage (target, t, repair);
+            t += repair + Seconds (m_upTime->GetValue (mtbf.GetSeconds (), 0));
+          }
+      }
+  }
+
+  uint32_t GetNOutages () const
+  {
+    return m_windows.size ();
+  }
+
+  // Counts the bytes received by the PacketSink applications in sinks.
+  void MonitorSinks (ApplicationContainer sinks)
+  {
+    for (uint32_t i = 0; i < sinks.GetN (); ++i)
+      {
+        sinks.Get (i)->TraceConnectWithoutContext ("Rx", MakeCallback (&FailureInjector::SinkRx, this));
+      }
+  }
+
+  // Turns the outages into simulator events; call once, before the
+  // simulation starts and after every outage is added.
+  void Schedule ()
+  {
+    NS_ABORT_MSG_IF (m_scheduled, "FailureInjector::Schedule called twice");
+    m_scheduled = true;
+    for (uint32_t w = 0; w < m_windows.size (); ++w)
+      {
+        const Window &window = m_windows[w];
+        m_batches[window.start].down.push_back (window.target);
+        m_batches[window.end].up.push_back (window.target);
+        Time length = window.end - window.start;
+        Time before = std::max (window.start - length, Seconds (0));
+        m_windows[w].bytes[0] = m_windows[w].bytes[1] = m_windows[w].bytes[2] = m_windows[w].bytes[3] = UINT64_MAX;
+        m_batches[before].samples.push_back (4 * w);
+        m_batches[window.start].samples.push_back (4 * w + 1);
+        m_batches[window.end].samples.push_back (4 * w + 2);
+        m_batches[window.end + length].samples.push_back (4 * w + 3);
+        if (m_targets[window.target].kind != INTERFACE)
+          {
+            InstallErrorModels (m_targets[window.target]);
+          }
+      }
+    for (std::map<Time, Batch>::const_iterator it = m_batches.begin (); it != m_batches.end (); ++it)
+      {
+        Simulator::Schedule (it->first - Simulator::Now (), &FailureInjector::Apply, this, it->first);
+      }
+  }
+
+  // One line per outage window:
+  //   window target start end before_mbps during_mbps after_mbps
+  // A throughput is "-" when its interval was not simulated completely.
+  bool WriteReport (const std::string &path) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    out << "window\ttarget\tstart\tend\tbefore_mbps\tduring_mbps\tafter_mbps\n";
+    for (uint32_t w = 0; w < m_windows.size (); ++w)
+      {
+        const Window &window = m_windows[w];
+        Time length = window.end - window.start;
+        Time before = std::max (window.start - length, Seconds (0));
+        out << w << "\t" << m_targets[window.target].name << "\t" << window.start.GetSeconds () << "\t"
+            << window.end.GetSeconds ();
+        WriteMbps (out, window.bytes[0], window.bytes[1], window.start - before);
+        WriteMbps (out, window.bytes[1], window.bytes[2], length);
+        WriteMbps (out, window.bytes[2], window.bytes[3], length);
+        out << "\n";
+      }
+    return true;
+  }
+
+private:
+  enum Kind
+  {
+    INTERFACE,
+    DEVICE,
+    CHANNEL
+  };
+
+  struct Target
+  {
+    Target (const std::string &n, Kind k)
+      : name (n),
+        kind (k),
+        ifIndex (0),
+        outages (0)
+    {
+    }
+
+    std::string name;
+    Kind kind;
+    Ptr<Node> node;                        // INTERFACE
+    uint32_t ifIndex;
+    std::vector<Ptr<NetDevice> > devices;  // DEVICE, CHANNEL
+    std::vector<Ptr<OutageErrorModel> > models;
+    uint32_t outages;
+  };
+
+  struct Window
+  {
+    uint32_t target;
+    Time start;
+    Time end;
+    uint64_t bytes[4];   // received at start - length, start, end, end + length
+  };
+
+  struct Batch
+  {
+    std::vector<uint32_t> down;
+    std::vector<uint32_t> up;
+    std::vector<uint32_t> samples;   // 4 * window + slot
+  };
+
+  uint32_t AddTarget (const Target &target)
+  {
+    NS_ABORT_MSG_IF (!m_names.insert (std::make_pair (target.name, m_targets.size ())).second,
+                     "Duplicate failure target " << target.name);
+    m_targets.push_back (target);
+    return m_targets.size () - 1;
+  }
+
+  // Wraps the receive error model of each device of target, sharing one
+  // wrapper per device between targets.
+  void InstallErrorModels (Target &target)
+  {
+    if (!target.models.empty ())
+      {
+        return;
+      }
+    for (Ptr<NetDevice> device : target.devices)
+      {
+        Ptr<OutageErrorModel> &model = m_models[device];
+        if (!model)
+          {
+            PointerValue inner;
+            NS_ABORT_MSG_IF (!device->GetAttributeFailSafe ("ReceiveErrorModel", inner),
+                             "Device of failure target " << target.name << " has no ReceiveErrorModel");
+            model = CreateObject<OutageErrorModel> ();
+            model->SetInner (inner.Get<ErrorModel> ());
+            device->SetAttribute ("ReceiveErrorModel", PointerValue (model));
+          }
+        target.models.push_back (model);
+      }
+  }
+
+  void Apply (Time when)
+  {
+    Batch &batch = m_batches[when];
+    for (uint32_t id : batch.samples)
+      {
+        m_windows[id / 4].bytes[id % 4] = m_rxBytes;
+      }
+    for (uint32_t id : batch.down)
+      {
+        Target &target = m_targets[id];
+        if (target.outages++ > 0)
+          {
+            continue;
+          }
+        if (target.kind == INTERFACE)
+          {
+            target.node->GetObject<Ipv4> ()->SetDown (target.ifIndex);
+          }
+        for (Ptr<OutageErrorModel> model : target.models)
+          {
+            model->Down ();
+          }
+      }
+    for (uint32_t id : batch.up)
+      {
+        Target &target = m_targets[id];
+        if (--target.outages > 0)
+          {
+            continue;
+          }
+        if (target.kind == INTERFACE)
+          {
+            target.node->GetObject<Ipv4> ()->SetUp (target.ifIndex);
+            if (!m_interfaceUp.IsNull ())
+              {
+                m_interfaceUp (target.node, target.ifIndex);
+              }
+          }
+        for (Ptr<OutageErrorModel> model : target.models)
+          {
+            model->Up ();
+          }
+      }
+    m_batches.erase (when);
+  }
+
+  void SinkRx (Ptr<const Packet> packet, const Address &from)
+  {
+    m_rxBytes += packet->GetSize ();
+  }
+
+  static void WriteMbps (std::ostream &out, uint64_t from, uint64_t to, Time length)
+  {
+    if (from == UINT64_MAX || to == UINT64_MAX || !length.IsStrictlyPositive ())
+      {
+        out << "\t-";
+        return;
+      }
+    out << "\t" << (to - from) * 8.0 / length.GetSeconds () / 1e6;
+  }
+
+  std::string m_script;
+  double m_mtbf;
+  double m_mttr;
+  Ptr<UniformRandomVariable> m_pick;
+  Ptr<ExponentialRandomVariable> m_upTime;
+  Ptr<ExponentialRandomVariable> m_repairTime;
+  std::vector<Target> m_targets;
+  std::map<std::string, uint32_t> m_names;
+  std::map<Ptr<NetDevice>, Ptr<OutageErrorModel> > m_models;
+  std::vector<Window> m_windows;
+  std::map<Time, Batch> m_batches;
+  Callback<void, Ptr<Node>, uint32_t> m_interfaceUp;
+  uint64_t m_rxBytes;
+  bool m_scheduled;
+};
+
+} // namespace ns3
+
+#endif /* FAILURE_INJECTOR_H */
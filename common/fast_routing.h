@@ -0,0 +1,174 @@
+#ifndef FAST_ROUTING_H
+#define FAST_ROUTING_H
+
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-layout-module.h"
+
+namespace ns3 {
+
+// Writes static routes for the two topology shapes the scenarios build,
+// instead of Ipv4GlobalRoutingHelper::PopulateRoutingTables, which runs
+// an SPF from every node and gets quadratic in the node count.
+//
+// Star (PointToPointStarHelper): the hub is directly connected to every
+// spoke subnet, and each spoke gets one default route through its hub
+// link. Linear in the number of spokes.
+//
+// Chain (node i linked to node i+1, one subnet per link): every node gets a
+// default route towards the last node and routes for the links behind it
+// through the previous node. When the link subnets are equally sized and
+// numbered in chain order (what Ipv4AddressHelper::NewNetwork produces)
+// those are the few CIDR blocks covering the range, O(n log n) routes in
+// total; otherwise one route per link. Anything that is not a chain of
+// addressed devices falls back to global routing.
+//
+// The routes go into Ipv4StaticRouting, which the default
+// InternetStackHelper routing list consults before global routing.
+// Ipv4StaticRouting drops the routes of an interface that goes down and
+// only restores the subnet route when it comes back up, so scenarios that
+// take spokes down call RestoreDefaultRoute after Ipv4::SetUp.
+class FastRouting
+{
+public:
+  static void PopulateStar (PointToPointStarHelper &star)
+  {
+    Ipv4StaticRoutingHelper staticHelper;
+    for (uint32_t i = 0; i < star.SpokeCount (); ++i)
+      {
+        Ptr<Ipv4> ipv4 = star.GetSpokeNode (i)->GetObject<Ipv4> ();
+        Ptr<Ipv4StaticRouting> routing = staticHelper.GetStaticRouting (ipv4);
+        int32_t ifIndex = ipv4->GetInterfaceForAddress (star.GetSpokeIpv4Address (i));
+        NS_ABORT_MSG_IF (ifIndex < 0, "Spoke " << i << " has no address assigned");
+        routing->SetDefaultRoute (star.GetHubIpv4Address (i), ifIndex);
+      }
+  }
+
+  // Puts back the default route of a point-to-point interface through the
+  // other end of its link, unless the node already has a default route.
+  static void RestoreDefaultRoute (Ptr<Node> node, uint32_t ifIndex)
+  {
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+    Ptr<NetDevice> device = ipv4->GetNetDevice (ifIndex);
+    Ptr<Channel> channel = device->GetChannel ();
+    NS_ABORT_MSG_IF (!channel || channel->GetNDevices () != 2,
+                     "Node " << node->GetId () << " interface " << ifIndex << " is not point-to-point");
+    Ipv4StaticRoutingHelper staticHelper;
+    Ptr<Ipv4StaticRouting> routing = staticHelper.GetStaticRouting (ipv4);
+    for (uint32_t j = 0; j < routing->GetNRoutes (); ++j)
+      {
+        if (routing->GetRoute (j).IsDefault ())
+          {
+            return;
+          }
+      }
+    Ptr<NetDevice> peer = channel->GetDevice (channel->GetDevice (0) == device ? 1 : 0);
+    Ipv4Address gateway;
+    int32_t peerIf;
+    Ipv4Mask mask;
+    NS_ABORT_MSG_IF (!LinkEnd (peer, gateway, peerIf, mask),
+                     "Peer of node " << node->GetId () << " interface " << ifIndex << " has no address");
+    routing->SetDefaultRoute (gateway, ifIndex);
+  }
+
+  // devices as built by Install (nodes.Get (i), nodes.Get (i + 1)) for
+  // i = 0..n-2: devices 2i and 2i+1 are the two ends of link i. Returns
+  // false when it had to fall back to global routing.
+  static bool PopulateChain (NodeContainer nodes, NetDeviceContainer devices)
+  {
+    uint32_t nLinks = devices.GetN () / 2;
+    if (nodes.GetN () < 2 || nLinks != nodes.GetN () - 1)
+      {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+        return false;
+      }
+
+    // Address of each end of every link, and the link subnet layout.
+    std::vector<Ipv4Address> left (nLinks);    // on node i
+    std::vector<Ipv4Address> right (nLinks);   // on node i+1
+    std::vector<int32_t> leftIf (nLinks);
+    std::vector<int32_t> rightIf (nLinks);
+    std::vector<Ipv4Mask> masks (nLinks);
+    bool contiguous = true;
+    uint64_t base = 0;
+    uint64_t size = 0;
+    for (uint32_t i = 0; i < nLinks; ++i)
+      {
+        Ipv4Mask rightMask;
+        if (!LinkEnd (devices.Get (2 * i), left[i], leftIf[i], masks[i])
+            || !LinkEnd (devices.Get (2 * i + 1), right[i], rightIf[i], rightMask)
+            || rightMask != masks[i] || !masks[i].IsMatch (left[i], right[i]))
+          {
+            Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+            return false;
+          }
+        uint64_t network = left[i].CombineMask (masks[i]).Get ();
+        if (i == 0)
+          {
+            base = network;
+            size = uint64_t (~masks[i].Get ()) + 1;
+          }
+        contiguous = contiguous && masks[i] == masks[0] && network == base + i * size;
+      }
+
+    Ipv4StaticRoutingHelper staticHelper;
+    for (uint32_t k = 0; k < nodes.GetN (); ++k)
+      {
+        Ptr<Ipv4StaticRouting> routing = staticHelper.GetStaticRouting (nodes.Get (k)->GetObject<Ipv4> ());
+        if (k + 1 < nodes.GetN ())
+          {
+            // Everything not behind this node is further down the chain.
+            routing->SetDefaultRoute (right[k], leftIf[k]);
+          }
+        if (k >= 2 && !contiguous)
+          {
+            for (uint32_t i = 0; i + 1 < k; ++i)
+              {
+                routing->AddNetworkRouteTo (left[i].CombineMask (masks[i]), masks[i],
+                                            left[k - 1], rightIf[k - 1]);
+              }
+          }
+        else if (k >= 2)
+          {
+            // Links 0..k-2 are reached through node k-1; link k-1 is
+            // directly connected.
+            uint64_t lo = base;
+            uint64_t hi = base + uint64_t (k - 1) * size - 1;
+            while (lo <= hi)
+              {
+                uint64_t block = lo ? (lo & (~lo + 1)) : (uint64_t (1) << 32);
+                while (lo + block - 1 > hi)
+                  {
+                    block >>= 1;
+                  }
+                routing->AddNetworkRouteTo (Ipv4Address (uint32_t (lo)),
+                                            Ipv4Mask (uint32_t (~(block - 1))),
+                                            left[k - 1], rightIf[k - 1]);
+                lo += block;
+              }
+          }
+      }
+    return true;
+  }
+
+private:
+  static bool LinkEnd (Ptr<NetDevice> device, Ipv4Address &address, int32_t &ifIndex, Ipv4Mask &mask)
+  {
+    Ptr<Ipv4> ipv4 = device->GetNode ()->GetObject<Ipv4> ();
+    ifIndex = ipv4 ? ipv4->GetInterfaceForDevice (device) : -1;
+    if (ifIndex < 0 || ipv4->GetNAddresses (ifIndex) == 0)
+      {
+        return false;
+      }
+    Ipv4InterfaceAddress ifAddress = ipv4->GetAddress (ifIndex, 0);
+    address = ifAddress.GetLocal ();
+    mask = ifAddress.GetMask ();
+    return true;
+  }
+};
+
+} // namespace ns3
+
+#endif /* FAST_ROUTING_H */
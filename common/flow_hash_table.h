@@ -0,0 +1,142 @@
+#ifndef FLOW_HASH_TABLE_H
+#define FLOW_HASH_TABLE_H
+
+// Open addressing hash table from IPv4 five tuples to small integer
+// values, for classifying packets on the per-packet path: one hash and
+// usually one probe of a flat array, against a std::map walk with four
+// compares per level in Ipv4FlowClassifier.
+//
+// Linear probing over a power of two number of slots, grown to keep the
+// load at most one half. Entries are never removed. No ns-3 dependency.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FlowKey
+{
+  uint32_t source;
+  uint32_t destination;
+  uint16_t sourcePort;
+  uint16_t destinationPort;
+  uint8_t protocol;
+
+  bool operator== (const FlowKey &other) const
+  {
+    return source == other.source && destination == other.destination && sourcePort == other.sourcePort
+           && destinationPort == other.destinationPort && protocol == other.protocol;
+  }
+};
+
+template <typename Value>
+class FlowHashTable
+{
+public:
+  explicit FlowHashTable (uint32_t initialSlots = 64)
+    : m_size (0)
+  {
+    uint32_t slots = 8;
+    while (slots < initialSlots)
+      {
+        slots <<= 1;
+      }
+    m_slots.assign (slots, Slot ());
+  }
+
+  // Value stored for key, or 0.
+  Value *Find (const FlowKey &key)
+  {
+    size_t mask = m_slots.size () - 1;
+    for (size_t i = Hash (key) & mask;; i = (i + 1) & mask)
+      {
+        Slot &slot = m_slots[i];
+        if (!slot.used)
+          {
+            return 0;
+          }
+        if (slot.key == key)
+          {
+            return &slot.value;
+          }
+      }
+  }
+
+  // Stores value for key (replacing the one there) and returns it.
+  Value &Insert (const FlowKey &key, const Value &value)
+  {
+    if (Value *existing = Find (key))
+      {
+        *existing = value;
+        return *existing;
+      }
+    if (2 * (m_size + 1) > m_slots.size ())
+      {
+        Grow ();
+      }
+    ++m_size;
+    return Place (key, value);
+  }
+
+  size_t GetSize () const
+  {
+    return m_size;
+  }
+
+private:
+  struct Slot
+  {
+    Slot ()
+      : used (false)
+    {
+    }
+
+    FlowKey key;
+    Value value;
+    bool used;
+  };
+
+  // 64 bit multiply-xorshift mix of the tuple.
+  static size_t Hash (const FlowKey &key)
+  {
+    uint64_t h = (uint64_t (key.source) << 32) | key.destination;
+    h ^= (uint64_t (key.sourcePort) << 24) ^ (uint64_t (key.destinationPort) << 8) ^ key.protocol;
+    h *= 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return static_cast<size_t> (h);
+  }
+
+  Value &Place (const FlowKey &key, const Value &value)
+  {
+    size_t mask = m_slots.size () - 1;
+    size_t i = Hash (key) & mask;
+    while (m_slots[i].used)
+      {
+        i = (i + 1) & mask;
+      }
+    m_slots[i].key = key;
+    m_slots[i].value = value;
+    m_slots[i].used = true;
+    return m_slots[i].value;
+  }
+
+  void Grow ()
+  {
+    std::vector<Slot> old;
+    old.swap (m_slots);
+    m_slots.assign (old.size () * 2, Slot ());
+    for (const Slot &slot : old)
+      {
+        if (slot.used)
+          {
+            Place (slot.key, slot.value);
+          }
+      }
+  }
+
+  std::vector<Slot> m_slots;
+  size_t m_size;
+};
+
+#endif /* FLOW_HASH_TABLE_H */
@@ -0,0 +1,158 @@
+#ifndef FLOW_SNAPSHOT_H
+#define FLOW_SNAPSHOT_H
+
+#include <cstring>
+#include <map>
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ring_file_writer.h"
+#include "flow_snapshot_record.h"
+
+namespace ns3 {
+
+// Streams FlowMonitor's per-flow counters as a time series: every interval
+// the flows' statistics are read and what each flow gained since the last
+// snapshot (tx/rx bytes and packets, lost packets, delay sum) is appended
+// as one binary record (common/flow_snapshot_record.h). Only the previous
+// counters of each flow are kept, so memory stays bounded however long the
+// run, unlike collecting everything for SerializeToXmlFile at the end.
+//
+// tools/snapshot_to_tsv.cc turns a stream into per-interval throughput,
+// loss and mean delay per flow.
+class FlowSnapshotWriter : public SimpleRefCount<FlowSnapshotWriter>
+{
+public:
+  FlowSnapshotWriter (Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier, Time interval)
+    : m_monitor (monitor),
+      m_classifier (classifier),
+      m_interval (interval),
+      m_stop (Time::Max ()),
+      m_lastNs (-1)
+  {
+  }
+
+  ~FlowSnapshotWriter ()
+  {
+    Close ();
+  }
+
+  bool Open (const std::string &path)
+  {
+    FlowSnapshotFileHeader header = MakeFlowSnapshotFileHeader (m_interval.GetNanoSeconds ());
+    return m_writer.Open (path, &header, sizeof (header));
+  }
+
+  // Takes snapshots every interval from start until stop; pass the run's
+  // stop time so the snapshots end with it. Finish covers the partial
+  // interval at the end.
+  void Start (Time start, Time stop = Time::Max ())
+  {
+    NS_ABORT_MSG_IF (!m_interval.IsStrictlyPositive (), "FlowSnapshotWriter: interval must be positive");
+    m_stop = stop;
+    if (start + m_interval <= m_stop)
+      {
+        Simulator::Schedule (start + m_interval, &FlowSnapshotWriter::Periodic, this);
+      }
+  }
+
+  // Takes a last snapshot for the partial interval up to the end of the
+  // run, flushes the ring and closes the file; call after Simulator::Run.
+  // False when the stream could not be written completely.
+  bool Finish ()
+  {
+    if (m_writer.IsOpen () && Simulator::Now ().GetNanoSeconds () > m_lastNs)
+      {
+        Snapshot ();
+      }
+    return Close ();
+  }
+
+  bool Close ()
+  {
+    return m_writer.Close ();
+  }
+
+private:
+  struct Counters
+  {
+    Counters ()
+      : txPackets (0),
+        rxPackets (0),
+        lostPackets (0),
+        txBytes (0),
+        rxBytes (0),
+        delaySumNs (0)
+    {
+    }
+
+    uint32_t txPackets;
+    uint32_t rxPackets;
+    uint32_t lostPackets;
+    uint64_t txBytes;
+    uint64_t rxBytes;
+    int64_t delaySumNs;
+  };
+
+  void Snapshot ()
+  {
+    m_monitor->CheckForLostPackets ();
+    int64_t now = Simulator::Now ().GetNanoSeconds ();
+    const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+    for (FlowMonitor::FlowStatsContainer::const_iterator it = stats.begin (); it != stats.end (); ++it)
+      {
+        const FlowMonitor::FlowStats &s = it->second;
+        Counters &last = m_last[it->first];
+        if (s.txPackets == last.txPackets && s.rxPackets == last.rxPackets && s.lostPackets == last.lostPackets)
+          {
+            continue;
+          }
+        Ipv4FlowClassifier::FiveTuple t = m_classifier->FindFlow (it->first);
+        FlowSnapshotRecord record;
+        std::memset (&record, 0, sizeof (record));
+        record.timeNs = now;
+        record.flow = it->first;
+        record.source = t.sourceAddress.Get ();
+        record.destination = t.destinationAddress.Get ();
+        record.sourcePort = t.sourcePort;
+        record.destinationPort = t.destinationPort;
+        record.protocol = t.protocol;
+        record.txPackets = s.txPackets - last.txPackets;
+        record.rxPackets = s.rxPackets - last.rxPackets;
+        record.lostPackets = s.lostPackets - last.lostPackets;
+        record.txBytes = s.txBytes - last.txBytes;
+        record.rxBytes = s.rxBytes - last.rxBytes;
+        record.delaySumNs = s.delaySum.GetNanoSeconds () - last.delaySumNs;
+        m_writer.Append (record);
+
+        last.txPackets = s.txPackets;
+        last.rxPackets = s.rxPackets;
+        last.lostPackets = s.lostPackets;
+        last.txBytes = s.txBytes;
+        last.rxBytes = s.rxBytes;
+        last.delaySumNs = s.delaySum.GetNanoSeconds ();
+      }
+
+    m_lastNs = now;
+  }
+
+  void Periodic ()
+  {
+    Snapshot ();
+    if (Simulator::Now () + m_interval <= m_stop)
+      {
+        Simulator::Schedule (m_interval, &FlowSnapshotWriter::Periodic, this);
+      }
+  }
+
+  Ptr<FlowMonitor> m_monitor;
+  Ptr<Ipv4FlowClassifier> m_classifier;
+  Time m_interval;
+  Time m_stop;        // no periodic snapshot after this
+  int64_t m_lastNs;   // time of the last snapshot
+  std::map<FlowId, Counters> m_last;
+  RingFileWriter<FlowSnapshotRecord> m_writer;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_SNAPSHOT_H */
@@ -0,0 +1,104 @@
+#ifndef FLOW_SNAPSHOT_RECORD_H
+#define FLOW_SNAPSHOT_RECORD_H
+
+// On-disk layout of the FlowMonitor snapshot streams written by
+// common/flow_snapshot.h and read by tools/snapshot_to_tsv.cc. Kept free of
+// ns-3 headers so the offline tools can include it.
+//
+// A file is one FlowSnapshotFileHeader followed by fixed-size records in
+// simulation time order, native byte order. Each record holds what one
+// flow's counters gained during the interval ending at timeNs; flows that
+// did not change in an interval have no record for it.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct FlowSnapshotFileHeader
+{
+  char magic[8];           // "FLOWSNAP"
+  uint32_t version;
+  uint32_t recordSize;
+  int64_t intervalNs;
+};
+
+struct FlowSnapshotRecord
+{
+  int64_t timeNs;          // end of the interval
+  uint32_t flow;           // FlowMonitor FlowId
+  uint32_t source;         // IPv4 address, host byte order
+  uint32_t destination;
+  uint16_t sourcePort;
+  uint16_t destinationPort;
+  uint8_t protocol;
+  uint8_t reserved[3];
+  uint32_t txPackets;      // counters gained during the interval
+  uint32_t rxPackets;
+  uint32_t lostPackets;
+  uint64_t txBytes;
+  uint64_t rxBytes;
+  int64_t delaySumNs;      // of the packets received in the interval
+};
+
+static const uint32_t FLOW_SNAPSHOT_VERSION = 1;
+
+inline FlowSnapshotFileHeader
+MakeFlowSnapshotFileHeader (int64_t intervalNs)
+{
+  FlowSnapshotFileHeader header;
+  std::memcpy (header.magic, "FLOWSNAP", 8);
+  header.version = FLOW_SNAPSHOT_VERSION;
+  header.recordSize = sizeof (FlowSnapshotRecord);
+  header.intervalNs = intervalNs;
+  return header;
+}
+
+inline bool
+IsFlowSnapshotFileHeader (const FlowSnapshotFileHeader &header)
+{
+  return std::memcmp (header.magic, "FLOWSNAP", 8) == 0
+         && header.version == FLOW_SNAPSHOT_VERSION
+         && header.recordSize == sizeof (FlowSnapshotRecord);
+}
+
+// Calls f (record, durationNs) for every record of the file at path, with
+// the length of the interval the record covers: snapshots fall on a grid
+// of intervals, except the last one at the end of the run, which covers
+// whatever is left of its interval. False when the file cannot be read or
+// is not a snapshot stream.
+template <typename F>
+bool
+ForEachFlowSnapshot (const char *path, FlowSnapshotFileHeader &header, F f)
+{
+  std::FILE *in = std::fopen (path, "rb");
+  if (!in)
+    {
+      return false;
+    }
+  if (std::fread (&header, sizeof (header), 1, in) != 1 || !IsFlowSnapshotFileHeader (header)
+      || header.intervalNs <= 0)
+    {
+      std::fclose (in);
+      return false;
+    }
+  int64_t firstNs = -1;
+  std::vector<FlowSnapshotRecord> block (65536);
+  size_t n;
+  while ((n = std::fread (block.data (), sizeof (FlowSnapshotRecord), block.size (), in)) > 0)
+    {
+      for (size_t i = 0; i < n; ++i)
+        {
+          if (firstNs < 0)
+            {
+              firstNs = block[i].timeNs;
+            }
+          int64_t durationNs = (block[i].timeNs - firstNs) % header.intervalNs;
+          f (block[i], durationNs ? durationNs : header.intervalNs);
+        }
+    }
+  std::fclose (in);
+  return true;
+}
+
+#endif /* FLOW_SNAPSHOT_RECORD_H */
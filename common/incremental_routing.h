@@ -0,0 +1,372 @@
+#ifndef INCREMENTAL_ROUTING_H
+#define INCREMENTAL_ROUTING_H
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "incremental_spt.h"
+
+namespace ns3 {
+
+// Routing that follows interface up/down events without recomputing all
+// pairs, for failure injection runs that would otherwise call
+// Ipv4GlobalRoutingHelper::RecomputeRoutingTables (or set
+// Ipv4GlobalRouting::RespondToInterfaceEvents) on every event.
+//
+// Install() puts an extra Ipv4StaticRouting on every node, between the
+// stack's static routing and global routing in the list routing, builds the
+// node graph from the channels and fills in one route per remote subnet
+// from the shortest path trees of common/incremental_spt.h. The interface
+// events the protocol sees are collected and applied in one Update, after
+// the event that raised them (or after the coalescing delay), so taking
+// many interfaces down in one go costs a single update. Only the trees and
+// routes below the changed links are touched.
+//
+// Use it instead of global routing, after the addresses are assigned. The
+// engine has to outlive Simulator::Run. Addresses added or removed later
+// are not picked up.
+class IncrementalRouting : public SimpleRefCount<IncrementalRouting>
+{
+public:
+  IncrementalRouting (Time coalesce = Seconds (0))
+    : m_coalesce (coalesce),
+      m_spt (0),
+      m_events (0),
+      m_updates (0),
+      m_routeChanges (0)
+  {
+  }
+
+  void Install ()
+  {
+    for (uint32_t i = 0; i < NodeList::GetNNodes (); ++i)
+      {
+        Ptr<Ipv4> ipv4 = NodeList::GetNode (i)->GetObject<Ipv4> ();
+        if (!ipv4)
+          {
+            continue;
+          }
+        Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (ipv4->GetRoutingProtocol ());
+        NS_ABORT_MSG_IF (!list, "Node " << i << " does not use Ipv4ListRouting");
+        Ptr<Protocol> protocol = CreateObject<Protocol> ();
+        list->AddRoutingProtocol (protocol, -5);
+        protocol->SetEngine (this, m_ipv4.size ());
+        m_ipv4.push_back (ipv4);
+        m_routing.push_back (protocol);
+      }
+    uint32_t n = m_ipv4.size ();
+    m_spt = IncrementalSpt (n);
+    m_ifLinks.resize (n);
+    m_ifSubnets.resize (n);
+    m_nodeSubnets.resize (n);
+
+    // Subnets and the interfaces attached to them.
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> subnetIds;
+    for (uint32_t v = 0; v < n; ++v)
+      {
+        m_ifLinks[v].resize (m_ipv4[v]->GetNInterfaces ());
+        m_ifSubnets[v].resize (m_ipv4[v]->GetNInterfaces ());
+        for (uint32_t i = 0; i < m_ipv4[v]->GetNInterfaces (); ++i)
+          {
+            for (uint32_t a = 0; a < m_ipv4[v]->GetNAddresses (i); ++a)
+              {
+                Ipv4InterfaceAddress address = m_ipv4[v]->GetAddress (i, a);
+                if (address.GetLocal () == Ipv4Address::GetLoopback ())
+                  {
+                    continue;
+                  }
+                Ipv4Address network = address.GetLocal ().CombineMask (address.GetMask ());
+                std::pair<uint32_t, uint32_t> key (network.Get (), address.GetMask ().Get ());
+                std::map<std::pair<uint32_t, uint32_t>, uint32_t>::iterator it = subnetIds.find (key);
+                if (it == subnetIds.end ())
+                  {
+                    it = subnetIds.insert (std::make_pair (key, m_subnets.size ())).first;
+                    m_subnets.push_back (Subnet (network, address.GetMask ()));
+                  }
+                m_subnets[it->second].attached.push_back (std::make_pair (v, i));
+                m_ifSubnets[v][i].push_back (it->second);
+                m_nodeSubnets[v].push_back (it->second);
+              }
+          }
+      }
+
+    // One link per pair of addressed interfaces on a channel.
+    std::map<uint32_t, uint32_t> index;   // node id -> graph node
+    for (uint32_t v = 0; v < n; ++v)
+      {
+        index[m_ipv4[v]->GetObject<Node> ()->GetId ()] = v;
+      }
+    std::set<uint32_t> channels;
+    for (uint32_t v = 0; v < n; ++v)
+      {
+        for (uint32_t i = 0; i < m_ipv4[v]->GetNInterfaces (); ++i)
+          {
+            Ptr<Channel> channel = m_ipv4[v]->GetNetDevice (i)->GetChannel ();
+            if (!channel || !channels.insert (channel->GetId ()).second)
+              {
+                continue;
+              }
+            std::vector<std::pair<uint32_t, uint32_t> > ends;
+            for (uint32_t d = 0; d < channel->GetNDevices (); ++d)
+              {
+                Ptr<NetDevice> device = channel->GetDevice (d);
+                std::map<uint32_t, uint32_t>::const_iterator it = index.find (device->GetNode ()->GetId ());
+                if (it == index.end ())
+                  {
+                    continue;
+                  }
+                int32_t ifIndex = m_ipv4[it->second]->GetInterfaceForDevice (device);
+                if (ifIndex >= 0 && m_ipv4[it->second]->GetNAddresses (ifIndex) > 0)
+                  {
+                    ends.push_back (std::make_pair (it->second, ifIndex));
+                  }
+              }
+            for (uint32_t a = 0; a < ends.size (); ++a)
+              {
+                for (uint32_t b = a + 1; b < ends.size (); ++b)
+                  {
+                    AddLink (ends[a], ends[b]);
+                  }
+              }
+          }
+      }
+
+    m_spt.ComputeAll ();
+    m_installed.assign (uint64_t (n) * m_subnets.size (), IncrementalSpt::NONE);
+    for (uint32_t s = 0; s < n; ++s)
+      {
+        for (uint32_t subnet = 0; subnet < m_subnets.size (); ++subnet)
+          {
+            Refresh (s, subnet);
+          }
+      }
+  }
+
+  void PrintStats (std::ostream &os) const
+  {
+    os << "interface_events\t" << m_events << "\n"
+       << "updates\t" << m_updates << "\n"
+       << "trees_touched\t" << m_spt.GetSourcesTouched () << "\n"
+       << "nodes_recomputed\t" << m_spt.GetNodesRecomputed () << "\n"
+       << "route_changes\t" << m_routeChanges << "\n";
+  }
+
+private:
+  // Static routing that reports the interface events of its node.
+  class Protocol : public Ipv4StaticRouting
+  {
+  public:
+    Protocol ()
+      : m_engine (0),
+        m_node (0)
+    {
+    }
+
+    void SetEngine (IncrementalRouting *engine, uint32_t node)
+    {
+      m_engine = engine;
+      m_node = node;
+    }
+
+    virtual void NotifyInterfaceUp (uint32_t interface)
+    {
+      Ipv4StaticRouting::NotifyInterfaceUp (interface);
+      if (m_engine)
+        {
+          m_engine->InterfaceChanged (m_node, interface, false);
+        }
+    }
+
+    virtual void NotifyInterfaceDown (uint32_t interface)
+    {
+      Ipv4StaticRouting::NotifyInterfaceDown (interface);
+      if (m_engine)
+        {
+          m_engine->InterfaceChanged (m_node, interface, true);
+        }
+    }
+
+  private:
+    IncrementalRouting *m_engine;
+    uint32_t m_node;
+  };
+
+  struct Subnet
+  {
+    Subnet (Ipv4Address n, Ipv4Mask m)
+      : network (n),
+        mask (m)
+    {
+    }
+
+    Ipv4Address network;
+    Ipv4Mask mask;
+    std::vector<std::pair<uint32_t, uint32_t> > attached;   // (node, interface)
+  };
+
+  void AddLink (std::pair<uint32_t, uint32_t> a, std::pair<uint32_t, uint32_t> b)
+  {
+    bool up = m_ipv4[a.first]->IsUp (a.second) && m_ipv4[b.first]->IsUp (b.second);
+    uint32_t e = m_spt.AddLink (a.first, b.first, up);
+    m_edgeIf.resize (e + 2);
+    m_edgeGateway.resize (e + 2);
+    m_edgeIf[e] = a.second;
+    m_edgeIf[e + 1] = b.second;
+    m_edgeGateway[e] = m_ipv4[b.first]->GetAddress (b.second, 0).GetLocal ();
+    m_edgeGateway[e + 1] = m_ipv4[a.first]->GetAddress (a.second, 0).GetLocal ();
+    m_ifLinks[a.first][a.second].push_back (e);
+    m_ifLinks[b.first][b.second].push_back (e);
+  }
+
+  void InterfaceChanged (uint32_t node, uint32_t interface, bool down)
+  {
+    if (interface >= m_ifLinks[node].size ())
+      {
+        return; // added after Install
+      }
+    ++m_events;
+    if (down)
+      {
+        // Static routing has just deleted the node's routes through the
+        // interface. Forget them here too: if the interface comes back up
+        // before the update, the trees see no change, and these routes
+        // would otherwise never be added again.
+        for (uint32_t subnet = 0; subnet < m_subnets.size (); ++subnet)
+          {
+            uint32_t &installed = m_installed[uint64_t (node) * m_subnets.size () + subnet];
+            if (installed != IncrementalSpt::NONE && m_edgeIf[installed] == interface)
+              {
+                installed = IncrementalSpt::NONE;
+                m_lost.push_back (std::make_pair (node, subnet));
+              }
+          }
+      }
+    m_dirty.push_back (std::make_pair (node, interface));
+    if (!m_pending.IsRunning ())
+      {
+        m_pending = Simulator::Schedule (m_coalesce, &IncrementalRouting::Update, this);
+      }
+  }
+
+  void Update ()
+  {
+    ++m_updates;
+    std::vector<bool> attachmentChanged (m_subnets.size (), false);
+    for (const std::pair<uint32_t, uint32_t> &dirty : m_dirty)
+      {
+        for (uint32_t e : m_ifLinks[dirty.first][dirty.second])
+          {
+            uint32_t a = m_spt.GetFrom (e);
+            uint32_t b = m_spt.GetTo (e);
+            m_spt.SetLinkUp (e, m_ipv4[a]->IsUp (m_edgeIf[e]) && m_ipv4[b]->IsUp (m_edgeIf[e + 1]));
+          }
+        for (uint32_t subnet : m_ifSubnets[dirty.first][dirty.second])
+          {
+            attachmentChanged[subnet] = true;
+          }
+      }
+    m_dirty.clear ();
+
+    m_spt.Update ([this] (uint32_t s, uint32_t node) {
+      for (uint32_t subnet : m_nodeSubnets[node])
+        {
+          Refresh (s, subnet);
+        }
+    });
+    for (const std::pair<uint32_t, uint32_t> &lost : m_lost)
+      {
+        Refresh (lost.first, lost.second);
+      }
+    m_lost.clear ();
+    for (uint32_t subnet = 0; subnet < m_subnets.size (); ++subnet)
+      {
+        if (attachmentChanged[subnet])
+          {
+            for (uint32_t s = 0; s < m_ipv4.size (); ++s)
+              {
+                Refresh (s, subnet);
+              }
+          }
+      }
+  }
+
+  // Points the route of s to subnet at the first hop towards the closest
+  // node with an up interface on it; no route when s is on it itself or
+  // cannot reach it.
+  void Refresh (uint32_t s, uint32_t subnet)
+  {
+    const Subnet &dest = m_subnets[subnet];
+    uint32_t want = IncrementalSpt::NONE;
+    uint32_t best = IncrementalSpt::NONE;
+    for (const std::pair<uint32_t, uint32_t> &end : dest.attached)
+      {
+        if (!m_ipv4[end.first]->IsUp (end.second))
+          {
+            continue;
+          }
+        if (end.first == s)
+          {
+            want = IncrementalSpt::NONE;
+            break;
+          }
+        uint32_t d = m_spt.GetDistance (s, end.first);
+        if (d < best)
+          {
+            best = d;
+            want = m_spt.GetFirstHop (s, end.first);
+          }
+      }
+
+    uint32_t &installed = m_installed[uint64_t (s) * m_subnets.size () + subnet];
+    if (installed == want)
+      {
+        return;
+      }
+    Ptr<Protocol> routing = m_routing[s];
+    if (installed != IncrementalSpt::NONE)
+      {
+        for (uint32_t j = 0; j < routing->GetNRoutes (); ++j)
+          {
+            Ipv4RoutingTableEntry route = routing->GetRoute (j);
+            if (route.GetDest () == dest.network && route.GetDestNetworkMask () == dest.mask
+                && route.GetGateway () == m_edgeGateway[installed] && route.GetInterface () == m_edgeIf[installed])
+              {
+                routing->RemoveRoute (j);
+                break;
+              }
+          }
+      }
+    if (want != IncrementalSpt::NONE)
+      {
+        routing->AddNetworkRouteTo (dest.network, dest.mask, m_edgeGateway[want], m_edgeIf[want]);
+      }
+    installed = want;
+    ++m_routeChanges;
+  }
+
+  Time m_coalesce;
+  IncrementalSpt m_spt;
+  std::vector<Ptr<Ipv4> > m_ipv4;                          // per graph node
+  std::vector<Ptr<Protocol> > m_routing;
+  std::vector<uint32_t> m_edgeIf;                          // per link direction
+  std::vector<Ipv4Address> m_edgeGateway;
+  std::vector<std::vector<std::vector<uint32_t> > > m_ifLinks;     // [node][interface]
+  std::vector<std::vector<std::vector<uint32_t> > > m_ifSubnets;   // [node][interface]
+  std::vector<std::vector<uint32_t> > m_nodeSubnets;
+  std::vector<Subnet> m_subnets;
+  std::vector<uint32_t> m_installed;                       // [source * subnets + subnet]
+  std::vector<std::pair<uint32_t, uint32_t> > m_dirty;
+  std::vector<std::pair<uint32_t, uint32_t> > m_lost;      // (source, subnet) routes deleted by a down event
+  EventId m_pending;
+  uint64_t m_events;
+  uint64_t m_updates;
+  uint64_t m_routeChanges;
+};
+
+} // namespace ns3
+
+#endif /* INCREMENTAL_ROUTING_H */
@@ -0,0 +1,341 @@
+#ifndef INCREMENTAL_SPT_H
+#define INCREMENTAL_SPT_H
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Shortest path trees from every node of an undirected hop-count graph,
+// kept up to date as links go down and come back up.
+//
+// A link that goes down only invalidates the subtrees hanging below it in
+// the trees that use it; those nodes are re-attached from their neighbours
+// outside the subtree and the rest of the tree is left alone. A link that
+// comes up only lowers distances, which are propagated from its ends. In a
+// star, a spoke link going down touches one node per tree instead of
+// redoing an all pairs computation.
+//
+// No ns-3 dependency; common/incremental_routing.h maps nodes, interfaces
+// and subnets onto it.
+class IncrementalSpt
+{
+public:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  explicit IncrementalSpt (uint32_t nNodes)
+    : m_n (nNodes),
+      m_out (nNodes),
+      m_epoch (0),
+      m_sourcesTouched (0),
+      m_nodesRecomputed (0)
+  {
+  }
+
+  // Adds the link a-b and returns the id of its a->b direction; b->a is
+  // that id ^ 1. Links are added before ComputeAll.
+  uint32_t AddLink (uint32_t a, uint32_t b, bool up)
+  {
+    uint32_t e = m_edges.size ();
+    m_edges.push_back (Edge (a, b, up));
+    m_edges.push_back (Edge (b, a, up));
+    m_out[a].push_back (e);
+    m_out[b].push_back (e + 1);
+    return e;
+  }
+
+  uint32_t GetNNodes () const
+  {
+    return m_n;
+  }
+
+  uint32_t GetFrom (uint32_t e) const
+  {
+    return m_edges[e].from;
+  }
+
+  uint32_t GetTo (uint32_t e) const
+  {
+    return m_edges[e].to;
+  }
+
+  bool IsUp (uint32_t e) const
+  {
+    return m_edges[e].up;
+  }
+
+  uint32_t GetDistance (uint32_t source, uint32_t node) const
+  {
+    return m_dist[uint64_t (source) * m_n + node];
+  }
+
+  // Edge leaving source on a shortest path to node, NONE for the source
+  // itself and for unreachable nodes.
+  uint32_t GetFirstHop (uint32_t source, uint32_t node) const
+  {
+    return m_firstHop[uint64_t (source) * m_n + node];
+  }
+
+  // Sources whose tree an Update had to change, and nodes re-attached or
+  // lowered in them, since construction.
+  uint64_t GetSourcesTouched () const
+  {
+    return m_sourcesTouched;
+  }
+
+  uint64_t GetNodesRecomputed () const
+  {
+    return m_nodesRecomputed;
+  }
+
+  // Breadth first search from every node.
+  void ComputeAll ()
+  {
+    m_dist.assign (uint64_t (m_n) * m_n, NONE);
+    m_parent.assign (uint64_t (m_n) * m_n, NONE);
+    m_firstHop.assign (uint64_t (m_n) * m_n, NONE);
+    m_mark.assign (m_n, 0);
+    std::vector<uint32_t> queue;
+    for (uint32_t s = 0; s < m_n; ++s)
+      {
+        uint32_t *dist = &m_dist[uint64_t (s) * m_n];
+        dist[s] = 0;
+        queue.assign (1, s);
+        for (uint32_t head = 0; head < queue.size (); ++head)
+          {
+            uint32_t x = queue[head];
+            for (uint32_t f : m_out[x])
+              {
+                uint32_t w = m_edges[f].to;
+                if (m_edges[f].up && dist[w] == NONE)
+                  {
+                    Attach (s, w, f, dist[x] + 1);
+                    queue.push_back (w);
+                  }
+              }
+          }
+      }
+    m_pendingDown.clear ();
+    m_pendingUp.clear ();
+  }
+
+  // Records a state change of link e (either direction) for the next
+  // Update. Repeated changes before the Update cancel out.
+  void SetLinkUp (uint32_t e, bool up)
+  {
+    e &= ~1u;
+    if (m_edges[e].up == up)
+      {
+        return;
+      }
+    m_edges[e].up = up;
+    m_edges[e + 1].up = up;
+    (up ? m_pendingUp : m_pendingDown).push_back (e);
+  }
+
+  // Brings every tree up to date with the recorded link changes and calls
+  // changed (source, node) for each node whose distance or first hop
+  // changed (possibly more than once).
+  void Update (const std::function<void (uint32_t, uint32_t)> &changed)
+  {
+    std::vector<uint32_t> down;
+    std::vector<uint32_t> up;
+    for (uint32_t e : m_pendingDown)
+      {
+        if (!m_edges[e].up)
+          {
+            down.push_back (e);
+            down.push_back (e + 1);
+          }
+      }
+    for (uint32_t e : m_pendingUp)
+      {
+        if (m_edges[e].up)
+          {
+            up.push_back (e);
+            up.push_back (e + 1);
+          }
+      }
+    m_pendingDown.clear ();
+    m_pendingUp.clear ();
+    if (down.empty () && up.empty ())
+      {
+        return;
+      }
+
+    std::vector<uint32_t> subtree;
+    for (uint32_t s = 0; s < m_n; ++s)
+      {
+        bool touched = false;
+
+        // Links gone down: cut the subtrees below them loose and re-attach
+        // their nodes from the rest of the tree.
+        subtree.clear ();
+        ++m_epoch;
+        for (uint32_t e : down)
+          {
+            uint32_t b = m_edges[e].to;
+            if (Parent (s, b) == e && m_mark[b] != m_epoch)
+              {
+                m_mark[b] = m_epoch;
+                subtree.push_back (b);
+              }
+          }
+        if (!subtree.empty ())
+          {
+            touched = true;
+            for (uint32_t head = 0; head < subtree.size (); ++head)
+              {
+                uint32_t x = subtree[head];
+                for (uint32_t f : m_out[x])
+                  {
+                    uint32_t w = m_edges[f].to;
+                    if (Parent (s, w) == f && m_mark[w] != m_epoch)
+                      {
+                        m_mark[w] = m_epoch;
+                        subtree.push_back (w);
+                      }
+                  }
+              }
+            for (uint32_t x : subtree)
+              {
+                Detach (s, x);
+              }
+            Queue queue;
+            for (uint32_t x : subtree)
+              {
+                for (uint32_t f : m_out[x])
+                  {
+                    uint32_t w = m_edges[f].to;
+                    uint32_t d = Distance (s, w);
+                    if (m_edges[f].up && m_mark[w] != m_epoch && d != NONE && d + 1 < Distance (s, x))
+                      {
+                        Attach (s, x, f ^ 1, d + 1);
+                        queue.push (std::make_pair (d + 1, x));
+                      }
+                  }
+              }
+            Propagate (s, queue, changed);
+            for (uint32_t x : subtree)
+              {
+                if (Distance (s, x) == NONE)
+                  {
+                    changed (s, x); // cut off
+                  }
+              }
+            m_nodesRecomputed += subtree.size ();
+          }
+
+        // Links come up: lower the distances they shorten.
+        Queue queue;
+        for (uint32_t e : up)
+          {
+            uint32_t a = m_edges[e].from;
+            uint32_t b = m_edges[e].to;
+            uint32_t d = Distance (s, a);
+            if (d != NONE && d + 1 < Distance (s, b))
+              {
+                Attach (s, b, e, d + 1);
+                queue.push (std::make_pair (d + 1, b));
+              }
+          }
+        if (!queue.empty ())
+          {
+            touched = true;
+            m_nodesRecomputed += Propagate (s, queue, changed);
+          }
+        m_sourcesTouched += touched;
+      }
+  }
+
+private:
+  struct Edge
+  {
+    Edge (uint32_t f, uint32_t t, bool u)
+      : from (f),
+        to (t),
+        up (u)
+    {
+    }
+
+    uint32_t from;
+    uint32_t to;
+    bool up;
+  };
+
+  typedef std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t> >,
+                              std::greater<std::pair<uint32_t, uint32_t> > > Queue;
+
+  uint32_t Distance (uint32_t s, uint32_t x) const
+  {
+    return m_dist[uint64_t (s) * m_n + x];
+  }
+
+  uint32_t Parent (uint32_t s, uint32_t x) const
+  {
+    return m_parent[uint64_t (s) * m_n + x];
+  }
+
+  // Hangs x below the tail of edge e (which ends at x) in the tree of s.
+  void Attach (uint32_t s, uint32_t x, uint32_t e, uint32_t d)
+  {
+    uint64_t i = uint64_t (s) * m_n + x;
+    uint32_t w = m_edges[e].from;
+    m_dist[i] = d;
+    m_parent[i] = e;
+    m_firstHop[i] = (w == s) ? e : m_firstHop[uint64_t (s) * m_n + w];
+  }
+
+  void Detach (uint32_t s, uint32_t x)
+  {
+    uint64_t i = uint64_t (s) * m_n + x;
+    m_dist[i] = NONE;
+    m_parent[i] = NONE;
+    m_firstHop[i] = NONE;
+  }
+
+  // Dijkstra from the queued nodes over the up links; reports and counts
+  // the nodes it settles.
+  uint32_t Propagate (uint32_t s, Queue &queue, const std::function<void (uint32_t, uint32_t)> &changed)
+  {
+    uint32_t lowered = 0;
+    while (!queue.empty ())
+      {
+        uint32_t d = queue.top ().first;
+        uint32_t x = queue.top ().second;
+        queue.pop ();
+        if (d != Distance (s, x))
+          {
+            continue;
+          }
+        changed (s, x);
+        ++lowered;
+        for (uint32_t f : m_out[x])
+          {
+            uint32_t w = m_edges[f].to;
+            if (m_edges[f].up && d + 1 < Distance (s, w))
+              {
+                Attach (s, w, f, d + 1);
+                queue.push (std::make_pair (d + 1, w));
+              }
+          }
+      }
+    return lowered;
+  }
+
+  uint32_t m_n;
+  std::vector<Edge> m_edges;
+  std::vector<std::vector<uint32_t> > m_out;
+  std::vector<uint32_t> m_dist;       // [source * n + node]
+  std::vector<uint32_t> m_parent;     // edge into node in the tree of source
+  std::vector<uint32_t> m_firstHop;   // edge out of source towards node
+  std::vector<uint32_t> m_mark;
+  uint32_t m_epoch;
+  std::vector<uint32_t> m_pendingDown;
+  std::vector<uint32_t> m_pendingUp;
+  uint64_t m_sourcesTouched;
+  uint64_t m_nodesRecomputed;
+};
+
+#endif /* INCREMENTAL_SPT_H */
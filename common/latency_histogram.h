@@ -0,0 +1,219 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+// Log-linear (HDR style) histogram of non-negative integer values, e.g.
+// delays in nanoseconds.
+//
+// Values below 2^subBits get a bucket each; above that every power of two
+// is split into 2^(subBits-1) equal buckets, so a bucket is never wider
+// than 1/2^(subBits-1) of the values in it (0.8% with the default 8 bits).
+// Memory is fixed by subBits and the largest value tracked (larger values
+// land in the last bucket), recording is a bit scan and an increment, and
+// two histograms with the same layout merge by adding their counters, so
+// flows and replications can be combined after the fact.
+//
+// Write()/Read() use one text line: "hdr <subBits> <maxBits> <count>
+// <min> <max> <sum>" followed by "<bucket>:<count>" pairs of the non-empty
+// buckets. No ns-3 dependency; tools/latency_merge.cc reads these lines.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class LatencyHistogram
+{
+public:
+  // Tracks values below 2^maxBits (default about 1100s in nanoseconds).
+  explicit LatencyHistogram (uint32_t subBits = 8, uint32_t maxBits = 40)
+    : m_subBits (std::max<uint32_t> (subBits, 2)),
+      m_maxBits (std::min<uint32_t> (std::max (maxBits, m_subBits), 63)),
+      m_count (0),
+      m_min (UINT64_MAX),
+      m_max (0),
+      m_sum (0)
+  {
+    m_buckets.assign (BucketOf ((uint64_t (1) << m_maxBits) - 1) + 1, 0);
+  }
+
+  void Record (uint64_t value, uint64_t count = 1)
+  {
+    m_buckets[std::min<size_t> (BucketOf (value), m_buckets.size () - 1)] += count;
+    m_count += count;
+    m_min = std::min (m_min, value);
+    m_max = std::max (m_max, value);
+    m_sum += static_cast<double> (value) * count;
+  }
+
+  // False (and nothing merged) when the layouts differ.
+  bool Merge (const LatencyHistogram &other)
+  {
+    if (other.m_subBits != m_subBits || other.m_maxBits != m_maxBits)
+      {
+        return false;
+      }
+    for (size_t i = 0; i < m_buckets.size (); ++i)
+      {
+        m_buckets[i] += other.m_buckets[i];
+      }
+    m_count += other.m_count;
+    m_min = std::min (m_min, other.m_min);
+    m_max = std::max (m_max, other.m_max);
+    m_sum += other.m_sum;
+    return true;
+  }
+
+  uint64_t GetCount () const
+  {
+    return m_count;
+  }
+
+  uint64_t GetMin () const
+  {
+    return m_count ? m_min : 0;
+  }
+
+  uint64_t GetMax () const
+  {
+    return m_max;
+  }
+
+  double GetMean () const
+  {
+    return m_count ? m_sum / m_count : 0;
+  }
+
+  // Value at quantile q (0.5, 0.99, ...) by nearest rank, ceil(q * count):
+  // the middle of the bucket holding it, clamped to the exact minimum and
+  // maximum.
+  uint64_t GetQuantile (double q) const
+  {
+    if (m_count == 0)
+      {
+        return 0;
+      }
+    uint64_t rank = static_cast<uint64_t> (std::ceil (q * m_count));
+    rank = std::min (std::max<uint64_t> (rank, 1), m_count);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_buckets.size (); ++i)
+      {
+        seen += m_buckets[i];
+        if (seen >= rank)
+          {
+            uint64_t low = LowestOf (i);
+            uint64_t value = low + (WidthOf (i) - 1) / 2;
+            return std::min (std::max (value, m_min), m_max);
+          }
+      }
+    return m_max;
+  }
+
+  void Write (std::ostream &out) const
+  {
+    // The sum at full double precision, so merged means match the runs.
+    std::streamsize precision = out.precision (17);
+    out << "hdr " << m_subBits << " " << m_maxBits << " " << m_count << " " << GetMin () << " " << m_max
+        << " " << m_sum;
+    out.precision (precision);
+    for (size_t i = 0; i < m_buckets.size (); ++i)
+      {
+        if (m_buckets[i])
+          {
+            out << " " << i << ":" << m_buckets[i];
+          }
+      }
+  }
+
+  // Parses one line written by Write().
+  static bool Read (const std::string &line, LatencyHistogram &histogram)
+  {
+    std::istringstream iss (line);
+    std::string tag;
+    uint32_t subBits;
+    uint32_t maxBits;
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+    if (!(iss >> tag >> subBits >> maxBits >> count >> min >> max >> sum) || tag != "hdr")
+      {
+        return false;
+      }
+    histogram = LatencyHistogram (subBits, maxBits);
+    std::string pair;
+    while (iss >> pair)
+      {
+        std::string::size_type colon = pair.find (':');
+        if (colon == std::string::npos)
+          {
+            return false;
+          }
+        size_t bucket = std::stoull (pair.substr (0, colon));
+        if (bucket >= histogram.m_buckets.size ())
+          {
+            return false;
+          }
+        histogram.m_buckets[bucket] = std::stoull (pair.substr (colon + 1));
+      }
+    histogram.m_count = count;
+    histogram.m_min = count ? min : UINT64_MAX;
+    histogram.m_max = max;
+    histogram.m_sum = sum;
+    return true;
+  }
+
+private:
+  static uint32_t Msb (uint64_t value)
+  {
+    return 63 - __builtin_clzll (value);
+  }
+
+  size_t BucketOf (uint64_t value) const
+  {
+    uint64_t linear = uint64_t (1) << m_subBits;
+    if (value < linear)
+      {
+        return value;
+      }
+    uint32_t shift = Msb (value) - m_subBits + 1;
+    uint64_t half = linear / 2;
+    return linear + (shift - 1) * half + ((value >> shift) - half);
+  }
+
+  uint64_t LowestOf (size_t bucket) const
+  {
+    uint64_t linear = uint64_t (1) << m_subBits;
+    if (bucket < linear)
+      {
+        return bucket;
+      }
+    uint64_t half = linear / 2;
+    uint32_t shift = (bucket - linear) / half + 1;
+    return (half + (bucket - linear) % half) << shift;
+  }
+
+  uint64_t WidthOf (size_t bucket) const
+  {
+    uint64_t linear = uint64_t (1) << m_subBits;
+    if (bucket < linear)
+      {
+        return 1;
+      }
+    return uint64_t (1) << ((bucket - linear) / (linear / 2) + 1);
+  }
+
+  uint32_t m_subBits;
+  uint32_t m_maxBits;
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_count;
+  uint64_t m_min;
+  uint64_t m_max;
+  double m_sum;
+};
+
+#endif /* LATENCY_HISTOGRAM_H */
@@ -0,0 +1,216 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "latency_histogram.h"
+#include "latency_tag.h"
+
+namespace ns3 {
+
+// Per-packet one-way delay and jitter of every IPv4 flow, in log-linear
+// histograms (common/latency_histogram.h) instead of the delaySum and
+// jitterSum totals of FlowMonitor, so the tail shows.
+//
+// A byte tag with the send time is added to each packet an installed node
+// sends, and read back where an installed node delivers it locally; nothing
+// is kept per packet in flight. Flows are keyed by the same five tuple as
+// Ipv4FlowClassifier, so the FlowMonitor loops look them up with the tuple
+// they already have. Jitter is |d(i) - d(i-1)| between consecutive packets
+// of a flow, as FlowMonitor defines it. Values are kept in nanoseconds.
+class LatencyProbe : public SimpleRefCount<LatencyProbe>
+{
+public:
+  struct FlowLatency
+  {
+    FlowLatency ()
+      : lastDelay (-1)
+    {
+    }
+
+    LatencyHistogram delay;
+    LatencyHistogram jitter;
+    int64_t lastDelay;
+  };
+
+  void Install (NodeContainer nodes)
+  {
+    for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+      {
+        Ptr<Ipv4L3Protocol> ipv4 = (*it)->GetObject<Ipv4L3Protocol> ();
+        NS_ABORT_MSG_IF (!ipv4, "LatencyProbe: node " << (*it)->GetId () << " has no IPv4 stack");
+        ipv4->TraceConnectWithoutContext ("SendOutgoing", MakeCallback (&LatencyProbe::Sent, this));
+        ipv4->TraceConnectWithoutContext ("LocalDeliver", MakeCallback (&LatencyProbe::Delivered, this));
+      }
+  }
+
+  void InstallAll (void)
+  {
+    Install (NodeContainer::GetGlobal ());
+  }
+
+  // Zero when nothing of the flow was delivered.
+  const FlowLatency *Find (const Ipv4FlowClassifier::FiveTuple &tuple) const
+  {
+    std::map<Ipv4FlowClassifier::FiveTuple, FlowLatency>::const_iterator it = m_flows.find (tuple);
+    return it == m_flows.end () ? 0 : &it->second;
+  }
+
+  // All flows merged, e.g. for a run summary.
+  LatencyHistogram Total (bool jitter = false) const
+  {
+    LatencyHistogram total;
+    for (const auto &flow : m_flows)
+      {
+        total.Merge (jitter ? flow.second.jitter : flow.second.delay);
+      }
+    return total;
+  }
+
+  // "p50 / p90 / p99 / p99.9" in milliseconds.
+  static std::string Percentiles (const LatencyHistogram &histogram)
+  {
+    std::ostringstream oss;
+    oss << histogram.GetQuantile (0.5) / 1e6 << " / " << histogram.GetQuantile (0.9) / 1e6 << " / "
+        << histogram.GetQuantile (0.99) / 1e6 << " / " << histogram.GetQuantile (0.999) / 1e6 << " ms";
+    return oss.str ();
+  }
+
+  // The delay and jitter percentile lines of one flow for a run's console
+  // report; nothing when the flow delivered no packet.
+  void Print (std::ostream &os, const Ipv4FlowClassifier::FiveTuple &tuple) const
+  {
+    const FlowLatency *flow = Find (tuple);
+    if (flow)
+      {
+        os << "  Delay p50/p90/p99/p99.9: " << Percentiles (flow->delay) << "\n";
+        os << "  Jitter p50/p90/p99/p99.9: " << Percentiles (flow->jitter) << "\n";
+      }
+  }
+
+  // <prefix>_latency.tsv (Write) and <prefix>_latency.hdr (WriteHistograms).
+  bool WriteFiles (const std::string &prefix) const
+  {
+    return Write (prefix + "_latency.tsv") && WriteHistograms (prefix + "_latency.hdr");
+  }
+
+  // One line per flow, in milliseconds:
+  //   flow packets delay_mean delay_p50 delay_p90 delay_p99 delay_p999
+  //   delay_max jitter_p50 jitter_p90 jitter_p99 jitter_p999
+  // where flow is "src:port->dst:port/proto".
+  bool Write (const std::string &path) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    out << "flow\tpackets\tdelay_mean\tdelay_p50\tdelay_p90\tdelay_p99\tdelay_p999\tdelay_max"
+        << "\tjitter_p50\tjitter_p90\tjitter_p99\tjitter_p999\n";
+    for (const auto &flow : m_flows)
+      {
+        const LatencyHistogram &delay = flow.second.delay;
+        const LatencyHistogram &jitter = flow.second.jitter;
+        out << FlowName (flow.first) << "\t" << delay.GetCount () << "\t" << delay.GetMean () / 1e6 << "\t"
+            << delay.GetQuantile (0.5) / 1e6 << "\t" << delay.GetQuantile (0.9) / 1e6 << "\t"
+            << delay.GetQuantile (0.99) / 1e6 << "\t" << delay.GetQuantile (0.999) / 1e6 << "\t"
+            << delay.GetMax () / 1e6 << "\t" << jitter.GetQuantile (0.5) / 1e6 << "\t"
+            << jitter.GetQuantile (0.9) / 1e6 << "\t" << jitter.GetQuantile (0.99) / 1e6 << "\t"
+            << jitter.GetQuantile (0.999) / 1e6 << "\n";
+      }
+    return true;
+  }
+
+  // The histograms themselves, "flow kind hdr..." with kind delay or
+  // jitter, for tools/latency_merge.cc to combine across flows and runs.
+  bool WriteHistograms (const std::string &path) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    for (const auto &flow : m_flows)
+      {
+        out << FlowName (flow.first) << "\tdelay\t";
+        flow.second.delay.Write (out);
+        out << "\n" << FlowName (flow.first) << "\tjitter\t";
+        flow.second.jitter.Write (out);
+        out << "\n";
+      }
+    return true;
+  }
+
+private:
+  static std::string FlowName (const Ipv4FlowClassifier::FiveTuple &tuple)
+  {
+    std::ostringstream oss;
+    oss << tuple.sourceAddress << ":" << tuple.sourcePort << "->" << tuple.destinationAddress << ":"
+        << tuple.destinationPort << "/" << uint32_t (tuple.protocol);
+    return oss.str ();
+  }
+
+  void Sent (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface)
+  {
+    LatencyTag tag;
+    if (!packet->FindFirstMatchingByteTag (tag))
+      {
+        tag.m_sent = Simulator::Now ().GetNanoSeconds ();
+        packet->AddByteTag (tag);
+      }
+  }
+
+  void Delivered (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface)
+  {
+    LatencyTag tag;
+    if (!packet->FindFirstMatchingByteTag (tag))
+      {
+        return;
+      }
+    Ipv4FlowClassifier::FiveTuple tuple;
+    tuple.sourceAddress = header.GetSource ();
+    tuple.destinationAddress = header.GetDestination ();
+    tuple.protocol = header.GetProtocol ();
+    tuple.sourcePort = 0;
+    tuple.destinationPort = 0;
+    if (tuple.protocol == UdpL4Protocol::PROT_NUMBER)
+      {
+        UdpHeader udp;
+        if (packet->PeekHeader (udp))
+          {
+            tuple.sourcePort = udp.GetSourcePort ();
+            tuple.destinationPort = udp.GetDestinationPort ();
+          }
+      }
+    else if (tuple.protocol == TcpL4Protocol::PROT_NUMBER)
+      {
+        TcpHeader tcp;
+        if (packet->PeekHeader (tcp))
+          {
+            tuple.sourcePort = tcp.GetSourcePort ();
+            tuple.destinationPort = tcp.GetDestinationPort ();
+          }
+      }
+
+    int64_t delay = Simulator::Now ().GetNanoSeconds () - tag.m_sent;
+    FlowLatency &flow = m_flows[tuple];
+    flow.delay.Record (delay);
+    if (flow.lastDelay >= 0)
+      {
+        flow.jitter.Record (std::llabs (delay - flow.lastDelay));
+      }
+    flow.lastDelay = delay;
+  }
+
+  std::map<Ipv4FlowClassifier::FiveTuple, FlowLatency> m_flows;
+};
+
+} // namespace ns3
+
+#endif /* LATENCY_PROBE_H */
@@ -0,0 +1,60 @@
+#ifndef LATENCY_TAG_H
+#define LATENCY_TAG_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+namespace ns3 {
+
+// Send time of a packet, added where the packet leaves its source IP layer
+// by LatencyProbe and EndpointFlowMonitor. Both keep a tag that is already
+// there, so they agree on the send time when installed together.
+class LatencyTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::LatencyTag")
+      .SetParent<Tag> ()
+      .SetGroupName ("Stats")
+      .AddConstructor<LatencyTag> ()
+      ;
+    return tid;
+  }
+
+  LatencyTag ()
+    : m_sent (0)
+  {
+  }
+
+  TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+
+  uint32_t GetSerializedSize (void) const
+  {
+    return 8;
+  }
+
+  void Serialize (TagBuffer buffer) const
+  {
+    buffer.WriteU64 (m_sent);
+  }
+
+  void Deserialize (TagBuffer buffer)
+  {
+    m_sent = buffer.ReadU64 ();
+  }
+
+  void Print (std::ostream &os) const
+  {
+    os << "sent=" << m_sent;
+  }
+
+  int64_t m_sent;   // nanoseconds
+};
+
+} // namespace ns3
+
+#endif /* LATENCY_TAG_H */
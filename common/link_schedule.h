@@ -0,0 +1,298 @@
+#ifndef LINK_SCHEDULE_H
+#define LINK_SCHEDULE_H
+
+#include <cmath>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/csma-module.h"
+
+namespace ns3 {
+
+// A capacity/delay time series for a link, replayed by LinkDynamics.
+//
+// Two file formats are read:
+//
+//   time rate delay: one "<time s> <rate> [<delay>]" line per change,
+//   rate and delay as ns-3 strings ("1Mbps", "20ms") or "-" to keep the
+//   current value; '#' starts a comment.
+//
+//   Mahimahi: one integer per line, the millisecond timestamp of a
+//   1500 byte delivery opportunity; the trace repeats after its last
+//   timestamp (which has to be after 0). It is turned into one rate per
+//   bin (100ms by default).
+//   Bins without any opportunity get the rate of one packet per bin, since
+//   a zero rate would hold the packet on the wire until the next change.
+//
+// Load() tells the two apart by the first data line. Consecutive steps
+// with the same values are merged when the schedule is built, so the
+// replay only schedules real changes.
+class LinkSchedule : public SimpleRefCount<LinkSchedule>
+{
+public:
+  struct Step
+  {
+    int64_t time;    // time steps
+    uint64_t bps;    // 0: keep
+    int64_t delay;   // time steps, -1: keep
+  };
+
+  LinkSchedule ()
+    : m_period (0)
+  {
+  }
+
+  // Adds a change at time; a zero rate or a negative delay keeps that
+  // value. Steps have to be added in time order.
+  void Add (Time time, DataRate rate, Time delay = TimeStep (-1))
+  {
+    NS_ABORT_MSG_IF (!m_steps.empty () && time.GetTimeStep () < m_steps.back ().time,
+                     "Link schedule steps out of order at " << time.GetSeconds () << "s");
+    Step step;
+    step.time = time.GetTimeStep ();
+    step.bps = rate.GetBitRate ();
+    step.delay = delay.IsNegative () ? -1 : delay.GetTimeStep ();
+    if (!m_steps.empty () && step.bps == m_steps.back ().bps && step.delay == m_steps.back ().delay)
+      {
+        return;
+      }
+    if (!m_steps.empty () && step.time == m_steps.back ().time)
+      {
+        m_steps.back () = step;
+        return;
+      }
+    m_steps.push_back (step);
+  }
+
+  // Replays the schedule again every period after its start (zero: once).
+  void SetPeriod (Time period)
+  {
+    m_period = period.GetTimeStep ();
+  }
+
+  Time GetPeriod () const
+  {
+    return TimeStep (m_period);
+  }
+
+  const std::vector<Step> &GetSteps () const
+  {
+    return m_steps;
+  }
+
+  static Ptr<LinkSchedule> Load (const std::string &path, Time bin = MilliSeconds (100))
+  {
+    std::ifstream in (path.c_str ());
+    NS_ABORT_MSG_IF (!in, "Cannot read link schedule " << path);
+    std::string line;
+    while (std::getline (in, line))
+      {
+        std::istringstream iss (line.substr (0, line.find ('#')));
+        std::string first;
+        std::string second;
+        if (!(iss >> first))
+          {
+            continue;
+          }
+        in.clear ();
+        in.seekg (0);
+        if (iss >> second)
+          {
+            return LoadTimeRateDelay (in, path);
+          }
+        return LoadMahimahi (in, path, bin);
+      }
+    NS_FATAL_ERROR ("Link schedule " << path << " is empty");
+    return Ptr<LinkSchedule> ();
+  }
+
+  static Ptr<LinkSchedule> LoadTimeRateDelay (std::istream &in, const std::string &path)
+  {
+    Ptr<LinkSchedule> schedule = Create<LinkSchedule> ();
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline (in, line))
+      {
+        ++lineNumber;
+        std::istringstream iss (line.substr (0, line.find ('#')));
+        double time;
+        std::string rate;
+        std::string delay = "-";
+        if (!(iss >> time))
+          {
+            continue;
+          }
+        NS_ABORT_MSG_IF (!(iss >> rate), path << ":" << lineNumber << ": expected <time s> <rate> [<delay>]");
+        iss >> delay;
+        schedule->Add (Seconds (time), rate == "-" ? DataRate (0) : DataRate (rate),
+                       delay == "-" ? TimeStep (-1) : Time (delay));
+      }
+    return schedule;
+  }
+
+  static Ptr<LinkSchedule> LoadMahimahi (std::istream &in, const std::string &path, Time bin)
+  {
+    std::vector<uint32_t> counts;
+    uint64_t last = 0;
+    std::string line;
+    while (std::getline (in, line))
+      {
+        std::istringstream iss (line);
+        uint64_t ms;
+        if (!(iss >> ms))
+          {
+            continue;
+          }
+        NS_ABORT_MSG_IF (ms < last, path << ": Mahimahi timestamps have to be non-decreasing");
+        last = ms;
+        uint64_t b = MilliSeconds (ms).GetTimeStep () / bin.GetTimeStep ();
+        if (b >= counts.size ())
+          {
+            counts.resize (b + 1, 0);
+          }
+        ++counts[b];
+      }
+    NS_ABORT_MSG_IF (counts.empty (), "Link schedule " << path << " is empty");
+    NS_ABORT_MSG_IF (last == 0, "Link schedule " << path << " spans no time and cannot repeat");
+    Ptr<LinkSchedule> schedule = Create<LinkSchedule> ();
+    double binSeconds = bin.GetSeconds ();
+    for (uint32_t b = 0; b < counts.size (); ++b)
+      {
+        uint32_t packets = counts[b] ? counts[b] : 1;
+        schedule->Add (TimeStep (bin.GetTimeStep () * b),
+                       DataRate (static_cast<uint64_t> (std::llround (packets * 1500.0 * 8 / binSeconds))));
+      }
+    schedule->SetPeriod (MilliSeconds (last));
+    return schedule;
+  }
+
+private:
+  std::vector<Step> m_steps;
+  int64_t m_period;
+};
+
+// Replays LinkSchedules onto links: both devices of a point-to-point
+// channel, or a CSMA channel. Each link has one pending event at a time,
+// which applies its step and schedules the next one, so a long trace costs
+// one event per change and nothing up front.
+class LinkDynamics : public SimpleRefCount<LinkDynamics>
+{
+public:
+  // Starts replaying schedule on the link of device at start (the
+  // schedule's times are relative to it). No step is applied from end on,
+  // so a repeating schedule does not keep a run without Simulator::Stop
+  // going forever.
+  void Attach (Ptr<NetDevice> device, Ptr<LinkSchedule> schedule, Time start = Seconds (0),
+               Time end = Time::Max ())
+  {
+    Ptr<Channel> channel = device->GetChannel ();
+    NS_ABORT_MSG_IF (!channel, "Device of a link schedule is not attached to a channel");
+    Ptr<Player> player = Create<Player> ();
+    player->schedule = schedule;
+    if (Ptr<CsmaChannel> csma = DynamicCast<CsmaChannel> (channel))
+      {
+        player->csma = csma;
+      }
+    else
+      {
+        for (uint32_t i = 0; i < channel->GetNDevices (); ++i)
+          {
+            Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice> (channel->GetDevice (i));
+            NS_ABORT_MSG_IF (!p2p, "Link schedules need point-to-point or CSMA links");
+            player->p2p.push_back (p2p);
+          }
+        player->channel = channel;
+      }
+    player->base = start.GetTimeStep ();
+    player->end = end.GetTimeStep ();
+    m_players.push_back (player);
+    if (!schedule->GetSteps ().empty () && player->base + schedule->GetSteps ()[0].time < player->end)
+      {
+        Simulator::Schedule (TimeStep (player->base + schedule->GetSteps ()[0].time) - Simulator::Now (),
+                             &LinkDynamics::Next, player);
+      }
+  }
+
+  // Every link of devices once, even when both of its ends are listed.
+  void Attach (NetDeviceContainer devices, Ptr<LinkSchedule> schedule, Time start = Seconds (0),
+               Time end = Time::Max ())
+  {
+    std::set<uint32_t> channels;
+    for (uint32_t i = 0; i < devices.GetN (); ++i)
+      {
+        if (channels.insert (devices.Get (i)->GetChannel ()->GetId ()).second)
+          {
+            Attach (devices.Get (i), schedule, start, end);
+          }
+      }
+  }
+
+private:
+  struct Player : public SimpleRefCount<Player>
+  {
+    Player ()
+      : index (0),
+        base (0),
+        end (0)
+    {
+    }
+
+    Ptr<LinkSchedule> schedule;
+    std::vector<Ptr<PointToPointNetDevice> > p2p;
+    Ptr<Channel> channel;      // point-to-point
+    Ptr<CsmaChannel> csma;
+    size_t index;
+    int64_t base;              // time step the current period started at
+    int64_t end;               // time step from which nothing is applied
+  };
+
+  static void Next (Ptr<Player> player)
+  {
+    const std::vector<LinkSchedule::Step> &steps = player->schedule->GetSteps ();
+    const LinkSchedule::Step &step = steps[player->index];
+    if (step.bps)
+      {
+        DataRate rate (step.bps);
+        for (Ptr<PointToPointNetDevice> device : player->p2p)
+          {
+            device->SetDataRate (rate);
+          }
+        if (player->csma)
+          {
+            player->csma->SetAttribute ("DataRate", DataRateValue (rate));
+          }
+      }
+    if (step.delay >= 0)
+      {
+        Ptr<Channel> channel = player->csma ? Ptr<Channel> (player->csma) : player->channel;
+        channel->SetAttribute ("Delay", TimeValue (TimeStep (step.delay)));
+      }
+
+    if (++player->index == steps.size ())
+      {
+        int64_t period = player->schedule->GetPeriod ().GetTimeStep ();
+        if (period <= 0)
+          {
+            return;
+          }
+        player->index = 0;
+        player->base += period;
+      }
+    if (player->base + steps[player->index].time >= player->end)
+      {
+        return;
+      }
+    Simulator::Schedule (TimeStep (player->base + steps[player->index].time) - Simulator::Now (),
+                         &LinkDynamics::Next, player);
+  }
+
+  std::vector<Ptr<Player> > m_players;
+};
+
+} // namespace ns3
+
+#endif /* LINK_SCHEDULE_H */
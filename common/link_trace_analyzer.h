@@ -0,0 +1,435 @@
+#ifndef LINK_TRACE_ANALYZER_H
+#define LINK_TRACE_ANALYZER_H
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/csma-module.h"
+
+namespace ns3 {
+
+// Computes, while the simulation runs, what used to be extracted from the
+// EnableAsciiAll .tr files afterwards: per-flow received bytes and drops and
+// per-device queue occupancy, in fixed time buckets. It listens on the same
+// device trace sources the ASCII trace uses (TxQueue Enqueue/Dequeue/Drop,
+// MacRx, PhyRxDrop) of PointToPoint and CSMA devices.
+//
+// Write() produces one tab separated summary; the first column names the
+// record type:
+//   flow   <flow> <src> <sport> <dst> <dport> <proto>
+//   rx     <bucket start s> <flow> <bytes> <packets> <bps>
+//   drop   <bucket start s> <flow> <device> <queue drops> <phy drops>
+//   queue  <bucket start s> <device> <max packets> <mean packets> <max bytes>
+// Flow throughput counts frames received by the node that owns the flow's
+// destination address; transit hops are not counted twice.
+class LinkTraceAnalyzer : public SimpleRefCount<LinkTraceAnalyzer>
+{
+public:
+  LinkTraceAnalyzer (Time bucket = Seconds (0.1))
+    : m_bucket (bucket)
+  {
+    for (uint32_t i = 0; i < UID_CACHE_SIZE; ++i)
+      {
+        m_uidCache[i].uid = ~0ull;
+        m_uidCache[i].flow = NO_FLOW;
+      }
+  }
+
+  void Attach (Ptr<NetDevice> device)
+  {
+    Ptr<Queue<Packet> > queue;
+    bool ppp = false;
+    if (Ptr<PointToPointNetDevice> p2p = DynamicCast<PointToPointNetDevice> (device))
+      {
+        queue = p2p->GetQueue ();
+        ppp = true;
+      }
+    else if (Ptr<CsmaNetDevice> csma = DynamicCast<CsmaNetDevice> (device))
+      {
+        queue = csma->GetQueue ();
+      }
+    else
+      {
+        NS_FATAL_ERROR ("LinkTraceAnalyzer supports PointToPoint and CSMA devices only");
+      }
+
+    uint32_t index = m_devices.size ();
+    DeviceState state;
+    std::ostringstream oss;
+    oss << "n" << device->GetNode ()->GetId () << "/" << device->GetIfIndex ();
+    state.name = oss.str ();
+    state.node = device->GetNode ();
+    state.ppp = ppp;
+    state.packets = 0;
+    state.bytes = 0;
+    state.lastChange = Simulator::Now ();
+    m_devices.push_back (state);
+
+    Ptr<DeviceTracer> tracer = Create<DeviceTracer> (this, index);
+    m_tracers.push_back (tracer);
+    queue->TraceConnectWithoutContext ("Enqueue", MakeCallback (&DeviceTracer::Enqueue, tracer));
+    queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&DeviceTracer::Dequeue, tracer));
+    queue->TraceConnectWithoutContext ("Drop", MakeCallback (&DeviceTracer::QueueDrop, tracer));
+    device->TraceConnectWithoutContext ("MacRx", MakeCallback (&DeviceTracer::Rx, tracer));
+    device->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&DeviceTracer::PhyDrop, tracer));
+  }
+
+  void Attach (NetDeviceContainer devices)
+  {
+    for (uint32_t i = 0; i < devices.GetN (); ++i)
+      {
+        Attach (devices.Get (i));
+      }
+  }
+
+  // Writes the summary; call after Simulator::Run.
+  bool Write (const std::string &path)
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    double width = m_bucket.GetSeconds ();
+    for (uint32_t f = 0; f < m_flows.size (); ++f)
+      {
+        const FlowKey &k = m_flows[f].key;
+        out << "flow\t" << f << "\t" << Ipv4Address (k.src) << "\t" << k.sport
+            << "\t" << Ipv4Address (k.dst) << "\t" << k.dport << "\t" << uint32_t (k.proto) << "\n";
+      }
+    for (uint32_t f = 0; f < m_flows.size (); ++f)
+      {
+        const std::vector<FlowBucket> &buckets = m_flows[f].buckets;
+        for (uint32_t b = 0; b < buckets.size (); ++b)
+          {
+            if (buckets[b].rxPackets)
+              {
+                out << "rx\t" << b * width << "\t" << f << "\t" << buckets[b].rxBytes
+                    << "\t" << buckets[b].rxPackets << "\t" << buckets[b].rxBytes * 8 / width << "\n";
+              }
+          }
+      }
+    for (std::map<DropKey, DropCount>::const_iterator it = m_drops.begin (); it != m_drops.end (); ++it)
+      {
+        out << "drop\t" << it->first.bucket * width << "\t";
+        if (it->first.flow == NO_FLOW)
+          {
+            out << "-";
+          }
+        else
+          {
+            out << it->first.flow;
+          }
+        out << "\t" << m_devices[it->first.device].name << "\t" << it->second.queue
+            << "\t" << it->second.phy << "\n";
+      }
+    for (uint32_t d = 0; d < m_devices.size (); ++d)
+      {
+        DeviceState &dev = m_devices[d];
+        CloseQueueInterval (dev, Simulator::Now ());
+        for (uint32_t b = 0; b < dev.buckets.size (); ++b)
+          {
+            const QueueBucket &q = dev.buckets[b];
+            if (q.maxPackets == 0 && q.packetSeconds == 0)
+              {
+                continue;
+              }
+            out << "queue\t" << b * width << "\t" << dev.name << "\t" << q.maxPackets
+                << "\t" << q.packetSeconds / width << "\t" << q.maxBytes << "\n";
+          }
+      }
+    return true;
+  }
+
+private:
+  static const uint32_t NO_FLOW = 0xffffffff;
+  static const uint32_t UID_CACHE_SIZE = 4096;
+
+  struct FlowKey
+  {
+    uint32_t src;
+    uint32_t dst;
+    uint16_t sport;
+    uint16_t dport;
+    uint8_t proto;
+
+    bool operator< (const FlowKey &o) const
+    {
+      if (src != o.src) return src < o.src;
+      if (dst != o.dst) return dst < o.dst;
+      if (sport != o.sport) return sport < o.sport;
+      if (dport != o.dport) return dport < o.dport;
+      return proto < o.proto;
+    }
+  };
+
+  struct FlowBucket
+  {
+    uint64_t rxBytes;
+    uint32_t rxPackets;
+  };
+
+  struct FlowState
+  {
+    FlowKey key;
+    std::vector<FlowBucket> buckets;
+    std::vector<int8_t> deliversTo;  // per device: 0 unknown, -1 transit, 1 destination node
+  };
+
+  struct QueueBucket
+  {
+    uint32_t maxPackets;
+    uint32_t maxBytes;
+    double packetSeconds;            // integral of queue length over time
+  };
+
+  struct DeviceState
+  {
+    std::string name;
+    Ptr<Node> node;
+    bool ppp;
+    uint32_t packets;
+    uint32_t bytes;
+    Time lastChange;
+    std::vector<QueueBucket> buckets;
+  };
+
+  struct DropKey
+  {
+    uint32_t bucket;
+    uint32_t flow;
+    uint32_t device;
+
+    bool operator< (const DropKey &o) const
+    {
+      if (bucket != o.bucket) return bucket < o.bucket;
+      if (flow != o.flow) return flow < o.flow;
+      return device < o.device;
+    }
+  };
+
+  struct DropCount
+  {
+    uint64_t queue;
+    uint64_t phy;
+  };
+
+  struct UidCacheEntry
+  {
+    uint64_t uid;
+    uint32_t flow;
+  };
+
+  class DeviceTracer : public SimpleRefCount<DeviceTracer>
+  {
+  public:
+    DeviceTracer (LinkTraceAnalyzer *analyzer, uint32_t device)
+      : m_analyzer (analyzer),
+        m_device (device)
+    {
+    }
+
+    void Enqueue (Ptr<const Packet> p)
+    {
+      m_analyzer->QueueChange (m_device, p, 1);
+    }
+    void Dequeue (Ptr<const Packet> p)
+    {
+      m_analyzer->QueueChange (m_device, p, -1);
+    }
+    void QueueDrop (Ptr<const Packet> p)
+    {
+      m_analyzer->Drop (m_device, p, true);
+    }
+    void PhyDrop (Ptr<const Packet> p)
+    {
+      m_analyzer->Drop (m_device, p, false);
+    }
+    void Rx (Ptr<const Packet> p)
+    {
+      m_analyzer->Receive (m_device, p);
+    }
+
+  private:
+    LinkTraceAnalyzer *m_analyzer;
+    uint32_t m_device;
+  };
+
+  uint32_t BucketIndex (Time t) const
+  {
+    return static_cast<uint32_t> (t.GetTimeStep () / m_bucket.GetTimeStep ());
+  }
+
+  template <typename T>
+  static T &At (std::vector<T> &v, uint32_t i)
+  {
+    if (i >= v.size ())
+      {
+        v.resize (i + 1, T ());
+      }
+    return v[i];
+  }
+
+  // Maps a link-layer frame to a flow index, NO_FLOW for non IPv4 frames.
+  // The packet uid survives forwarding, so most lookups hit the cache and
+  // skip the header parsing.
+  uint32_t Classify (uint32_t device, Ptr<const Packet> frame)
+  {
+    uint64_t uid = frame->GetUid ();
+    UidCacheEntry &entry = m_uidCache[uid % UID_CACHE_SIZE];
+    if (entry.uid == uid)
+      {
+        return entry.flow;
+      }
+
+    Ptr<Packet> p = frame->Copy ();
+    bool ipv4 = false;
+    if (m_devices[device].ppp)
+      {
+        PppHeader ppp;
+        p->RemoveHeader (ppp);
+        ipv4 = (ppp.GetProtocol () == 0x0021);
+      }
+    else
+      {
+        EthernetHeader eth (false);
+        p->RemoveHeader (eth);
+        ipv4 = (eth.GetLengthType () == 0x0800);
+      }
+
+    uint32_t flow = NO_FLOW;
+    if (ipv4)
+      {
+        Ipv4Header ip;
+        p->RemoveHeader (ip);
+        FlowKey key;
+        key.src = ip.GetSource ().Get ();
+        key.dst = ip.GetDestination ().Get ();
+        key.proto = ip.GetProtocol ();
+        key.sport = 0;
+        key.dport = 0;
+        if (key.proto == 6 && ip.GetFragmentOffset () == 0)
+          {
+            TcpHeader tcp;
+            p->PeekHeader (tcp);
+            key.sport = tcp.GetSourcePort ();
+            key.dport = tcp.GetDestinationPort ();
+          }
+        else if (key.proto == 17 && ip.GetFragmentOffset () == 0)
+          {
+            UdpHeader udp;
+            p->PeekHeader (udp);
+            key.sport = udp.GetSourcePort ();
+            key.dport = udp.GetDestinationPort ();
+          }
+        std::map<FlowKey, uint32_t>::iterator it = m_flowIndex.find (key);
+        if (it == m_flowIndex.end ())
+          {
+            flow = m_flows.size ();
+            m_flowIndex[key] = flow;
+            FlowState state;
+            state.key = key;
+            m_flows.push_back (state);
+          }
+        else
+          {
+            flow = it->second;
+          }
+      }
+    entry.uid = uid;
+    entry.flow = flow;
+    return flow;
+  }
+
+  void CloseQueueInterval (DeviceState &dev, Time now)
+  {
+    // Spread the time the queue spent at its current length over the
+    // buckets it covers.
+    Time t = dev.lastChange;
+    while (t < now)
+      {
+        uint32_t b = BucketIndex (t);
+        Time end = std::min (now, TimeStep (m_bucket.GetTimeStep () * (b + 1)));
+        At (dev.buckets, b).packetSeconds += dev.packets * (end - t).GetSeconds ();
+        t = end;
+      }
+    dev.lastChange = now;
+  }
+
+  void QueueChange (uint32_t device, Ptr<const Packet> p, int delta)
+  {
+    DeviceState &dev = m_devices[device];
+    Time now = Simulator::Now ();
+    CloseQueueInterval (dev, now);
+    if (delta > 0)
+      {
+        dev.packets++;
+        dev.bytes += p->GetSize ();
+      }
+    else if (dev.packets)
+      {
+        dev.packets--;
+        dev.bytes -= std::min (dev.bytes, p->GetSize ());
+      }
+    QueueBucket &q = At (dev.buckets, BucketIndex (now));
+    q.maxPackets = std::max (q.maxPackets, dev.packets);
+    q.maxBytes = std::max (q.maxBytes, dev.bytes);
+  }
+
+  void Drop (uint32_t device, Ptr<const Packet> p, bool queue)
+  {
+    DropKey key;
+    key.bucket = BucketIndex (Simulator::Now ());
+    key.flow = Classify (device, p);
+    key.device = device;
+    DropCount &count = m_drops[key];
+    if (queue)
+      {
+        count.queue++;
+      }
+    else
+      {
+        count.phy++;
+      }
+  }
+
+  void Receive (uint32_t device, Ptr<const Packet> p)
+  {
+    uint32_t flow = Classify (device, p);
+    if (flow == NO_FLOW)
+      {
+        return;
+      }
+    FlowState &state = m_flows[flow];
+    int8_t &delivers = At (state.deliversTo, device);
+    if (delivers == 0)
+      {
+        Ptr<Ipv4> ipv4 = m_devices[device].node->GetObject<Ipv4> ();
+        delivers = (ipv4 && ipv4->GetInterfaceForAddress (Ipv4Address (state.key.dst)) >= 0) ? 1 : -1;
+      }
+    if (delivers == 1)
+      {
+        FlowBucket &b = At (state.buckets, BucketIndex (Simulator::Now ()));
+        b.rxBytes += p->GetSize ();
+        b.rxPackets++;
+      }
+  }
+
+  Time m_bucket;
+  std::vector<DeviceState> m_devices;
+  std::vector<Ptr<DeviceTracer> > m_tracers;
+  std::vector<FlowState> m_flows;
+  std::map<FlowKey, uint32_t> m_flowIndex;
+  std::map<DropKey, DropCount> m_drops;
+  UidCacheEntry m_uidCache[UID_CACHE_SIZE];
+};
+
+} // namespace ns3
+
+#endif /* LINK_TRACE_ANALYZER_H */
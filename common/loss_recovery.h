@@ -0,0 +1,320 @@
+#ifndef LOSS_RECOVERY_H
+#define LOSS_RECOVERY_H
+
+#include <fstream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+// Counts and logs the loss recovery events of TCP senders, from the
+// sockets' state machine and segment traces:
+//
+//   fast_retransmit  entry into CA_RECOVERY; sack_recovery counts the
+//                    ones on a socket with SACK enabled
+//   rto              entry into CA_LOSS (retransmission timeout; timeouts
+//                    backed off while still in CA_LOSS count once)
+//   spurious         a retransmitted segment acknowledged less than half
+//                    the minimum RTT after it was sent, so the ACK was for
+//                    the original (Eifel style; no D-SACK in ns-3)
+//   retx_segments    data segments sent again below the highest sequence
+//                    number already sent, and their bytes
+//   zero_window      the peer's advertised window dropping to zero, and
+//                    the time spent there
+//
+// Each event is also logged with its time, so a throughput collapse can be
+// matched to the recovery behind it.
+class LossRecoveryMonitor : public SimpleRefCount<LossRecoveryMonitor>
+{
+public:
+  // Connects socket as the next flow (flows are numbered in Connect
+  // order). The socket has to exist already.
+  void Connect (Ptr<Socket> socket)
+  {
+    Ptr<FlowRecovery> flow = Create<FlowRecovery> (this, m_flows.size ());
+    BooleanValue sack;
+    flow->sack = socket->GetAttributeFailSafe ("Sack", sack) && sack.Get ();
+    m_flows.push_back (flow);
+    socket->TraceConnectWithoutContext ("CongState", MakeCallback (&FlowRecovery::CongState, flow));
+    socket->TraceConnectWithoutContext ("Tx", MakeCallback (&FlowRecovery::Tx, flow));
+    socket->TraceConnectWithoutContext ("Rx", MakeCallback (&FlowRecovery::Rx, flow));
+    socket->TraceConnectWithoutContext ("RTT", MakeCallback (&FlowRecovery::Rtt, flow));
+    socket->TraceConnectWithoutContext ("RWND", MakeCallback (&FlowRecovery::Rwnd, flow));
+  }
+
+  // One line per flow:
+  //   flow fast_retransmit sack_recovery rto spurious retx_segments
+  //   retx_bytes zero_window zero_window_s
+  bool WriteSummary (const std::string &path) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    out << "flow\tfast_retransmit\tsack_recovery\trto\tspurious\tretx_segments\tretx_bytes\tzero_window\tzero_window_s\n";
+    for (Ptr<FlowRecovery> flow : m_flows)
+      {
+        out << flow->id << "\t" << flow->fastRetransmits << "\t" << flow->sackRecoveries << "\t" << flow->rtos
+            << "\t" << flow->spurious << "\t" << flow->retxSegments << "\t" << flow->retxBytes << "\t"
+            << flow->zeroWindows << "\t" << flow->ZeroWindowTime ().GetSeconds () << "\n";
+      }
+    return true;
+  }
+
+  // "time flow event value" lines; value is the sequence number of
+  // retransmissions and spurious ones, the duration of zero window stalls
+  // (logged when they end) and empty otherwise.
+  bool WriteEvents (const std::string &path) const
+  {
+    std::ofstream out (path.c_str ());
+    if (!out)
+      {
+        return false;
+      }
+    out << "time\tflow\tevent\tvalue\n";
+    for (const Event &event : m_events)
+      {
+        out << event.time << "\t" << event.flow << "\t" << EventName (event.kind) << "\t";
+        if (event.kind == EVENT_ZERO_WINDOW_END)
+          {
+            out << event.value / 1e9;
+          }
+        else if (event.kind == EVENT_RETRANSMIT || event.kind == EVENT_SPURIOUS)
+          {
+            out << event.value;
+          }
+        out << "\n";
+      }
+    return true;
+  }
+
+  // Adds the totals over all flows to a run metrics file
+  // (common/run_metrics.h), so the replication tools aggregate them too.
+  bool AppendMetrics (const std::string &path) const
+  {
+    std::ofstream out (path.c_str (), std::ios::app);
+    if (!out)
+      {
+        return false;
+      }
+    uint64_t fastRetransmits = 0;
+    uint64_t sackRecoveries = 0;
+    uint64_t rtos = 0;
+    uint64_t spurious = 0;
+    uint64_t retxSegments = 0;
+    uint64_t zeroWindows = 0;
+    double zeroWindowSeconds = 0;
+    for (Ptr<FlowRecovery> flow : m_flows)
+      {
+        fastRetransmits += flow->fastRetransmits;
+        sackRecoveries += flow->sackRecoveries;
+        rtos += flow->rtos;
+        spurious += flow->spurious;
+        retxSegments += flow->retxSegments;
+        zeroWindows += flow->zeroWindows;
+        zeroWindowSeconds += flow->ZeroWindowTime ().GetSeconds ();
+      }
+    out << "fast_retransmits\t" << fastRetransmits << "\n";
+    out << "sack_recoveries\t" << sackRecoveries << "\n";
+    out << "rto_expirations\t" << rtos << "\n";
+    out << "spurious_retransmits\t" << spurious << "\n";
+    out << "retx_segments\t" << retxSegments << "\n";
+    out << "zero_window_stalls\t" << zeroWindows << "\n";
+    out << "zero_window_s\t" << zeroWindowSeconds << "\n";
+    return true;
+  }
+
+private:
+  enum EventKind
+  {
+    EVENT_FAST_RETRANSMIT,
+    EVENT_RTO,
+    EVENT_RETRANSMIT,
+    EVENT_SPURIOUS,
+    EVENT_ZERO_WINDOW_START,
+    EVENT_ZERO_WINDOW_END,
+  };
+
+  struct Event
+  {
+    double time;
+    uint32_t flow;
+    EventKind kind;
+    uint64_t value;
+  };
+
+  static const char *EventName (EventKind kind)
+  {
+    switch (kind)
+      {
+      case EVENT_FAST_RETRANSMIT:
+        return "fast_retransmit";
+      case EVENT_RTO:
+        return "rto";
+      case EVENT_RETRANSMIT:
+        return "retransmit";
+      case EVENT_SPURIOUS:
+        return "spurious";
+      case EVENT_ZERO_WINDOW_START:
+        return "zero_window";
+      case EVENT_ZERO_WINDOW_END:
+        return "zero_window_end";
+      }
+    return "?";
+  }
+
+  void Log (uint32_t flow, EventKind kind, uint64_t value = 0)
+  {
+    Event event;
+    event.time = Simulator::Now ().GetSeconds ();
+    event.flow = flow;
+    event.kind = kind;
+    event.value = value;
+    m_events.push_back (event);
+  }
+
+  struct FlowRecovery : public SimpleRefCount<FlowRecovery>
+  {
+    FlowRecovery (LossRecoveryMonitor *m, uint32_t i)
+      : monitor (m),
+        id (i),
+        sack (false),
+        fastRetransmits (0),
+        sackRecoveries (0),
+        rtos (0),
+        spurious (0),
+        retxSegments (0),
+        retxBytes (0),
+        zeroWindows (0),
+        highTx (0),
+        anyTx (false),
+        zeroWindow (false)
+    {
+    }
+
+    void CongState (TcpSocketState::TcpCongState_t oldState, TcpSocketState::TcpCongState_t newState)
+    {
+      if (newState == TcpSocketState::CA_RECOVERY && oldState != TcpSocketState::CA_RECOVERY)
+        {
+          ++fastRetransmits;
+          sackRecoveries += sack;
+          monitor->Log (id, EVENT_FAST_RETRANSMIT);
+        }
+      else if (newState == TcpSocketState::CA_LOSS)
+        {
+          ++rtos;
+          monitor->Log (id, EVENT_RTO);
+        }
+    }
+
+    void Tx (Ptr<const Packet> packet, const TcpHeader &header, Ptr<const TcpSocketBase> socket)
+    {
+      uint32_t size = packet->GetSize ();
+      if (size == 0)
+        {
+          return;
+        }
+      SequenceNumber32 seq = header.GetSequenceNumber ();
+      SequenceNumber32 end = seq + size;
+      if (anyTx && seq < highTx)
+        {
+          ++retxSegments;
+          retxBytes += size;
+          retransmitted.push_back (std::make_pair (end, Simulator::Now ()));
+          monitor->Log (id, EVENT_RETRANSMIT, seq.GetValue ());
+        }
+      if (!anyTx || end > highTx)
+        {
+          highTx = end;
+          anyTx = true;
+        }
+    }
+
+    // An ACK covering a retransmission that comes back well within one RTT
+    // of it acknowledges the original segment.
+    void Rx (Ptr<const Packet> packet, const TcpHeader &header, Ptr<const TcpSocketBase> socket)
+    {
+      if (!(header.GetFlags () & TcpHeader::ACK) || retransmitted.empty ())
+        {
+          return;
+        }
+      SequenceNumber32 ack = header.GetAckNumber ();
+      Time now = Simulator::Now ();
+      size_t kept = 0;
+      for (size_t i = 0; i < retransmitted.size (); ++i)
+        {
+          if (ack < retransmitted[i].first)
+            {
+              retransmitted[kept++] = retransmitted[i];
+              continue;
+            }
+          if (minRtt.IsStrictlyPositive () && now - retransmitted[i].second < minRtt / 2)
+            {
+              ++spurious;
+              monitor->Log (id, EVENT_SPURIOUS, retransmitted[i].first.GetValue ());
+            }
+        }
+      retransmitted.resize (kept);
+    }
+
+    void Rtt (Time oldValue, Time newValue)
+    {
+      if (newValue.IsStrictlyPositive () && (minRtt.IsZero () || newValue < minRtt))
+        {
+          minRtt = newValue;
+        }
+    }
+
+    void Rwnd (uint32_t oldValue, uint32_t newValue)
+    {
+      if (newValue == 0 && !zeroWindow && anyTx)
+        {
+          zeroWindow = true;
+          zeroWindowStart = Simulator::Now ();
+          ++zeroWindows;
+          monitor->Log (id, EVENT_ZERO_WINDOW_START);
+        }
+      else if (newValue > 0 && zeroWindow)
+        {
+          zeroWindow = false;
+          Time stalled = Simulator::Now () - zeroWindowStart;
+          zeroWindowTime += stalled;
+          monitor->Log (id, EVENT_ZERO_WINDOW_END, stalled.GetNanoSeconds ());
+        }
+    }
+
+    // Including a stall still running at the end.
+    Time ZeroWindowTime () const
+    {
+      return zeroWindow ? zeroWindowTime + Simulator::Now () - zeroWindowStart : zeroWindowTime;
+    }
+
+    LossRecoveryMonitor *monitor;
+    uint32_t id;
+    bool sack;
+    uint64_t fastRetransmits;
+    uint64_t sackRecoveries;
+    uint64_t rtos;
+    uint64_t spurious;
+    uint64_t retxSegments;
+    uint64_t retxBytes;
+    uint64_t zeroWindows;
+    SequenceNumber32 highTx;   // end of the highest data sent
+    bool anyTx;
+    std::vector<std::pair<SequenceNumber32, Time> > retransmitted;   // end, time sent
+    Time minRtt;
+    bool zeroWindow;
+    Time zeroWindowStart;
+    Time zeroWindowTime;
+  };
+
+  std::vector<Ptr<FlowRecovery> > m_flows;
+  std::vector<Event> m_events;
+};
+
+} // namespace ns3
+
+#endif /* LOSS_RECOVERY_H */
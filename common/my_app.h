@@ -0,0 +1,163 @@
+#ifndef MY_APP_H
+#define MY_APP_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+namespace ns3 {
+
+// Sends nPackets of packetSize bytes over a connected socket at a fixed
+// rate. This is the tutorial "MyApp" the scenario programs share.
+//
+// Per packet it only copies a preallocated template packet (the payload
+// buffer is shared copy-on-write) and re-inserts one long-lived event
+// object into the scheduler, so no event functor or zero-filled buffer is
+// allocated per send.
+class MyApp : public Application
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::MyApp")
+      .SetParent<Application> ()
+      .SetGroupName ("Applications")
+      .AddConstructor<MyApp> ()
+      ;
+    return tid;
+  }
+
+  MyApp ();
+  virtual ~MyApp ();
+
+  void Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint32_t nPackets, DataRate dataRate);
+
+  uint32_t GetPacketsSent (void) const
+  {
+    return m_packetsSent;
+  }
+
+private:
+  // The send event. It is scheduled again from inside its own Notify, so
+  // the scheduler holds at most one reference to it at any time.
+  class SendEvent : public EventImpl
+  {
+  public:
+    SendEvent (MyApp *app)
+      : m_app (app)
+    {
+    }
+
+  private:
+    virtual void Notify (void)
+    {
+      m_app->SendPacket ();
+    }
+
+    MyApp *m_app;
+  };
+
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  void ScheduleTx (void);
+  void SendPacket (void);
+
+  Ptr<Socket>     m_socket;
+  Address         m_peer;
+  uint32_t        m_packetSize;
+  uint32_t        m_nPackets;
+  DataRate        m_dataRate;
+  Time            m_interval;
+  Ptr<Packet>     m_template;
+  Ptr<EventImpl>  m_sendImpl;
+  EventId         m_sendEvent;
+  bool            m_running;
+  uint32_t        m_packetsSent;
+};
+
+inline
+MyApp::MyApp ()
+  : m_socket (0),
+    m_peer (),
+    m_packetSize (0),
+    m_nPackets (0),
+    m_dataRate (0),
+    m_interval (),
+    m_template (0),
+    m_sendImpl (0),
+    m_sendEvent (),
+    m_running (false),
+    m_packetsSent (0)
+{
+}
+
+inline
+MyApp::~MyApp ()
+{
+  m_socket = 0;
+}
+
+inline void
+MyApp::Setup (Ptr<Socket> socket, Address address, uint32_t packetSize, uint32_t nPackets, DataRate dataRate)
+{
+  m_socket = socket;
+  m_peer = address;
+  m_packetSize = packetSize;
+  m_nPackets = nPackets;
+  m_dataRate = dataRate;
+  m_interval = Seconds (m_packetSize * 8 / static_cast<double> (m_dataRate.GetBitRate ()));
+  m_template = Create<Packet> (m_packetSize);
+}
+
+inline void
+MyApp::StartApplication (void)
+{
+  m_running = true;
+  m_packetsSent = 0;
+  // A cancelled EventImpl stays cancelled, so every start gets a fresh one.
+  m_sendImpl = Create<SendEvent> (this);
+  m_socket->Bind ();
+  m_socket->Connect (m_peer);
+  SendPacket ();
+}
+
+inline void
+MyApp::StopApplication (void)
+{
+  m_running = false;
+
+  if (m_sendEvent.IsRunning ())
+    {
+      Simulator::Cancel (m_sendEvent);
+    }
+  m_sendImpl = 0;
+
+  if (m_socket)
+    {
+      m_socket->Close ();
+    }
+}
+
+inline void
+MyApp::SendPacket (void)
+{
+  m_socket->Send (m_template->Copy ());
+
+  if (++m_packetsSent < m_nPackets)
+    {
+      ScheduleTx ();
+    }
+}
+
+inline void
+MyApp::ScheduleTx (void)
+{
+  if (m_running)
+    {
+      m_sendEvent = Simulator::Schedule (m_interval, m_sendImpl);
+    }
+}
+
+} // namespace ns3
+
+#endif /* MY_APP_H */
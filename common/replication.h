@@ -0,0 +1,77 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include "ns3/core-module.h"
+
+namespace ns3 {
+
+// Independent random number streams per random element of a scenario.
+// Each element gets its own block, so adding nodes or devices to one
+// element never shifts the streams of another one, and a given
+// (--seed, --run) pair always reproduces the same replication. The
+// stack alone takes several streams per node, so the blocks are far
+// apart; AssignStreamBlock checks that a helper stayed inside its block.
+static constexpr int64_t STREAM_BLOCK_SIZE = int64_t (1) << 20;
+
+enum RngStreamBase
+{
+  STREAM_STACK = 0,                             // InternetStackHelper (ARP jitter, TCP ISN, ...)
+  STREAM_ERROR_MODEL = 1 * STREAM_BLOCK_SIZE,   // receive error models
+  STREAM_FAILURES = 2 * STREAM_BLOCK_SIZE,      // failure injection
+  STREAM_APPS = 3 * STREAM_BLOCK_SIZE,          // OnOff on/off times and the like
+  STREAM_CHANNEL = 4 * STREAM_BLOCK_SIZE,       // CSMA backoff
+  STREAM_QUEUE = 5 * STREAM_BLOCK_SIZE,         // RED/PIE drop decisions
+};
+
+// Takes the number of streams an AssignStreams call starting at base
+// used, and aborts if they ran into the next block.
+inline int64_t
+AssignStreamBlock (RngStreamBase base, int64_t used)
+{
+  NS_ABORT_MSG_IF (used > STREAM_BLOCK_SIZE,
+                   "Random streams from " << int64_t (base) << " need " << used << ", more than their block");
+  return used;
+}
+
+// --seed and --run for RngSeedManager. Replications of one configuration
+// share the seed and differ in the run number (tools/replicate.cc).
+class ReplicationOptions
+{
+public:
+  ReplicationOptions ()
+    : m_seed (1),
+      m_run (1)
+  {
+  }
+
+  void AddCommandLineOptions (CommandLine &cmd)
+  {
+    cmd.AddValue ("seed", "RNG seed shared by the replications of a configuration", m_seed);
+    cmd.AddValue ("run", "Replication number (RNG substream)", m_run);
+  }
+
+  // Call after CommandLine::Parse and before any random variable is used.
+  void Apply () const
+  {
+    RngSeedManager::SetSeed (m_seed);
+    RngSeedManager::SetRun (m_run);
+  }
+
+  uint32_t GetSeed () const
+  {
+    return m_seed;
+  }
+
+  uint64_t GetRun () const
+  {
+    return m_run;
+  }
+
+private:
+  uint32_t m_seed;
+  uint64_t m_run;
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_H */
@@ -0,0 +1,186 @@
+#ifndef RING_FILE_WRITER_H
+#define RING_FILE_WRITER_H
+
+// Appends fixed-size records to a preallocated in-memory ring and writes
+// full blocks of the ring to a file from a background thread. The
+// simulation thread only copies the record into the ring; formatting and
+// I/O happen off the event loop. If the writer falls behind by the whole
+// ring, Append waits for a block to drain rather than dropping records.
+// A failed write (disk full, ...) stops the writing, and Close reports it.
+//
+// No ns-3 dependency.
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+template <typename Record>
+class RingFileWriter
+{
+public:
+  // blockRecords records per block, nBlocks blocks in the ring.
+  RingFileWriter (uint32_t blockRecords = 16384, uint32_t nBlocks = 8)
+    : m_file (0),
+      m_blockRecords (blockRecords ? blockRecords : 1),
+      m_nBlocks (nBlocks > 1 ? nBlocks : 2),
+      m_current (0),
+      m_used (0),
+      m_stop (false),
+      m_failed (false),
+      m_written (0)
+  {
+  }
+
+  ~RingFileWriter ()
+  {
+    Close ();
+  }
+
+  // Opens path and writes headerSize bytes of header before the records.
+  bool Open (const std::string &path, const void *header, size_t headerSize)
+  {
+    Close ();
+    m_file = std::fopen (path.c_str (), "wb");
+    if (!m_file)
+      {
+        return false;
+      }
+    if (headerSize && std::fwrite (header, 1, headerSize, m_file) != headerSize)
+      {
+        std::fclose (m_file);
+        m_file = 0;
+        return false;
+      }
+    m_ring.assign (static_cast<size_t> (m_blockRecords) * m_nBlocks, Record ());
+    m_busy.assign (m_nBlocks, false);
+    m_current = 0;
+    m_used = 0;
+    m_stop = false;
+    m_failed = false;
+    m_written = 0;
+    m_thread = std::thread (&RingFileWriter::WriterLoop, this);
+    return true;
+  }
+
+  bool IsOpen () const
+  {
+    return m_file != 0;
+  }
+
+  void Append (const Record &record)
+  {
+    m_ring[static_cast<size_t> (m_current) * m_blockRecords + m_used] = record;
+    if (++m_used == m_blockRecords)
+      {
+        Submit (m_used);
+      }
+  }
+
+  // Writes everything appended so far and closes the file. False when a
+  // record could not be written, flushed or closed; the file is then
+  // incomplete.
+  bool Close ()
+  {
+    if (!m_file)
+      {
+        return true;
+      }
+    if (m_used)
+      {
+        Submit (m_used);
+      }
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_stop = true;
+    }
+    m_ready.notify_one ();
+    m_thread.join ();
+    bool ok = std::fclose (m_file) == 0 && !m_failed;
+    m_file = 0;
+    std::vector<Record> ().swap (m_ring);
+    return ok;
+  }
+
+  uint64_t GetRecordsWritten () const
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    return m_written;
+  }
+
+private:
+  struct Pending
+  {
+    uint32_t block;
+    uint32_t count;
+  };
+
+  // Hands the current block to the writer thread and moves to the next
+  // one, waiting if that one has not been written out yet.
+  void Submit (uint32_t count)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    m_busy[m_current] = true;
+    m_queue.push_back (Pending { m_current, count });
+    m_ready.notify_one ();
+    m_current = (m_current + 1) % m_nBlocks;
+    m_used = 0;
+    m_free.wait (lock, [this] { return !m_busy[m_current]; });
+  }
+
+  void WriterLoop ()
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    while (true)
+      {
+        m_ready.wait (lock, [this] { return m_stop || !m_queue.empty (); });
+        if (m_queue.empty ())
+          {
+            break;
+          }
+        Pending pending = m_queue.front ();
+        m_queue.pop_front ();
+        lock.unlock ();
+        const Record *data = &m_ring[static_cast<size_t> (pending.block) * m_blockRecords];
+        // Only this thread sets m_failed while it runs.
+        bool written = !m_failed && std::fwrite (data, sizeof (Record), pending.count, m_file) == pending.count;
+        lock.lock ();
+        if (written)
+          {
+            m_written += pending.count;
+          }
+        else
+          {
+            m_failed = true;
+          }
+        m_busy[pending.block] = false;
+        m_free.notify_one ();
+      }
+    if (std::fflush (m_file) != 0)
+      {
+        m_failed = true;
+      }
+  }
+
+  std::FILE *m_file;
+  uint32_t m_blockRecords;
+  uint32_t m_nBlocks;
+  std::vector<Record> m_ring;
+  std::vector<bool> m_busy;       // block handed to the writer, guarded by m_mutex
+  uint32_t m_current;             // block being filled, simulation thread only
+  uint32_t m_used;                // records in the current block
+  std::deque<Pending> m_queue;    // guarded by m_mutex
+  bool m_stop;                    // guarded by m_mutex
+  bool m_failed;                  // a write failed, guarded by m_mutex
+  uint64_t m_written;             // guarded by m_mutex
+  mutable std::mutex m_mutex;
+  std::condition_variable m_ready;
+  std::condition_variable m_free;
+  std::thread m_thread;
+};
+
+#endif /* RING_FILE_WRITER_H */
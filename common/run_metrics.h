@@ -0,0 +1,93 @@
+#ifndef RUN_METRICS_H
+#define RUN_METRICS_H
+
+#include <fstream>
+#include <functional>
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "replication.h"
+
+namespace ns3 {
+
+// Writes the per-run numbers the replication tools aggregate, one
+// "<metric>\t<value>" line each, from the FlowMonitor flows that end at
+// sinkPort (or one of the nPorts ports from it, for one sink per flow):
+//   throughput_mbps  received bytes over first transmission to last reception
+//   delay_ms         mean one-way packet delay
+//   loss_ratio       lost / transmitted packets
+//   rx_bytes, flows, seed, run
+//   events           simulator events run so far
+//   sim_s            simulated time reached, in seconds
+//
+// findFlow gives the five tuple of a flow id, so other monitors with
+// FlowMonitor style statistics (common/endpoint_flow_monitor.h) share it.
+inline bool
+WriteRunMetrics (const std::string &path, const FlowMonitor::FlowStatsContainer &stats,
+                 std::function<Ipv4FlowClassifier::FiveTuple (FlowId)> findFlow, uint16_t sinkPort,
+                 const ReplicationOptions &replication, uint16_t nPorts = 1)
+{
+  uint64_t rxBytes = 0;
+  uint64_t rxPackets = 0;
+  uint64_t txPackets = 0;
+  uint64_t lostPackets = 0;
+  uint32_t flows = 0;
+  Time delaySum;
+  Time firstTx = Time::Max ();
+  Time lastRx;
+
+  for (FlowMonitor::FlowStatsContainer::const_iterator it = stats.begin (); it != stats.end (); ++it)
+    {
+      Ipv4FlowClassifier::FiveTuple t = findFlow (it->first);
+      if (t.destinationPort < sinkPort || t.destinationPort >= sinkPort + nPorts)
+        {
+          continue;
+        }
+      const FlowMonitor::FlowStats &flow = it->second;
+      flows++;
+      rxBytes += flow.rxBytes;
+      rxPackets += flow.rxPackets;
+      txPackets += flow.txPackets;
+      lostPackets += flow.lostPackets;
+      delaySum += flow.delaySum;
+      if (flow.txPackets)
+        {
+          firstTx = std::min (firstTx, flow.timeFirstTxPacket);
+        }
+      if (flow.rxPackets)
+        {
+          lastRx = std::max (lastRx, flow.timeLastRxPacket);
+        }
+    }
+
+  std::ofstream out (path.c_str ());
+  if (!out)
+    {
+      return false;
+    }
+  double duration = (flows && lastRx > firstTx) ? (lastRx - firstTx).GetSeconds () : 0;
+  out << "throughput_mbps\t" << (duration > 0 ? rxBytes * 8.0 / duration / 1e6 : 0) << "\n";
+  out << "delay_ms\t" << (rxPackets ? delaySum.GetSeconds () * 1e3 / rxPackets : 0) << "\n";
+  out << "loss_ratio\t" << (txPackets ? double (lostPackets) / txPackets : 0) << "\n";
+  out << "rx_bytes\t" << rxBytes << "\n";
+  out << "flows\t" << flows << "\n";
+  out << "seed\t" << replication.GetSeed () << "\n";
+  out << "run\t" << replication.GetRun () << "\n";
+  out << "events\t" << Simulator::GetEventCount () << "\n";
+  out << "sim_s\t" << Simulator::Now ().GetSeconds () << "\n";
+  return true;
+}
+
+inline bool
+WriteRunMetrics (const std::string &path, FlowMonitorHelper &flowMonitor, Ptr<FlowMonitor> monitor,
+                 uint16_t sinkPort, const ReplicationOptions &replication, uint16_t nPorts = 1)
+{
+  monitor->CheckForLostPackets ();
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowMonitor.GetClassifier ());
+  return WriteRunMetrics (path, monitor->GetFlowStats (),
+                          [classifier] (FlowId id) { return classifier->FindFlow (id); },
+                          sinkPort, replication, nPorts);
+}
+
+} // namespace ns3
+
+#endif /* RUN_METRICS_H */
@@ -0,0 +1,172 @@
+#ifndef TCP_CUBIC_TRACED_H
+#define TCP_CUBIC_TRACED_H
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+
+namespace ns3 {
+
+// TcpCubic with its window state exposed as trace sources:
+//
+//   WMax        W_max in segments, set on every window reduction (after
+//               fast convergence)
+//   EpochStart  start of the current congestion avoidance epoch, zero
+//               between a reduction and the first ACK that opens the next
+//               epoch
+//
+// TcpCubic keeps these private and has no accessor for them, so they are
+// read off what TcpCubic did: each callback runs the TcpCubic one first
+// and then looks at the window, ssthresh and state it left behind. The
+// window itself is left entirely to TcpCubic. TcpTraceSink swaps it in
+// for a socket's TcpCubic when it traces congestion control internals.
+//
+// An epoch opens when an ACK still has segments left for congestion
+// avoidance after slow start took its share. How much slow start takes
+// depends on the ns-3 release: one segment per ACK in older ones, every
+// acked segment (byte counting) in newer ones. The rule is learned from
+// the window growth of the first slow start ACK for several segments that
+// stays below ssthresh; until then one segment is assumed. Releases that
+// skip the window update on ACKs that are not cwnd limited can open the
+// real epoch some ACKs after the traced one.
+class TcpCubicTraced : public TcpCubic
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::TcpCubicTraced")
+      .SetParent<TcpCubic> ()
+      .SetGroupName ("Internet")
+      .AddConstructor<TcpCubicTraced> ()
+      .AddTraceSource ("WMax", "W_max in segments",
+                       MakeTraceSourceAccessor (&TcpCubicTraced::m_wMax),
+                       "ns3::TracedValueCallback::Uint32")
+      .AddTraceSource ("EpochStart", "Start of the current congestion avoidance epoch",
+                       MakeTraceSourceAccessor (&TcpCubicTraced::m_epochStart),
+                       "ns3::TracedValueCallback::Time")
+      ;
+    return tid;
+  }
+
+  TcpCubicTraced ()
+    : m_wMax (0),
+      m_epochStart (Time (0))
+  {
+  }
+
+  TcpCubicTraced (const TcpCubicTraced &sock)
+    : TcpCubic (sock),
+      m_wMax (sock.m_wMax),
+      m_epochStart (sock.m_epochStart)
+  {
+  }
+
+  // A TcpCubicTraced with the attribute values of cubic.
+  static Ptr<TcpCubicTraced> CreateFrom (Ptr<TcpCongestionOps> cubic)
+  {
+    Ptr<TcpCubicTraced> traced = CreateObject<TcpCubicTraced> ();
+    TypeId tid = TcpCubic::GetTypeId ();
+    for (uint32_t i = 0; i < tid.GetAttributeN (); ++i)
+      {
+        struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+        if (!(info.flags & TypeId::ATTR_GET) || !(info.flags & TypeId::ATTR_SET))
+          {
+            continue;
+          }
+        Ptr<AttributeValue> value = info.checker->Create ();
+        cubic->GetAttribute (info.name, *value);
+        traced->SetAttribute (info.name, *value);
+      }
+    return traced;
+  }
+
+  virtual std::string GetName () const
+  {
+    return "TcpCubicTraced";
+  }
+
+  virtual void IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+  {
+    uint32_t before = tcb->m_cWnd;
+    bool slowStart = before < tcb->m_ssThresh;
+    TcpCubic::IncreaseWindow (tcb, segmentsAcked);
+    uint32_t after = tcb->m_cWnd;
+    uint32_t avoidanceAcked = segmentsAcked;
+    if (slowStart)
+      {
+        if (after == before)
+          {
+            return;   // TcpCubic skipped the update altogether
+          }
+        if (SlowStartRule () == SS_UNKNOWN && segmentsAcked > 1 && after < tcb->m_ssThresh)
+          {
+            // Still in slow start, so all of the growth is slow start's.
+            SlowStartRule () = (after - before) / tcb->m_segmentSize > 1 ? SS_ALL : SS_ONE;
+          }
+        avoidanceAcked = SlowStartRule () == SS_ALL ? 0 : segmentsAcked - 1;
+      }
+    // TcpCubic::Update opens an epoch on the first ACK that reaches
+    // congestion avoidance after a reduction.
+    if (after >= tcb->m_ssThresh && avoidanceAcked > 0 && m_epochStart.Get ().IsZero ())
+      {
+        m_epochStart = Simulator::Now ();
+      }
+  }
+
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
+  {
+    uint32_t ssThresh = TcpCubic::GetSsThresh (tcb, bytesInFlight);
+    BooleanValue fastConvergence;
+    DoubleValue beta;
+    GetAttribute ("FastConvergence", fastConvergence);
+    GetAttribute ("Beta", beta);
+    uint32_t segCwnd = tcb->GetCwndInSegments ();
+    if (segCwnd < m_wMax && fastConvergence.Get ())
+      {
+        m_wMax = static_cast<uint32_t> ((segCwnd * (1 + beta.Get ())) / 2);
+      }
+    else
+      {
+        m_wMax = segCwnd;
+      }
+    m_epochStart = Time (0);
+    return ssThresh;
+  }
+
+  virtual void CongestionStateSet (Ptr<TcpSocketState> tcb, const TcpSocketState::TcpCongState_t newState)
+  {
+    TcpCubic::CongestionStateSet (tcb, newState);
+    if (newState == TcpSocketState::CA_LOSS)
+      {
+        m_wMax = 0;
+        m_epochStart = Time (0);
+      }
+  }
+
+  virtual Ptr<TcpCongestionOps> Fork ()
+  {
+    return CopyObject<TcpCubicTraced> (this);
+  }
+
+private:
+  // Segments of an ACK that TcpCubic's slow start consumes.
+  enum SlowStartAcked
+  {
+    SS_UNKNOWN,
+    SS_ONE,
+    SS_ALL,
+  };
+
+  // A property of the linked ns-3, shared by every socket.
+  static SlowStartAcked &SlowStartRule ()
+  {
+    static SlowStartAcked rule = SS_UNKNOWN;
+    return rule;
+  }
+
+  TracedValue<uint32_t> m_wMax;
+  TracedValue<Time> m_epochStart;
+};
+
+} // namespace ns3
+
+#endif /* TCP_CUBIC_TRACED_H */
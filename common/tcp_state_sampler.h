@@ -0,0 +1,185 @@
+#ifndef TCP_STATE_SAMPLER_H
+#define TCP_STATE_SAMPLER_H
+
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "column_store.h"
+
+namespace ns3 {
+
+// Samples the state of TCP sockets at a fixed interval: congestion window,
+// slow start threshold, RTT, RTO, bytes in flight and pacing rate.
+//
+// TcpSocketBase keeps these private, so the sampler latches the latest
+// value of each from its trace source (one store per change) and copies
+// the latched values of every flow into preallocated columns on each tick.
+// The columns are sized for (stop - start) / interval ticks when sampling
+// starts and never grow, so memory and output size depend on the run
+// length and the interval, not on the packet rate. Rows are tick-major
+// (all flows of a tick, then the next tick) and are written as one column
+// store series (common/column_store.h, series=tcpstate).
+class TcpStateSampler : public SimpleRefCount<TcpStateSampler>
+{
+public:
+  explicit TcpStateSampler (Time interval = MilliSeconds (10))
+    : m_interval (interval),
+      m_capacity (0)
+  {
+    NS_ABORT_MSG_IF (!interval.IsStrictlyPositive (), "TCP state sampling interval has to be positive");
+  }
+
+  // Connects socket as flow (flows are numbered in Connect order); before
+  // Start. The socket has to exist already.
+  void Connect (Ptr<Socket> socket)
+  {
+    NS_ABORT_MSG_IF (m_capacity, "TcpStateSampler::Connect after Start");
+    Ptr<FlowState> state = Create<FlowState> ();
+    m_flows.push_back (state);
+    socket->TraceConnectWithoutContext ("CongestionWindow", MakeCallback (&FlowState::Cwnd, state));
+    socket->TraceConnectWithoutContext ("SlowStartThreshold", MakeCallback (&FlowState::Ssthresh, state));
+    socket->TraceConnectWithoutContext ("RTT", MakeCallback (&FlowState::Rtt, state));
+    socket->TraceConnectWithoutContext ("RTO", MakeCallback (&FlowState::Rto, state));
+    socket->TraceConnectWithoutContext ("BytesInFlight", MakeCallback (&FlowState::InFlight, state));
+    // Not every ns-3 release has the pacing rate trace; the column then
+    // stays zero.
+    socket->TraceConnectWithoutContext ("PacingRate", MakeCallback (&FlowState::Pacing, state));
+  }
+
+  void Start (Time start, Time stop)
+  {
+    uint64_t ticks = (stop - start).GetTimeStep () / m_interval.GetTimeStep () + 1;
+    m_capacity = ticks * m_flows.size ();
+    m_time.reserve (m_capacity);
+    m_flow.reserve (m_capacity);
+    m_cwnd.reserve (m_capacity);
+    m_ssthresh.reserve (m_capacity);
+    m_rtt.reserve (m_capacity);
+    m_rto.reserve (m_capacity);
+    m_inFlight.reserve (m_capacity);
+    m_pacing.reserve (m_capacity);
+    m_stop = stop;
+    Simulator::Schedule (start - Simulator::Now (), &TcpStateSampler::Tick, this);
+  }
+
+  uint64_t GetNRows () const
+  {
+    return m_time.size ();
+  }
+
+  // Columns time (s), flow, cwnd, ssthresh, inflight (bytes), rtt, rto
+  // (s) and pacing (bit/s), plus the caller's metadata.
+  bool Write (const std::string &path, const std::vector<std::pair<std::string, std::string> > &meta) const
+  {
+    ColumnFileWriter writer;
+    writer.SetMeta ("series", "tcpstate");
+    writer.SetMeta ("interval", std::to_string (m_interval.GetSeconds ()));
+    writer.SetMeta ("flows", std::to_string (m_flows.size ()));
+    for (const std::pair<std::string, std::string> &kv : meta)
+      {
+        writer.SetMeta (kv.first, kv.second);
+      }
+    writer.AddColumn ("time", m_time);
+    writer.AddColumn ("flow", m_flow);
+    writer.AddColumn ("cwnd", m_cwnd);
+    writer.AddColumn ("ssthresh", m_ssthresh);
+    writer.AddColumn ("inflight", m_inFlight);
+    writer.AddColumn ("rtt", m_rtt);
+    writer.AddColumn ("rto", m_rto);
+    writer.AddColumn ("pacing", m_pacing);
+    return writer.Write (path);
+  }
+
+private:
+  struct FlowState : public SimpleRefCount<FlowState>
+  {
+    FlowState ()
+      : cwnd (0),
+        ssthresh (0),
+        inFlight (0),
+        rtt (0),
+        rto (0),
+        pacing (0)
+    {
+    }
+
+    void Cwnd (uint32_t oldValue, uint32_t newValue)
+    {
+      cwnd = newValue;
+    }
+
+    void Ssthresh (uint32_t oldValue, uint32_t newValue)
+    {
+      ssthresh = newValue;
+    }
+
+    void InFlight (uint32_t oldValue, uint32_t newValue)
+    {
+      inFlight = newValue;
+    }
+
+    void Rtt (Time oldValue, Time newValue)
+    {
+      rtt = newValue.GetSeconds ();
+    }
+
+    void Rto (Time oldValue, Time newValue)
+    {
+      rto = newValue.GetSeconds ();
+    }
+
+    void Pacing (DataRate oldValue, DataRate newValue)
+    {
+      pacing = newValue.GetBitRate ();
+    }
+
+    uint32_t cwnd;
+    uint32_t ssthresh;
+    uint32_t inFlight;
+    double rtt;
+    double rto;
+    uint64_t pacing;
+  };
+
+  void Tick ()
+  {
+    if (m_time.size () + m_flows.size () > m_capacity)
+      {
+        return;
+      }
+    double now = Simulator::Now ().GetSeconds ();
+    for (uint32_t i = 0; i < m_flows.size (); ++i)
+      {
+        const FlowState &state = *m_flows[i];
+        m_time.push_back (now);
+        m_flow.push_back (i);
+        m_cwnd.push_back (state.cwnd);
+        m_ssthresh.push_back (state.ssthresh);
+        m_inFlight.push_back (state.inFlight);
+        m_rtt.push_back (state.rtt);
+        m_rto.push_back (state.rto);
+        m_pacing.push_back (state.pacing);
+      }
+    if (Simulator::Now () + m_interval <= m_stop)
+      {
+        Simulator::Schedule (m_interval, &TcpStateSampler::Tick, this);
+      }
+  }
+
+  Time m_interval;
+  Time m_stop;
+  uint64_t m_capacity;   // rows
+  std::vector<Ptr<FlowState> > m_flows;
+  std::vector<double> m_time;
+  std::vector<uint32_t> m_flow;
+  std::vector<uint32_t> m_cwnd;
+  std::vector<uint32_t> m_ssthresh;
+  std::vector<uint32_t> m_inFlight;
+  std::vector<double> m_rtt;
+  std::vector<double> m_rto;
+  std::vector<uint64_t> m_pacing;
+};
+
+} // namespace ns3
+
+#endif /* TCP_STATE_SAMPLER_H */
@@ -0,0 +1,67 @@
+#ifndef TCP_TRACE_RECORD_H
+#define TCP_TRACE_RECORD_H
+
+// On-disk layout of the binary TCP state traces written by
+// common/tcp_trace_sink.h and read by tools/trace_to_cwnd.cc. Kept free of
+// ns-3 headers so the offline tools can include it.
+//
+// A file is one TcpTraceFileHeader followed by fixed-size records in
+// simulation time order, native byte order.
+
+#include <cstdint>
+#include <cstring>
+
+enum TcpTraceKind
+{
+  TCP_TRACE_CWND = 1,      // bytes
+  TCP_TRACE_SSTHRESH = 2,  // bytes
+  TCP_TRACE_RTT = 3,       // nanoseconds
+  // Congestion control internals (TcpTraceSink::Connect with internals).
+  TCP_TRACE_CUBIC_WMAX = 4,     // segments
+  TCP_TRACE_CUBIC_EPOCH = 5,    // epoch start, nanoseconds, 0: no epoch
+  TCP_TRACE_DCTCP_ALPHA = 6,    // parts per billion
+  TCP_TRACE_DCTCP_MARKED = 7,   // old: bytes acked, new: bytes marked in the observation window
+  TCP_TRACE_WESTWOOD_BW = 8,    // bandwidth estimate, bit/s
+};
+
+// Fixed point scale of TCP_TRACE_DCTCP_ALPHA.
+static const double TCP_TRACE_ALPHA_SCALE = 1e9;
+
+struct TcpTraceFileHeader
+{
+  char magic[8];           // "TCPTRACE"
+  uint32_t version;
+  uint32_t recordSize;
+};
+
+struct TcpTraceRecord
+{
+  int64_t timeNs;          // simulation time of the change
+  uint32_t flow;           // flow id chosen when the socket was connected
+  uint16_t kind;           // TcpTraceKind
+  uint16_t reserved;
+  uint64_t oldValue;
+  uint64_t newValue;
+};
+
+static const uint32_t TCP_TRACE_VERSION = 1;
+
+inline TcpTraceFileHeader
+MakeTcpTraceFileHeader ()
+{
+  TcpTraceFileHeader header;
+  std::memcpy (header.magic, "TCPTRACE", 8);
+  header.version = TCP_TRACE_VERSION;
+  header.recordSize = sizeof (TcpTraceRecord);
+  return header;
+}
+
+inline bool
+IsTcpTraceFileHeader (const TcpTraceFileHeader &header)
+{
+  return std::memcmp (header.magic, "TCPTRACE", 8) == 0
+         && header.version == TCP_TRACE_VERSION
+         && header.recordSize == sizeof (TcpTraceRecord);
+}
+
+#endif /* TCP_TRACE_RECORD_H */
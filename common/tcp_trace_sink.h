@@ -0,0 +1,162 @@
+#ifndef TCP_TRACE_SINK_H
+#define TCP_TRACE_SINK_H
+
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ring_file_writer.h"
+#include "tcp_cubic_traced.h"
+#include "tcp_trace_record.h"
+
+namespace ns3 {
+
+// Records congestion window, slow start threshold and RTT changes of TCP
+// sockets as fixed-size binary records (common/tcp_trace_record.h). The
+// records go through a RingFileWriter, so a trace callback costs one
+// record copy instead of double formatting plus a stream flush.
+//
+// With internals, the state of the socket's congestion control goes into
+// the same trace: Cubic's W_max and epoch start (the socket's TcpCubic is
+// replaced by the equivalent TcpCubicTraced), DCTCP's alpha and the
+// acked/marked bytes of each observation window, and Westwood's bandwidth
+// estimate. Other variants have no internals beyond cwnd and ssthresh.
+//
+// tools/trace_to_cwnd.cc turns a trace back into the tab separated
+// "time old new" .cwnd format, or any of the other series.
+class TcpTraceSink : public SimpleRefCount<TcpTraceSink>
+{
+public:
+  TcpTraceSink ()
+  {
+  }
+
+  ~TcpTraceSink ()
+  {
+    Close ();
+  }
+
+  bool Open (const std::string &path)
+  {
+    TcpTraceFileHeader header = MakeTcpTraceFileHeader ();
+    return m_writer.Open (path, &header, sizeof (header));
+  }
+
+  // Connects the socket's trace sources; flow tags its records. The socket
+  // has to exist already (call before the application starts).
+  void Connect (Ptr<Socket> socket, uint32_t flow, bool internals = false)
+  {
+    Ptr<FlowTracer> tracer = Create<FlowTracer> (this, flow);
+    m_tracers.push_back (tracer);
+    socket->TraceConnectWithoutContext ("CongestionWindow", MakeCallback (&FlowTracer::Cwnd, tracer));
+    socket->TraceConnectWithoutContext ("SlowStartThreshold", MakeCallback (&FlowTracer::Ssthresh, tracer));
+    socket->TraceConnectWithoutContext ("RTT", MakeCallback (&FlowTracer::Rtt, tracer));
+    if (internals)
+      {
+        ConnectInternals (socket, tracer);
+      }
+  }
+
+  void Record (uint32_t flow, TcpTraceKind kind, uint64_t oldValue, uint64_t newValue)
+  {
+    TcpTraceRecord record;
+    record.timeNs = Simulator::Now ().GetNanoSeconds ();
+    record.flow = flow;
+    record.kind = static_cast<uint16_t> (kind);
+    record.reserved = 0;
+    record.oldValue = oldValue;
+    record.newValue = newValue;
+    m_writer.Append (record);
+  }
+
+  // Flushes the ring and closes the file; call after Simulator::Run. False
+  // when the trace could not be written completely.
+  bool Close ()
+  {
+    return m_writer.Close ();
+  }
+
+private:
+  class FlowTracer;
+
+  void ConnectInternals (Ptr<Socket> socket, Ptr<FlowTracer> tracer)
+  {
+    Ptr<TcpSocketBase> tcp = DynamicCast<TcpSocketBase> (socket);
+    PointerValue ops;
+    NS_ABORT_MSG_IF (!tcp || !tcp->GetAttributeFailSafe ("CongestionOps", ops),
+                     "TcpTraceSink: congestion control internals asked for a socket without CongestionOps");
+    Ptr<TcpCongestionOps> cc = ops.Get<TcpCongestionOps> ();
+    if (cc && cc->GetInstanceTypeId () == TcpCubic::GetTypeId ())
+      {
+        cc = TcpCubicTraced::CreateFrom (cc);
+        tcp->SetCongestionControlAlgorithm (cc);
+      }
+    NS_ABORT_MSG_IF (!cc, "TcpTraceSink: congestion control internals asked for a socket without congestion control");
+    cc->TraceConnectWithoutContext ("WMax", MakeCallback (&FlowTracer::CubicWMax, tracer));
+    cc->TraceConnectWithoutContext ("EpochStart", MakeCallback (&FlowTracer::CubicEpoch, tracer));
+    cc->TraceConnectWithoutContext ("CongestionEstimate", MakeCallback (&FlowTracer::DctcpEstimate, tracer));
+    cc->TraceConnectWithoutContext ("EstimatedBW", MakeCallback (&FlowTracer::WestwoodBw, tracer));
+  }
+
+  class FlowTracer : public SimpleRefCount<FlowTracer>
+  {
+  public:
+    FlowTracer (TcpTraceSink *sink, uint32_t flow)
+      : m_sink (sink),
+        m_flow (flow),
+        m_alpha (0)
+    {
+    }
+
+    void Cwnd (uint32_t oldValue, uint32_t newValue)
+    {
+      m_sink->Record (m_flow, TCP_TRACE_CWND, oldValue, newValue);
+    }
+
+    void Ssthresh (uint32_t oldValue, uint32_t newValue)
+    {
+      m_sink->Record (m_flow, TCP_TRACE_SSTHRESH, oldValue, newValue);
+    }
+
+    void Rtt (Time oldValue, Time newValue)
+    {
+      m_sink->Record (m_flow, TCP_TRACE_RTT, oldValue.GetNanoSeconds (), newValue.GetNanoSeconds ());
+    }
+
+    void CubicWMax (uint32_t oldValue, uint32_t newValue)
+    {
+      m_sink->Record (m_flow, TCP_TRACE_CUBIC_WMAX, oldValue, newValue);
+    }
+
+    void CubicEpoch (Time oldValue, Time newValue)
+    {
+      m_sink->Record (m_flow, TCP_TRACE_CUBIC_EPOCH, oldValue.GetNanoSeconds (), newValue.GetNanoSeconds ());
+    }
+
+    void DctcpEstimate (uint32_t bytesAcked, uint32_t bytesMarked, double alpha)
+    {
+      uint64_t scaled = static_cast<uint64_t> (alpha * TCP_TRACE_ALPHA_SCALE + 0.5);
+      m_sink->Record (m_flow, TCP_TRACE_DCTCP_MARKED, bytesAcked, bytesMarked);
+      m_sink->Record (m_flow, TCP_TRACE_DCTCP_ALPHA, m_alpha, scaled);
+      m_alpha = scaled;
+    }
+
+    void WestwoodBw (double oldValue, double newValue)
+    {
+      m_sink->Record (m_flow, TCP_TRACE_WESTWOOD_BW, static_cast<uint64_t> (oldValue * 8),
+                      static_cast<uint64_t> (newValue * 8));
+    }
+
+  private:
+    TcpTraceSink *m_sink;
+    uint32_t m_flow;
+    uint64_t m_alpha;   // last DCTCP alpha, scaled
+  };
+
+  RingFileWriter<TcpTraceRecord> m_writer;
+  std::vector<Ptr<FlowTracer> > m_tracers;
+};
+
+} // namespace ns3
+
+#endif /* TCP_TRACE_SINK_H */
@@ -0,0 +1,208 @@
+#ifndef TRACE_POLICY_H
+#define TRACE_POLICY_H
+
+#include <set>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+
+namespace ns3 {
+
+// Decides per run which per-packet traces a scenario writes, instead of
+// EnableAsciiAll/EnablePcapAll on every device.
+//
+//   --trace=off         nothing
+//   --trace=summary     only the in-run statistics (common/link_trace_analyzer.h)
+//   --trace=bottleneck  summary, plus ASCII and pcap traces of the devices the
+//                       program marks as bottleneck, or of --traceDevices
+//   --trace=full        summary, plus ASCII and pcap traces of every device
+//
+// A program's other per-event outputs (cwnd and queue length series, event
+// logs) are written at bottleneck and full only, see WantsEventTraces.
+//
+// --traceDevices=n0/1,n2/1 selects devices by node id and interface index
+// (the names used in the summary file). --snaplen=N truncates pcap records
+// to N bytes, enough for the headers without the payload.
+class TracePolicy
+{
+public:
+  enum Level
+  {
+    OFF,
+    SUMMARY,
+    BOTTLENECK,
+    FULL,
+  };
+
+  explicit TracePolicy (const std::string &defaultLevel)
+    : m_levelName (defaultLevel),
+      m_level (FULL),
+      m_snapLen (0)
+  {
+  }
+
+  void AddCommandLineOptions (CommandLine &cmd)
+  {
+    cmd.AddValue ("trace", "Trace level: off, summary, bottleneck or full", m_levelName);
+    cmd.AddValue ("traceDevices", "Comma separated node/ifIndex list traced at the bottleneck level", m_devices);
+    cmd.AddValue ("snaplen", "Truncate pcap records to this many bytes (0: whole packet)", m_snapLen);
+  }
+
+  // Call after CommandLine::Parse.
+  void Validate ()
+  {
+    if (m_levelName == "off")
+      {
+        m_level = OFF;
+      }
+    else if (m_levelName == "summary")
+      {
+        m_level = SUMMARY;
+      }
+    else if (m_levelName == "bottleneck")
+      {
+        m_level = BOTTLENECK;
+      }
+    else if (m_levelName == "full")
+      {
+        m_level = FULL;
+      }
+    else
+      {
+        NS_FATAL_ERROR ("Unknown trace level " << m_levelName << ", expected off, summary, bottleneck or full");
+      }
+    m_selected.clear ();
+    std::istringstream iss (m_devices);
+    std::string name;
+    while (std::getline (iss, name, ','))
+      {
+        if (!name.empty ())
+          {
+            m_selected.insert (name);
+          }
+      }
+  }
+
+  Level GetLevel () const
+  {
+    return m_level;
+  }
+
+  bool WantsSummary () const
+  {
+    return m_level >= SUMMARY;
+  }
+
+  // Outputs with a line or record per event (cwnd change, queue length
+  // change, ...), whose size grows with the traffic like a packet trace.
+  bool WantsEventTraces () const
+  {
+    return m_level >= BOTTLENECK;
+  }
+
+  // The devices whose per-packet traces this run writes: all of them at
+  // the full level, the --traceDevices ones (or else the bottlenecks) at
+  // the bottleneck level, none below that.
+  NetDeviceContainer Select (NetDeviceContainer all, NetDeviceContainer bottlenecks) const
+  {
+    if (m_level == FULL)
+      {
+        return all;
+      }
+    if (m_level != BOTTLENECK)
+      {
+        return NetDeviceContainer ();
+      }
+    if (m_selected.empty ())
+      {
+        return bottlenecks;
+      }
+    NetDeviceContainer selected;
+    for (uint32_t i = 0; i < all.GetN (); ++i)
+      {
+        if (m_selected.count (DeviceName (all.Get (i))))
+          {
+            selected.Add (all.Get (i));
+          }
+      }
+    return selected;
+  }
+
+  // ASCII trace of the selected devices into one file; the file is only
+  // created when at least one device is selected.
+  void EnableAscii (AsciiTraceHelperForDevice &helper, const std::string &filename,
+                    NetDeviceContainer all, NetDeviceContainer bottlenecks) const
+  {
+    NetDeviceContainer devices = Select (all, bottlenecks);
+    if (devices.GetN () == 0)
+      {
+        return;
+      }
+    AsciiTraceHelper ascii;
+    Ptr<OutputStreamWrapper> stream = ascii.CreateFileStream (filename);
+    for (uint32_t i = 0; i < devices.GetN (); ++i)
+      {
+        helper.EnableAscii (stream, devices.Get (i));
+      }
+  }
+
+  // One <prefix>-<node>-<if>.pcap per selected device, like EnablePcapAll.
+  void EnablePcap (const std::string &prefix, NetDeviceContainer all, NetDeviceContainer bottlenecks) const
+  {
+    NetDeviceContainer devices = Select (all, bottlenecks);
+    PcapHelper pcapHelper;
+    for (uint32_t i = 0; i < devices.GetN (); ++i)
+      {
+        Ptr<NetDevice> device = devices.Get (i);
+        bool ppp = device->GetInstanceTypeId ().GetName () == "ns3::PointToPointNetDevice";
+        std::string filename = pcapHelper.GetFilenameFromDevice (prefix, device);
+        Ptr<PcapFileWrapper> file = pcapHelper.CreateFile (filename, std::ios::out,
+                                                           ppp ? PcapHelper::DLT_PPP : PcapHelper::DLT_EN10MB,
+                                                           m_snapLen ? m_snapLen : 65535);
+        // Same trace sources the point-to-point and CSMA helpers use.
+        device->TraceConnectWithoutContext (ppp ? "PromiscSniffer" : "Sniffer",
+                                            MakeBoundCallback (&TracePolicy::WritePcap, file));
+      }
+  }
+
+  // The devices of nodes that sit on a channel (no loopback), for programs
+  // that used to trace every device with EnableAsciiAll/EnablePcapAll.
+  static NetDeviceContainer Devices (NodeContainer nodes)
+  {
+    NetDeviceContainer devices;
+    for (NodeContainer::Iterator it = nodes.Begin (); it != nodes.End (); ++it)
+      {
+        for (uint32_t i = 0; i < (*it)->GetNDevices (); ++i)
+          {
+            if ((*it)->GetDevice (i)->GetChannel ())
+              {
+                devices.Add ((*it)->GetDevice (i));
+              }
+          }
+      }
+    return devices;
+  }
+
+  static std::string DeviceName (Ptr<NetDevice> device)
+  {
+    std::ostringstream oss;
+    oss << "n" << device->GetNode ()->GetId () << "/" << device->GetIfIndex ();
+    return oss.str ();
+  }
+
+private:
+  static void WritePcap (Ptr<PcapFileWrapper> file, Ptr<const Packet> packet)
+  {
+    file->Write (Simulator::Now (), packet);
+  }
+
+  std::string m_levelName;
+  Level m_level;
+  std::string m_devices;
+  uint32_t m_snapLen;
+  std::set<std::string> m_selected;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_POLICY_H */
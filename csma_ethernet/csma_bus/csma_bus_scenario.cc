@@ -0,0 +1,364 @@
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/ipv4-interface.h"
+#include "../../common/link_trace_analyzer.h"
+#include "../../common/trace_policy.h"
+#include "../../common/replication.h"
+#include "../../common/run_metrics.h"
+#include "../../common/endpoint_flow_monitor.h"
+#include "../../common/link_schedule.h"
+#include "../../common/aqm_helper.h"
+#include "../../common/event_profiler.h"
+
+// Shared CSMA bus used by the slide2 and slide4 experiments: nClients OnOff
+// TCP clients and one packet sink server on a single CSMA channel. The
+// congestion control TypeId is a runtime option, e.g.
+//
+//   ./ns3 run "csma_bus_scenario --slide=4 --scenario=3 --tcp=ns3::TcpWestwood"
+//
+// Scenario presets (nClients, channel rate, run time, client groups):
+//   slide 2, scenario 1:  10 clients, 2Mbps,   all clients 1-10s
+//   slide 2, scenario 2:  50 clients, 2Mbps,   clients 0-9 1-2s, clients 20-29 4-10s, others 0-10s
+//   slide 2, scenario 3:  50 clients, 2Mbps,   clients 0-9 1-2s, clients 10-29 4-10s, others 0-10s
+//   slide 4, scenario 2a: 30 clients, 1Mbps,   all clients 1-10s
+//   slide 4, scenario 2b: 30 clients, 0.5Mbps, all clients 1-10s
+//   slide 4, scenario 3:  60 clients, 2Mbps,   clients 20-39 start at 20s, clients 40-59 start at 40s,
+//                                              others 0-100s
+//   slide 4, scenario 4:  60 clients, 2Mbps,   clients 20-39 active 20-40s, others 0-100s
+//
+// Clients outside any group start at 0s in the grouped scenarios, as they
+// did in the per-scenario programs these presets replace.
+//
+// --queue puts a queue disc on every client device, where the flows wait
+// for the channel; --queue=ECN is the step marking queue for DCTCP (marking
+// at --ecnK packets, ECN negotiated on every socket).
+
+using namespace ns3;
+NS_LOG_COMPONENT_DEFINE("CsmaBusScenario");
+
+// Clients [first, last) run from start to stop instead of the default window.
+struct ClientGroup
+{
+    uint32_t first;
+    uint32_t last;
+    double start;
+    double stop;
+};
+
+struct ScenarioPreset
+{
+    uint32_t nClients;
+    double channelDataRate; // Mbps
+    double stopTime;        // seconds
+    double clientStart;     // seconds, for clients outside the groups
+    std::vector<ClientGroup> groups;
+};
+
+static bool
+LookupPreset(uint32_t slide, const std::string& scenario, ScenarioPreset& preset)
+{
+    preset.groups.clear();
+    preset.clientStart = 1.0;
+    if (slide == 2 && scenario == "1")
+    {
+        preset.nClients = 10;
+        preset.channelDataRate = 2.0;
+        preset.stopTime = 10.0;
+    }
+    else if (slide == 2 && scenario == "2")
+    {
+        preset.nClients = 50;
+        preset.channelDataRate = 2.0;
+        preset.stopTime = 10.0;
+        preset.clientStart = 0.0;
+        preset.groups.push_back({0, 10, 1.0, 2.0});
+        preset.groups.push_back({20, 30, 4.0, 10.0});
+    }
+    else if (slide == 2 && scenario == "3")
+    {
+        preset.nClients = 50;
+        preset.channelDataRate = 2.0;
+        preset.stopTime = 10.0;
+        preset.clientStart = 0.0;
+        preset.groups.push_back({0, 10, 1.0, 2.0});
+        preset.groups.push_back({10, 30, 4.0, 10.0});
+    }
+    else if (slide == 4 && (scenario == "2a" || scenario == "2b"))
+    {
+        preset.nClients = 30;
+        preset.channelDataRate = (scenario == "2a") ? 1.0 : 0.5;
+        preset.stopTime = 10.0;
+    }
+    else if (slide == 4 && scenario == "3")
+    {
+        preset.nClients = 60;
+        preset.channelDataRate = 2.0;
+        preset.stopTime = 100.0;
+        preset.clientStart = 0.0;
+        preset.groups.push_back({20, 40, 20.0, 100.0});
+        preset.groups.push_back({40, 60, 40.0, 100.0});
+    }
+    else if (slide == 4 && scenario == "4")
+    {
+        preset.nClients = 60;
+        preset.channelDataRate = 2.0;
+        preset.stopTime = 100.0;
+        preset.clientStart = 0.0;
+        preset.groups.push_back({20, 40, 20.0, 40.0});
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// "ns3::TcpCubic" -> "TcpCubic", used in the output file names.
+static std::string
+VariantName(const std::string& tcp)
+{
+    std::string::size_type pos = tcp.rfind("::");
+    return pos == std::string::npos ? tcp : tcp.substr(pos + 2);
+}
+
+int main(int argc, char *argv[])
+{
+    // Set up some default values for the simulation.
+    // These can also be changed if needed to create congestion in the network.
+    Config::SetDefault("ns3::OnOffApplication::PacketSize", UintegerValue(1400));
+    Config::SetDefault("ns3::OnOffApplication::DataRate", StringValue("2Mbps"));
+
+    uint32_t slide = 2;
+    std::string scenario = "1";
+    std::string tcp = "ns3::TcpCubic";
+    uint32_t nClients = 0; // 0 keeps the preset value
+    double channelDataRate = 0.0; // 0 keeps the preset value
+    std::string prefix = "";
+    TracePolicy tracePolicy("full");
+    double bucket = 0.1;
+    ReplicationOptions replication;
+    bool metrics = true;
+    bool profile = false;
+    std::string flowMonitorMode = "all";
+    std::string linkTrace = "";
+    std::string queue = "FIFO";
+    std::string queueSize = "100p";
+    uint32_t ecnK = 5;
+
+    CommandLine cmd;
+    cmd.AddValue("slide", "Experiment family, 2 or 4", slide);
+    cmd.AddValue("scenario", "Scenario preset: 1, 2, 3 for slide 2; 2a, 2b, 3, 4 for slide 4", scenario);
+    cmd.AddValue("tcp", "Congestion control TypeId, e.g. ns3::TcpNewReno", tcp);
+    cmd.AddValue("nClients", "Number of client nodes (overrides the preset)", nClients);
+    cmd.AddValue("channelDataRate", "Total shared channel data rate in Mbps (overrides the preset)", channelDataRate);
+    cmd.AddValue("prefix", "Output file prefix (default derived from slide/scenario/tcp)", prefix);
+    tracePolicy.AddCommandLineOptions(cmd);
+    cmd.AddValue("bucket", "Time bucket of the summary statistics in seconds", bucket);
+    cmd.AddValue("linkTrace", "Capacity/delay schedule for the shared channel (time rate delay or Mahimahi file)", linkTrace);
+    cmd.AddValue("queue", "Client queue: FIFO (device DropTail), RED, FqCoDel, PIE or ECN (step marking at ecnK)", queue);
+    cmd.AddValue("queueSize", "Client queue limit", queueSize);
+    cmd.AddValue("ecnK", "Marking threshold of the ECN queue in packets", ecnK);
+    replication.AddCommandLineOptions(cmd);
+    cmd.AddValue("metrics", "Write throughput/delay/loss of the run to <prefix>_metrics.tsv", metrics);
+    cmd.AddValue("profile", "Write where the wall clock time goes per event type to <prefix>_profile.tsv", profile);
+    cmd.AddValue("flowMonitor", "Flows measured for the metrics: all (FlowMonitor on every node) or endpoints (client to server flows only)", flowMonitorMode);
+    cmd.Parse(argc, argv);
+    tracePolicy.Validate();
+    replication.Apply();
+    if (profile)
+    {
+        EventProfiler::Enable(Seconds(bucket));
+    }
+    if (flowMonitorMode != "all" && flowMonitorMode != "endpoints")
+    {
+        NS_FATAL_ERROR("Unknown flowMonitor " << flowMonitorMode << ", expected all or endpoints");
+    }
+
+    ScenarioPreset preset;
+    if (!LookupPreset(slide, scenario, preset))
+    {
+        NS_FATAL_ERROR("Unknown preset slide " << slide << " scenario " << scenario);
+    }
+    if (nClients == 0)
+    {
+        nClients = preset.nClients;
+    }
+    if (channelDataRate <= 0.0)
+    {
+        channelDataRate = preset.channelDataRate;
+    }
+
+    if (!AqmHelper::IsKnown(queue))
+    {
+        NS_FATAL_ERROR("Unknown queue " << queue << ", expected FIFO, RED, FqCoDel, PIE or ECN");
+    }
+    AqmHelper aqm(queue, queueSize, ecnK);
+
+    TypeId tcpTid;
+    if (!TypeId::LookupByNameFailSafe(tcp, &tcpTid))
+    {
+        NS_FATAL_ERROR("Unknown congestion control TypeId " << tcp);
+    }
+    if (prefix.empty())
+    {
+        std::ostringstream oss;
+        oss << "Slide" << slide << "_scen" << scenario << "_";
+        if (!aqm.IsFifo())
+        {
+            oss << queue << "_";
+        }
+        oss << VariantName(tcp);
+        prefix = oss.str();
+    }
+
+    // set TCP protocol
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(tcpTid));
+    if (aqm.IsEcn())
+    {
+        AqmHelper::EnableEcn();
+    }
+
+    NS_LOG_INFO("Create nodes.");
+    NodeContainer csmaNodes;
+    csmaNodes.Create(nClients + 1); // +1 for the server
+
+    NS_LOG_INFO("Create channel.");
+    CsmaHelper csma;
+    csma.SetChannelAttribute("DataRate", DataRateValue(DataRate(channelDataRate * 1e6))); // Convert to bps
+    csma.SetChannelAttribute("Delay", TimeValue(NanoSeconds(6560)));
+    if (!aqm.IsFifo())
+    {
+        csma.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue(aqm.GetDeviceQueueSize()));
+    }
+
+    NetDeviceContainer csmaDevices;
+    csmaDevices = csma.Install(csmaNodes);
+    AssignStreamBlock(STREAM_CHANNEL, csma.AssignStreams(csmaDevices, STREAM_CHANNEL));
+    Ptr<LinkDynamics> linkDynamics = Create<LinkDynamics>();
+    if (!linkTrace.empty())
+    {
+        linkDynamics->Attach(csmaDevices.Get(0), LinkSchedule::Load(linkTrace));
+    }
+    // The server's device carries every flow, it is the one to look at
+    // when only the bottleneck is traced.
+    NetDeviceContainer serverDevice(csmaDevices.Get(nClients));
+    tracePolicy.EnableAscii(csma, prefix + ".tr", csmaDevices, serverDevice);
+    tracePolicy.EnablePcap(prefix + "-csma", csmaDevices, serverDevice);
+
+    // Per-client throughput, drops and queue occupancy computed during the
+    // run instead of being parsed out of the .tr file.
+    Ptr<LinkTraceAnalyzer> analyzer;
+    if (tracePolicy.WantsSummary())
+    {
+        analyzer = Create<LinkTraceAnalyzer>(Seconds(bucket));
+        analyzer->Attach(csmaDevices);
+    }
+
+    NS_LOG_INFO("Install internet stack on all nodes.");
+    InternetStackHelper internet;
+    internet.Install(csmaNodes);
+    AssignStreamBlock(STREAM_STACK, internet.AssignStreams(csmaNodes, STREAM_STACK));
+
+    // The clients' devices hold the data waiting for the channel; the queue
+    // discs go there before the addresses are assigned.
+    NetDeviceContainer clientDevices;
+    for (uint32_t i = 0; i < nClients; ++i)
+    {
+        clientDevices.Add(csmaDevices.Get(i));
+    }
+    QueueDiscContainer queueDiscs = aqm.Install(clientDevices);
+    AssignStreamBlock(STREAM_QUEUE, AqmHelper::AssignStreams(queueDiscs, STREAM_QUEUE));
+
+    NS_LOG_INFO("Assign IP Addresses.");
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(csmaDevices);
+
+    NS_LOG_INFO("Create applications.");
+
+    // Server application
+    uint16_t serverPort = 50000;
+    Address serverAddress(InetSocketAddress(interfaces.GetAddress(nClients), serverPort));
+    PacketSinkHelper packetSinkHelper("ns3::TcpSocketFactory", serverAddress);
+    ApplicationContainer serverApp = packetSinkHelper.Install(csmaNodes.Get(nClients));
+    serverApp.Start(Seconds(1.0));
+    serverApp.Stop(Seconds(preset.stopTime));
+
+    // Client applications
+    OnOffHelper onOffHelper("ns3::TcpSocketFactory", serverAddress);
+    onOffHelper.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+    onOffHelper.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0]"));
+
+    ApplicationContainer clientApps;
+
+    for (uint32_t i = 0; i < nClients; ++i)
+    {
+        ApplicationContainer onOffApp = onOffHelper.Install(csmaNodes.Get(i));
+        clientApps.Add(onOffApp);
+
+        double start = preset.clientStart;
+        double stop = preset.stopTime;
+        for (const ClientGroup& group : preset.groups)
+        {
+            if (i >= group.first && i < group.last)
+            {
+                start = group.start;
+                stop = group.stop;
+            }
+        }
+        onOffApp.Start(Seconds(start));
+        onOffApp.Stop(Seconds(stop));
+    }
+    AssignStreamBlock(STREAM_APPS, onOffHelper.AssignStreams(csmaNodes, STREAM_APPS));
+
+    FlowMonitorHelper flowMonitor;
+    Ptr<FlowMonitor> monitor;
+    Ptr<EndpointFlowMonitor> endpointMonitor;
+    if (metrics && flowMonitorMode == "endpoints")
+    {
+        endpointMonitor = Create<EndpointFlowMonitor>();
+        endpointMonitor->Watch(interfaces.GetAddress(nClients), serverPort);
+        endpointMonitor->Install(csmaNodes);
+    }
+    else if (metrics)
+    {
+        monitor = flowMonitor.InstallAll();
+    }
+
+    NS_LOG_INFO("Run Simulation.");
+    // FlowMonitor checks for lost packets every second for as long as the
+    // run goes on, so the run needs an explicit end.
+    Simulator::Stop(Seconds(preset.stopTime));
+    Simulator::Run();
+    if (profile && !EventProfiler::Write(prefix + "_profile.tsv", prefix + "_queue_depth.tsv"))
+    {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_profile.tsv");
+    }
+    if (monitor && !WriteRunMetrics(prefix + "_metrics.tsv", flowMonitor, monitor, serverPort, replication))
+    {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_metrics.tsv");
+    }
+    if (endpointMonitor && !WriteRunMetrics(prefix + "_metrics.tsv", endpointMonitor, serverPort, replication))
+    {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_metrics.tsv");
+    }
+    if (metrics && queueDiscs.GetN() > 0 && !AqmHelper::AppendMetrics(prefix + "_metrics.tsv", queueDiscs))
+    {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_metrics.tsv");
+    }
+    if (analyzer && !analyzer->Write(prefix + "_summary.tsv"))
+    {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_summary.tsv");
+    }
+
+    Simulator::Destroy();
+    NS_LOG_INFO("Done.");
+
+    return 0;
+}
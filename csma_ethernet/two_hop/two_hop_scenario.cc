@@ -0,0 +1,532 @@
+#include <fstream>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/traffic-control-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "../../common/my_app.h"
+#include "../../common/tcp_trace_sink.h"
+#include "../../common/link_trace_analyzer.h"
+#include "../../common/column_store.h"
+#include "../../common/aqm_helper.h"
+#include "../../common/event_profiler.h"
+#include "../../common/trace_policy.h"
+#include "../../common/replication.h"
+#include "../../common/run_metrics.h"
+#include "../../common/fast_routing.h"
+#include "../../common/link_schedule.h"
+#include "../../common/adaptation_monitor.h"
+#include "../../common/competition.h"
+#include "../../common/tcp_state_sampler.h"
+#include "../../common/loss_recovery.h"
+
+// Two hop path used by the slide5 and slide6 experiments.
+//
+//   n0 -------- n1 -------- n2
+//       2Mbps       2Mbps
+//        5ms         5ms
+//
+// One program for every TCP variant, queue type and scenario. The
+// congestion control TypeId and the link parameters are runtime options,
+// e.g.
+//
+//   ./ns3 run "two_hop_scenario --slide=6 --scenario=2 --queue=RED --tcp=ns3::TcpDctcp"
+//
+// Scenario 1 keeps the rate constant, scenario 2 drops it to 1Mbps at 2s and
+// 0.5Mbps at 4s, scenario 3 drops it to 1Mbps at 2s and restores 2Mbps at 4s.
+//
+// --compete=ns3::TcpCubic,ns3::TcpNewReno runs the listed variants against
+// each other on the same path instead, --flowsPerVariant flows each, every
+// socket with its own congestion control.
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TwoHopScenario");
+
+static void
+CwndChange (Ptr<OutputStreamWrapper> stream, uint32_t oldCwnd, uint32_t newCwnd)
+{
+  *stream->GetStream () << Simulator::Now ().GetSeconds () << "\t" << oldCwnd << "\t" << newCwnd << "\n";
+}
+
+// cwnd changes kept in memory and written as a .cols file after the run.
+struct CwndColumns
+{
+  std::vector<double> time;
+  std::vector<uint32_t> oldCwnd;
+  std::vector<uint32_t> newCwnd;
+};
+
+static void
+CwndToColumns (CwndColumns *columns, uint32_t oldCwnd, uint32_t newCwnd)
+{
+  columns->time.push_back (Simulator::Now ().GetSeconds ());
+  columns->oldCwnd.push_back (oldCwnd);
+  columns->newCwnd.push_back (newCwnd);
+}
+
+// "ns3::TcpCubic" -> "TcpCubic", used in the output file names.
+static std::string
+VariantName (const std::string &tcp)
+{
+  std::string::size_type pos = tcp.rfind ("::");
+  return pos == std::string::npos ? tcp : tcp.substr (pos + 2);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t slide = 5;
+  uint32_t scenario = 1;
+  std::string queue = "FIFO";
+  std::string tcp = "ns3::TcpCubic";
+  // THe bandwidth of point ot point link is setup as 2Mbps.
+  std::string bandwidth = "2Mbps";
+  std::string delay = "5ms";
+  std::string queuesize = "";
+  std::string prefix = "";
+  std::string cwndFormat = "binary";
+  TracePolicy tracePolicy ("full");
+  ReplicationOptions replication;
+  bool metrics = true;
+  bool profile = false;
+  double bucket = 0.1;
+  bool store = true;
+  bool aqmTrace = true;
+  std::string linkTrace = "";
+  bool adaptation = true;
+  std::string compete = "";
+  uint32_t flowsPerVariant = 1;
+  double sampleInterval = 0;
+  bool ccTrace = false;
+  bool recovery = true;
+  double error_rate = 0.000001;
+  uint32_t meanPktSize = 1460;
+  uint32_t ecnK = 5;
+
+  int simulation_time = 10; //seconds
+
+  CommandLine cmd;
+  cmd.AddValue ("slide", "Experiment family, 5 or 6", slide);
+  cmd.AddValue ("scenario", "1: constant rate, 2: 2->1->0.5Mbps, 3: 2->1->2Mbps", scenario);
+  cmd.AddValue ("queue", "Bottleneck queue: FIFO (device DropTail), RED, FqCoDel, PIE or ECN (step marking at ecnK)", queue);
+  cmd.AddValue ("ecnK", "Marking threshold of the ECN queue in packets", ecnK);
+  cmd.AddValue ("tcp", "Congestion control TypeId, e.g. ns3::TcpNewReno", tcp);
+  cmd.AddValue ("compete", "Comma separated variants sharing the path in one run (replaces --tcp), e.g. ns3::TcpCubic,ns3::TcpNewReno", compete);
+  cmd.AddValue ("flowsPerVariant", "Flows per variant with --compete", flowsPerVariant);
+  cmd.AddValue ("bandwidth", "Link data rate", bandwidth);
+  cmd.AddValue ("delay", "Link delay", delay);
+  cmd.AddValue ("queueSize", "Bottleneck queue limit (FIFO default 10p for slide 5, 5p for slide 6; AQM default 25p)", queuesize);
+  cmd.AddValue ("errorRate", "Receive error rate on n1", error_rate);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulation_time);
+  cmd.AddValue ("prefix", "Output file prefix (default derived from slide/scenario/queue/tcp)", prefix);
+  cmd.AddValue ("cwndFormat", "binary: <prefix>_tcp.trace (cwnd, ssthresh, RTT), tsv: .cwnd text file (at --trace=bottleneck or full)", cwndFormat);
+  tracePolicy.AddCommandLineOptions (cmd);
+  cmd.AddValue ("bucket", "Time bucket of the summary statistics in seconds", bucket);
+  cmd.AddValue ("store", "Write the cwnd series to <prefix>_cwnd.cols (tools/cwnd_query; at --trace=bottleneck or full)", store);
+  cmd.AddValue ("ccTrace", "Add the congestion control internals (Cubic W_max/epoch, DCTCP alpha/marked bytes, Westwood bandwidth estimate) to the binary trace", ccTrace);
+  cmd.AddValue ("recovery", "Count fast retransmits, RTOs, spurious retransmissions and zero window stalls per flow into <prefix>_recovery.tsv (at --trace=summary and above) and <prefix>_recovery_events.tsv (at bottleneck or full)", recovery);
+  cmd.AddValue ("sampleInterval", "Sample cwnd, ssthresh, RTT, RTO, bytes in flight and pacing rate of every flow every this many seconds into <prefix>_tcpstate.cols (0: off)", sampleInterval);
+  cmd.AddValue ("aqmTrace", "Write queue disc length, drops and marks to <prefix>_aqm.tsv (at --trace=bottleneck or full)", aqmTrace);
+  cmd.AddValue ("linkTrace", "Capacity/delay schedule for both links (time rate delay or Mahimahi file), replaces the scenario's rate changes", linkTrace);
+  cmd.AddValue ("adaptation", "Write re-convergence, queueing and utilization after each rate change to <prefix>_adaptation.tsv (at --trace=summary and above)", adaptation);
+  replication.AddCommandLineOptions (cmd);
+  cmd.AddValue ("metrics", "Write throughput/delay/loss of the run to <prefix>_metrics.tsv", metrics);
+  cmd.AddValue ("profile", "Write where the wall clock time goes per event type to <prefix>_profile.tsv", profile);
+  cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
+  // The per-event outputs follow --trace like the packet traces, so an off
+  // or summary run writes nothing whose size grows with the traffic.
+  bool eventTraces = tracePolicy.WantsEventTraces ();
+  store = store && eventTraces;
+  aqmTrace = aqmTrace && eventTraces;
+  adaptation = adaptation && tracePolicy.WantsSummary ();
+  replication.Apply ();
+  if (profile)
+    {
+      EventProfiler::Enable (Seconds (bucket));
+    }
+
+  if (slide != 5 && slide != 6)
+    {
+      NS_FATAL_ERROR ("Unknown slide " << slide << ", expected 5 or 6");
+    }
+  if (scenario < 1 || scenario > 3)
+    {
+      NS_FATAL_ERROR ("Unknown scenario " << scenario << ", expected 1, 2 or 3");
+    }
+  if (cwndFormat != "binary" && cwndFormat != "tsv")
+    {
+      NS_FATAL_ERROR ("Unknown cwndFormat " << cwndFormat << ", expected binary or tsv");
+    }
+  if (!AqmHelper::IsKnown (queue))
+    {
+      NS_FATAL_ERROR ("Unknown queue " << queue << ", expected FIFO, RED, FqCoDel, PIE or ECN");
+    }
+  TypeId tcpTid;
+  if (!TypeId::LookupByNameFailSafe (tcp, &tcpTid))
+    {
+      NS_FATAL_ERROR ("Unknown congestion control TypeId " << tcp);
+    }
+  std::vector<TypeId> variants = Competition::ParseVariants (compete);
+  if (!compete.empty () && (variants.empty () || flowsPerVariant == 0))
+    {
+      NS_FATAL_ERROR ("--compete needs at least one variant and --flowsPerVariant at least 1");
+    }
+  std::string tcpName = VariantName (tcp);
+  if (!variants.empty ())
+    {
+      tcpName.clear ();
+      for (const TypeId &variant : variants)
+        {
+          tcpName += (tcpName.empty () ? "" : "_vs_") + VariantName (variant.GetName ());
+        }
+    }
+  bool red = (queue == "RED");
+
+  // RED's MaxTh of 15 packets needs room above it, with a 5p limit it
+  // would only ever tail drop.
+  if (queuesize.empty () && queue != "FIFO")
+    {
+      queuesize = "25p";
+    }
+  else if (queuesize.empty ())
+    {
+      queuesize = (slide == 5) ? "10p" : "5p";
+    }
+  AqmHelper aqm (queue, queuesize, ecnK);
+
+  // Output names follow the ones the per-variant programs used so the
+  // NS3_Sim_Run_Results layout does not change.
+  std::string cwndSuffix = "_cwnd.cwnd";
+  if (prefix.empty ())
+    {
+      std::ostringstream oss;
+      oss << "Slide" << slide << "_scen" << scenario << "_";
+      if (slide == 6 || queue != "FIFO")
+        {
+          oss << queue << "_";
+        }
+      oss << tcpName;
+      prefix = oss.str ();
+      if (slide == 5 && scenario == 3)
+        {
+          cwndSuffix = "_DR_change_cwnd.cwnd";
+        }
+    }
+
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (tcpTid));
+  if (aqm.IsEcn ())
+    {
+      AqmHelper::EnableEcn ();
+    }
+  if (red)
+    {
+      Config::SetDefault ("ns3::RedQueueDisc::MeanPktSize", UintegerValue (meanPktSize));
+      Config::SetDefault ("ns3::RedQueueDisc::Wait", BooleanValue (true));
+      Config::SetDefault ("ns3::RedQueueDisc::Gentle", BooleanValue (true));
+      Config::SetDefault ("ns3::RedQueueDisc::QW", DoubleValue (0.002));
+      Config::SetDefault ("ns3::RedQueueDisc::MinTh", DoubleValue (5));
+      Config::SetDefault ("ns3::RedQueueDisc::MaxTh", DoubleValue (15));
+    }
+
+  NodeContainer n0n1;
+  n0n1.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue (bandwidth));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue (delay));
+  pointToPoint.SetQueue ("ns3::DropTailQueue",
+                         "MaxSize", StringValue (aqm.GetDeviceQueueSize ()));
+
+  NetDeviceContainer devices;
+  devices = pointToPoint.Install (n0n1);
+
+  NodeContainer n1n2;
+  n1n2.Add (n0n1.Get (1));
+  n1n2.Create (1);
+
+  PointToPointHelper pointToPoint2;
+  pointToPoint2.SetDeviceAttribute ("DataRate", StringValue (bandwidth));
+  pointToPoint2.SetChannelAttribute ("Delay", StringValue (delay));
+  pointToPoint2.SetQueue ("ns3::DropTailQueue",
+                          "MaxSize", StringValue (aqm.GetDeviceQueueSize ()));
+
+  NetDeviceContainer devices2;
+  devices2 = pointToPoint2.Install (n1n2);
+
+  Ptr<RateErrorModel> em = CreateObject<RateErrorModel> ();
+  em->SetAttribute ("ErrorRate", DoubleValue (error_rate));
+  AssignStreamBlock (STREAM_ERROR_MODEL, em->AssignStreams (STREAM_ERROR_MODEL));
+  devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (em));
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+  AssignStreamBlock (STREAM_STACK, stack.AssignStreams (NodeContainer::GetGlobal (), STREAM_STACK));
+
+  // The queue disc goes on the forward (n0->n1, n1->n2) devices before the
+  // addresses are assigned; the ACK direction keeps the default.
+  NetDeviceContainer bottlenecks;
+  bottlenecks.Add (devices.Get (0));
+  bottlenecks.Add (devices2.Get (0));
+  QueueDiscContainer queueDiscs = aqm.Install (bottlenecks);
+  AssignStreamBlock (STREAM_QUEUE, AqmHelper::AssignStreams (queueDiscs, STREAM_QUEUE));
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.252");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ipv4AddressHelper address2;
+  address2.SetBase ("10.1.2.0", "255.255.255.252");
+  Ipv4InterfaceContainer interfaces2 = address2.Assign (devices2);
+
+  // n0 - n1 - n2 is a chain: default routes towards n2 and a route back to
+  // the n0-n1 subnet on n2, without running global routing.
+  NodeContainer chain (n0n1, n1n2.Get (1));
+  NetDeviceContainer chainDevices (devices, devices2);
+  FastRouting::PopulateChain (chain, chainDevices);
+
+  // One sink port per flow, so every flow's goodput can be read from its
+  // own PacketSink.
+  uint32_t nFlows = variants.empty () ? 1 : variants.size () * flowsPerVariant;
+  uint16_t sinkPort = 8080;
+  ApplicationContainer sinkApps;
+  for (uint32_t i = 0; i < nFlows; ++i)
+    {
+      PacketSinkHelper packetSinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), sinkPort + i));
+      sinkApps.Add (packetSinkHelper.Install (n1n2.Get (1)));
+    }
+  sinkApps.Start (Seconds (0.));
+  sinkApps.Stop (Seconds (simulation_time));
+
+  // Competing flows alternate between the variants and start 100ms apart;
+  // their shares are measured once the last one has started.
+  Ptr<Competition> competition;
+  if (!variants.empty ())
+    {
+      competition = Create<Competition> ();
+      competition->SetWindow (Seconds (1. + 0.1 * (nFlows - 1)), Seconds (simulation_time));
+    }
+  std::vector<Ptr<Socket> > sockets;
+  for (uint32_t i = 0; i < nFlows; ++i)
+    {
+      Ptr<Socket> socket;
+      if (competition)
+        {
+          TypeId variant = variants[i % variants.size ()];
+          socket = Competition::CreateSocket (n0n1.Get (0), variant);
+          competition->AddFlow (VariantName (variant.GetName ()), socket, DynamicCast<PacketSink> (sinkApps.Get (i)));
+        }
+      else
+        {
+          socket = Socket::CreateSocket (n0n1.Get (0), TcpSocketFactory::GetTypeId ());
+        }
+      sockets.push_back (socket);
+
+      Address sinkAddress (InetSocketAddress (interfaces2.GetAddress (1), sinkPort + i));
+      Ptr<MyApp> app = CreateObject<MyApp> ();
+      // The data rate is senin the speed of 100Mbps. This remains constant.
+      app->Setup (socket, sinkAddress, 1460, 1000000, DataRate ("100Mbps"));
+      n0n1.Get (0)->AddApplication (app);
+      app->SetStartTime (Seconds (1. + 0.1 * i));
+      app->SetStopTime (Seconds (simulation_time));
+    }
+  if (competition)
+    {
+      competition->Start ();
+    }
+  // The cwnd files follow the first flow.
+  Ptr<Socket> ns3TcpSocket = sockets[0];
+
+  //trace cwnd
+  // The binary trace holds cwnd, ssthresh and RTT; tools/trace_to_cwnd
+  // writes the .cwnd text file from it after the run.
+  Ptr<TcpTraceSink> tcpTrace;
+  if (eventTraces && cwndFormat == "binary")
+    {
+      tcpTrace = Create<TcpTraceSink> ();
+      if (!tcpTrace->Open (prefix + "_tcp.trace"))
+        {
+          NS_FATAL_ERROR ("Cannot open " << prefix << "_tcp.trace");
+        }
+      for (uint32_t i = 0; i < sockets.size (); ++i)
+        {
+          tcpTrace->Connect (sockets[i], i, ccTrace);
+        }
+    }
+  else if (eventTraces)
+    {
+      AsciiTraceHelper asciiTraceHelper;
+      Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateFileStream (prefix + cwndSuffix);
+      ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback (&CwndChange, stream));
+    }
+
+  Ptr<AqmTraceSink> aqmSink;
+  if (aqmTrace && queueDiscs.GetN () > 0)
+    {
+      aqmSink = Create<AqmTraceSink> ();
+      aqmSink->Open (prefix + "_aqm.tsv");
+      aqmSink->Connect (queueDiscs);
+    }
+
+  Ptr<LossRecoveryMonitor> recoveryMonitor;
+  if (recovery)
+    {
+      recoveryMonitor = Create<LossRecoveryMonitor> ();
+      for (Ptr<Socket> socket : sockets)
+        {
+          recoveryMonitor->Connect (socket);
+        }
+    }
+
+  Ptr<TcpStateSampler> sampler;
+  if (sampleInterval > 0)
+    {
+      sampler = Create<TcpStateSampler> (Seconds (sampleInterval));
+      for (Ptr<Socket> socket : sockets)
+        {
+          sampler->Connect (socket);
+        }
+      sampler->Start (Seconds (1.), Seconds (simulation_time));
+    }
+
+  CwndColumns cwndColumns;
+  if (store)
+    {
+      ns3TcpSocket->TraceConnectWithoutContext ("CongestionWindow", MakeBoundCallback (&CwndToColumns, &cwndColumns));
+    }
+
+  NetDeviceContainer allDevices (devices, devices2);
+  tracePolicy.EnableAscii (pointToPoint, prefix + "_trace.tr", allDevices, bottlenecks);
+
+  // Throughput, drops and queue occupancy computed during the run, the
+  // numbers that used to be parsed out of the .tr file.
+  Ptr<LinkTraceAnalyzer> analyzer;
+  if (tracePolicy.WantsSummary ())
+    {
+      analyzer = Create<LinkTraceAnalyzer> (Seconds (bucket));
+      analyzer->Attach (devices);
+      analyzer->Attach (devices2);
+    }
+
+  // Rate changes at t=2s and t=4s, the total simulation time is 10s. The
+  // schedule applies to both directions of both links.
+  Ptr<LinkSchedule> linkSchedule;
+  if (!linkTrace.empty ())
+    {
+      linkSchedule = LinkSchedule::Load (linkTrace);
+    }
+  else if (scenario == 2 || scenario == 3)
+    {
+      linkSchedule = Create<LinkSchedule> ();
+      linkSchedule->Add (Seconds (2.0), DataRate ("1Mbps"));
+      linkSchedule->Add (Seconds (4.0), (scenario == 2) ? DataRate ("0.5Mbps") : DataRate (bandwidth));
+    }
+  Ptr<LinkDynamics> linkDynamics = Create<LinkDynamics> ();
+  if (linkSchedule)
+    {
+      linkDynamics->Attach (allDevices, linkSchedule);
+    }
+
+  // How the flow follows the rate changes at the first bottleneck, n0->n1.
+  Ptr<AdaptationMonitor> adaptationMonitor;
+  if (adaptation && linkSchedule)
+    {
+      adaptationMonitor = Create<AdaptationMonitor> ();
+      adaptationMonitor->SetBottleneck (devices.Get (0), queueDiscs.GetN () > 0 ? queueDiscs.Get (0) : Ptr<QueueDisc> ());
+      adaptationMonitor->MonitorSinks (sinkApps);
+      adaptationMonitor->SetMeta ("slide", std::to_string (slide));
+      adaptationMonitor->SetMeta ("scenario", std::to_string (scenario));
+      adaptationMonitor->SetMeta ("queue", queue);
+      adaptationMonitor->SetMeta ("tcp", tcpName);
+      adaptationMonitor->SetMeta ("run", std::to_string (replication.GetRun ()));
+      adaptationMonitor->Start (Seconds (1.), Seconds (simulation_time));
+    }
+
+  FlowMonitorHelper flowMonitor;
+  Ptr<FlowMonitor> monitor;
+  if (metrics)
+    {
+      monitor = flowMonitor.InstallAll ();
+    }
+
+  Simulator::Stop (Seconds (simulation_time));
+  Simulator::Run ();
+  if (profile && !EventProfiler::Write (prefix + "_profile.tsv", prefix + "_queue_depth.tsv"))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_profile.tsv");
+    }
+  if (monitor && !WriteRunMetrics (prefix + "_metrics.tsv", flowMonitor, monitor, sinkPort, replication, nFlows))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_metrics.tsv");
+    }
+  if (monitor && queueDiscs.GetN () > 0 && !AqmHelper::AppendMetrics (prefix + "_metrics.tsv", queueDiscs))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_metrics.tsv");
+    }
+  if (recoveryMonitor)
+    {
+      if ((tracePolicy.WantsSummary () && !recoveryMonitor->WriteSummary (prefix + "_recovery.tsv"))
+          || (eventTraces && !recoveryMonitor->WriteEvents (prefix + "_recovery_events.tsv"))
+          || (monitor && !recoveryMonitor->AppendMetrics (prefix + "_metrics.tsv")))
+        {
+          NS_FATAL_ERROR ("Cannot write the loss recovery results of " << prefix);
+        }
+    }
+  if (tcpTrace && !tcpTrace->Close ())
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_tcp.trace");
+    }
+  if (store)
+    {
+      ColumnFileWriter writer;
+      writer.SetMeta ("series", "cwnd");
+      writer.SetMeta ("slide", std::to_string (slide));
+      writer.SetMeta ("scenario", std::to_string (scenario));
+      writer.SetMeta ("queue", queue);
+      // With --compete the series is the first flow's, of the first variant.
+      writer.SetMeta ("tcp", variants.empty () ? tcpName : VariantName (variants[0].GetName ()));
+      if (!variants.empty ())
+        {
+          writer.SetMeta ("compete", tcpName);
+        }
+      writer.SetMeta ("bandwidth", bandwidth);
+      writer.SetMeta ("delay", delay);
+      writer.SetMeta ("queueSize", queuesize);
+      writer.AddColumn ("time", cwndColumns.time);
+      writer.AddColumn ("old", cwndColumns.oldCwnd);
+      writer.AddColumn ("new", cwndColumns.newCwnd);
+      if (!writer.Write (prefix + "_cwnd.cols"))
+        {
+          NS_FATAL_ERROR ("Cannot write " << prefix << "_cwnd.cols");
+        }
+    }
+  if (analyzer && !analyzer->Write (prefix + "_summary.tsv"))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_summary.tsv");
+    }
+  std::vector<std::pair<std::string, std::string> > meta;
+  meta.push_back (std::make_pair (std::string ("slide"), std::to_string (slide)));
+  meta.push_back (std::make_pair (std::string ("scenario"), std::to_string (scenario)));
+  meta.push_back (std::make_pair (std::string ("queue"), queue));
+  meta.push_back (std::make_pair (std::string ("tcp"), tcpName));
+  meta.push_back (std::make_pair (std::string ("run"), std::to_string (replication.GetRun ())));
+  if (competition && !competition->Write (prefix + "_competition.tsv", meta))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_competition.tsv");
+    }
+  if (sampler && !sampler->Write (prefix + "_tcpstate.cols", meta))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_tcpstate.cols");
+    }
+  if (adaptationMonitor && !adaptationMonitor->Write (prefix + "_adaptation.tsv"))
+    {
+      NS_FATAL_ERROR ("Cannot write " << prefix << "_adaptation.tsv");
+    }
+  Simulator::Destroy ();
+
+  return 0;
+}
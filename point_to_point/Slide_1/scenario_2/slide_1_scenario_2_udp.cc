@@ -7,6 +7,8 @@
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-helper.h"
 #include "ns3/flow-monitor-module.h"
+#include "../../../common/fast_routing.h"
+#include "../../../common/trace_policy.h"
 
 // Network topology (default)
 //
@@ -38,6 +40,7 @@ void SetInterfacesUp(PointToPointStarHelper& star) {
         Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
         uint32_t ifIndex = 1; // Assuming the first point-to-point interface, adjust if needed
         ipv4->SetUp(ifIndex);
+        FastRouting::RestoreDefaultRoute(node, ifIndex); // SetDown removed it
     }
 }
 
@@ -54,9 +57,13 @@ int main (int argc, char *argv[])
   // Default number of nodes in the star.  Overridable by command line argument.
   uint32_t nSpokes = 8;
 
+  TracePolicy tracePolicy ("full");
+
   CommandLine cmd;
   cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+  tracePolicy.AddCommandLineOptions (cmd);
   cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
 
   NS_LOG_INFO ("Build star topology.");
   PointToPointHelper pointToPoint;
@@ -101,20 +108,21 @@ int main (int argc, char *argv[])
   spokeApps.Start (Seconds (1.0));
   spokeApps.Stop (Seconds (10.0));
 
-  NS_LOG_INFO ("Enable static global routing.");
+  NS_LOG_INFO ("Populate routing tables.");
   //
-  // Turn on global static routing so we can actually be routed across the star.
+  // Every spoke reaches the others through the hub: one default route per
+  // spoke instead of an SPF from every node.
   //
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  FastRouting::PopulateStar (star);
 
-  NS_LOG_INFO ("Enable pcap tracing.");
+  NS_LOG_INFO ("Enable tracing.");
   //
-  // Do pcap tracing on all point-to-point devices on all nodes.
+  // Every flow ends at the hub, so the hub's devices are the bottleneck.
   //
-  pointToPoint.EnablePcapAll ("star");
-  //For ascii trace
-  AsciiTraceHelper ascii;
-  pointToPoint.EnableAsciiAll(ascii.CreateFileStream("slide_1_scenario_2_udp.tr"));
+  NetDeviceContainer allDevices = TracePolicy::Devices (NodeContainer::GetGlobal ());
+  NetDeviceContainer hubDevices = TracePolicy::Devices (star.GetHub ());
+  tracePolicy.EnablePcap ("star", allDevices, hubDevices);
+  tracePolicy.EnableAscii (pointToPoint, "slide_1_scenario_2_udp.tr", allDevices, hubDevices);
 
   NS_LOG_INFO ("Run Simulation.");
   Simulator::Schedule (Seconds (2), SetInterfacesDown, star);
@@ -7,9 +7,10 @@
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-helper.h"
 #include "ns3/flow-monitor-module.h"
-#include <cstdlib>  // For rand() and srand()
-#include <ctime>    // For time()
-#include <vector>
+#include "../../../common/replication.h"
+#include "../../../common/fast_routing.h"
+#include "../../../common/trace_policy.h"
+#include "../../../common/failure_injector.h"
 
 // Network topology (default)
 //
@@ -25,31 +26,6 @@
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("Star");
-void SetInterfacesDown(PointToPointStarHelper& star, std::vector<uint32_t>& downNodes, uint32_t numNodesToBringDown) {
-    std::srand(std::time(0)); // Seed for random number generation
-
-    downNodes.clear(); // Clear the previous set of down nodes
-
-    for (uint32_t i = 0; i < numNodesToBringDown; ++i) {
-        uint32_t randomNodeIndex = rand() % star.SpokeCount(); // Randomly select a node
-        Ptr<Node> node = star.GetSpokeNode(randomNodeIndex);
-        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-        uint32_t ifIndex = 1; // Assuming the first point-to-point interface, adjust if needed
-        ipv4->SetDown(ifIndex);
-
-        downNodes.push_back(randomNodeIndex); // Store the index of the node brought down
-    }
-}
-
-void SetInterfacesUp(PointToPointStarHelper& star, const std::vector<uint32_t>& downNodes) {
-    for (uint32_t i = 0; i < downNodes.size(); ++i) {
-        uint32_t nodeIndex = downNodes[i];
-        Ptr<Node> node = star.GetSpokeNode(nodeIndex);
-        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-        uint32_t ifIndex = 1; // Assuming the first point-to-point interface, adjust if needed
-        ipv4->SetUp(ifIndex);
-    }
-}
 
 int main (int argc, char *argv[])
 {
@@ -63,10 +39,22 @@ int main (int argc, char *argv[])
 
   // Default number of nodes in the star.  Overridable by command line argument.
   uint32_t nSpokes = 8;
+  uint32_t nDown = 5;
+
+  ReplicationOptions replication;
+  Ptr<FailureInjector> failures = Create<FailureInjector> ();
+
+  TracePolicy tracePolicy ("full");
 
   CommandLine cmd;
   cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+  cmd.AddValue ("nDown", "Number of distinct random spokes taken down between 2s and 4s", nDown);
+  replication.AddCommandLineOptions (cmd);
+  failures->AddCommandLineOptions (cmd);
+  tracePolicy.AddCommandLineOptions (cmd);
   cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
+  replication.Apply ();
 
   NS_LOG_INFO ("Build star topology.");
   PointToPointHelper pointToPoint;
@@ -111,28 +99,37 @@ int main (int argc, char *argv[])
   spokeApps.Start (Seconds (1.0));
   spokeApps.Stop (Seconds (10.0));
 
-  NS_LOG_INFO ("Enable static global routing.");
+  NS_LOG_INFO ("Populate routing tables.");
   //
-  // Turn on global static routing so we can actually be routed across the star.
+  // Every spoke reaches the others through the hub: one default route per
+  // spoke instead of an SPF from every node.
   //
-  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  FastRouting::PopulateStar (star);
 
-  NS_LOG_INFO ("Enable pcap tracing.");
+  NS_LOG_INFO ("Enable tracing.");
   //
-  // Do pcap tracing on all point-to-point devices on all nodes.
+  // Every flow ends at the hub, so the hub's devices are the bottleneck.
   //
-  pointToPoint.EnablePcapAll ("star");
-  //For ascii trace
-  AsciiTraceHelper ascii;
-  pointToPoint.EnableAsciiAll(ascii.CreateFileStream("slide_1_scenario_3_udp.tr"));
+  NetDeviceContainer allDevices = TracePolicy::Devices (NodeContainer::GetGlobal ());
+  NetDeviceContainer hubDevices = TracePolicy::Devices (star.GetHub ());
+  tracePolicy.EnablePcap ("star", allDevices, hubDevices);
+  tracePolicy.EnableAscii (pointToPoint, "slide_1_scenario_3_udp.tr", allDevices, hubDevices);
+
+  // The spokes are drawn from the failure RNG stream (--seed/--run), so a
+  // replication brings down the same spokes every time it is rerun.
+  uint32_t firstSpoke = failures->AddStarSpokes (star);
+  failures->AddRandomOutages (firstSpoke, star.SpokeCount (), nDown, Seconds (2), Seconds (2));
+  failures->ApplyOptions (Seconds (1), Seconds (10));
+  failures->SetInterfaceUpCallback (MakeCallback (&FastRouting::RestoreDefaultRoute)); // SetDown removed it
+  failures->MonitorSinks (hubApp);
+  failures->Schedule ();
 
   NS_LOG_INFO ("Run Simulation.");
-  std::vector<uint32_t> downNodes; // Store the indices of nodes brought down
-
-  Simulator::Schedule (Seconds (2), &SetInterfacesDown, star, downNodes, 5);
-  Simulator::Schedule (Seconds (4), &SetInterfacesUp, star, downNodes);
-
   Simulator::Run ();
+  if (!failures->WriteReport ("slide_1_scenario_3_udp_outages.tsv"))
+    {
+      NS_FATAL_ERROR ("Cannot write slide_1_scenario_3_udp_outages.tsv");
+    }
   Simulator::Destroy ();
   NS_LOG_INFO ("Done.");
 
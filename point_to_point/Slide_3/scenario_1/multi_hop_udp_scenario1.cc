@@ -4,6 +4,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../../../common/latency_probe.h"
 
 using namespace ns3;
 
@@ -50,6 +51,10 @@ int main() {
     // Install FlowMonitor on all nodes
     FlowMonitorHelper flowMonitor;
     Ptr<FlowMonitor> monitor = flowMonitor.InstallAll();
+    // Per-packet delay and jitter histograms, for the percentiles the
+    // FlowMonitor means hide
+    Ptr<LatencyProbe> latency = Create<LatencyProbe>();
+    latency->InstallAll();
 
     // Run the simulation
     Simulator::Stop(Seconds(500));
@@ -74,11 +79,13 @@ int main() {
                 std::cout << "  Throughput: N/A (duration is zero or negative)\n";
             }
             std::cout << "  Average Delay: " << i->second.delaySum / i->second.rxPackets << " seconds\n";
+            latency->Print(std::cout, t);
             //std::cout << "  Jitter: " << i->second.jitterSum / (i->second.rxPackets - 1) << " seconds\n";
             std::cout << "  Packet Loss: " << i->second.lostPackets << " packets\n";
             std::cout << "Simulation Stop: " << Simulator::Now().GetSeconds() << "s\n";
         }
     }
+    latency->WriteFiles("multi_hop_udp_scenario1");
     std::cout << "Total Bytes Sent: " << totalBytesSent << " bytes\n";
     // Cleanup
     Simulator::Destroy();
@@ -4,6 +4,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../../../common/latency_probe.h"
 
 using namespace ns3;
 
@@ -50,6 +51,10 @@ int main() {
     // Install FlowMonitor on all nodes
     FlowMonitorHelper flowMonitor;
     Ptr<FlowMonitor> monitor = flowMonitor.InstallAll();
+    // Per-packet delay and jitter histograms, for the percentiles the
+    // FlowMonitor means hide
+    Ptr<LatencyProbe> latency = Create<LatencyProbe>();
+    latency->InstallAll();
 
     // Run the simulation
     Simulator::Stop(Seconds(500));
@@ -76,11 +81,13 @@ int main() {
                 std::cout << "  Throughput: N/A (duration is zero or negative)\n";
             }
             std::cout << "  Average Delay: " << entry.second.delaySum / entry.second.rxPackets << " seconds\n";
+            latency->Print(std::cout, t);
             std::cout << "  Packet Loss: " << entry.second.lostPackets << " packets\n";
             std::cout << "Simulation Stop: " << Simulator::Now().GetSeconds() << "s\n";
         }
     }
 
+    latency->WriteFiles("multi_hop_udp_scenario2");
     std::cout << "Total Bytes Sent: " << totalBytesSent << " bytes\n";
 
     // Cleanup
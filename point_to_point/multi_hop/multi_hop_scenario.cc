@@ -0,0 +1,229 @@
+#include <string>
+#include <fstream>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/network-module.h"
+#include "ns3/packet-sink.h"
+#include "ns3/flow-monitor-module.h"
+#include "../../common/link_trace_analyzer.h"
+#include "../../common/trace_policy.h"
+#include "../../common/replication.h"
+#include "../../common/run_metrics.h"
+#include "../../common/fast_routing.h"
+#include "../../common/failure_injector.h"
+
+// Chain of point-to-point links used by the Slide_3 TCP experiments, with a
+// BulkSend source on the first node and a packet sink on the last one. The
+// congestion control TypeId is a runtime option, e.g.
+//
+//   ./ns3 run "multi_hop_scenario --scenario=1 --tcp=ns3::TcpWestwood"
+//
+// Scenario presets:
+//   scenario 1: 23 nodes, 1000Mbps, 1ms, 30000s
+//   scenario 2:  2 nodes,    5Kbps, 5ms,    50s
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("MultiHopScenario");
+
+int main(int argc, char *argv[]) {
+
+    TracePolicy tracePolicy("off");
+    ReplicationOptions replication;
+    std::string prefix = "";
+    uint32_t maxBytes = 0;
+    uint32_t scenario = 1;
+    std::string tcp = "ns3::TcpCubic";
+    uint32_t nNodes = 0;        // 0 keeps the preset value
+    std::string dataRate = "";  // empty keeps the preset value
+    std::string delay = "";     // empty keeps the preset value
+    double simulationTime = 0;  // 0 keeps the preset value
+    std::string routing = "fast";
+    Ptr<FailureInjector> failures = Create<FailureInjector>();
+
+    CommandLine cmd;
+    tracePolicy.AddCommandLineOptions(cmd);
+    cmd.AddValue("maxBytes", "Total number of bytes for application to send", maxBytes);
+    cmd.AddValue("scenario", "Scenario preset, 1 or 2", scenario);
+    cmd.AddValue("tcp", "Congestion control TypeId, e.g. ns3::TcpNewReno", tcp);
+    cmd.AddValue("nNodes", "Number of nodes in the chain (overrides the preset)", nNodes);
+    cmd.AddValue("dataRate", "Link data rate (overrides the preset)", dataRate);
+    cmd.AddValue("delay", "Link delay (overrides the preset)", delay);
+    cmd.AddValue("simulationTime", "Simulation time in seconds (overrides the preset)", simulationTime);
+    cmd.AddValue("prefix", "Output file prefix (default derived from scenario/tcp)", prefix);
+    cmd.AddValue("routing", "fast: static routes along the chain, global: Ipv4GlobalRoutingHelper", routing);
+    replication.AddCommandLineOptions(cmd);
+    failures->AddCommandLineOptions(cmd);
+    cmd.Parse(argc, argv);
+    tracePolicy.Validate();
+    replication.Apply();
+
+    if (scenario == 1) {
+        nNodes = nNodes ? nNodes : 23;
+        dataRate = dataRate.empty() ? "1000Mbps" : dataRate;
+        delay = delay.empty() ? "1ms" : delay;
+        simulationTime = simulationTime > 0 ? simulationTime : 30000.0;
+    } else if (scenario == 2) {
+        nNodes = nNodes ? nNodes : 2;
+        dataRate = dataRate.empty() ? "5Kbps" : dataRate;
+        delay = delay.empty() ? "5ms" : delay;
+        simulationTime = simulationTime > 0 ? simulationTime : 50.0;
+    } else {
+        NS_FATAL_ERROR("Unknown scenario " << scenario << ", expected 1 or 2");
+    }
+    if (nNodes < 2) {
+        NS_FATAL_ERROR("A chain needs at least two nodes");
+    }
+    if (routing != "fast" && routing != "global") {
+        NS_FATAL_ERROR("Unknown routing " << routing << ", expected fast or global");
+    }
+
+    TypeId tcpTid;
+    if (!TypeId::LookupByNameFailSafe(tcp, &tcpTid)) {
+        NS_FATAL_ERROR("Unknown congestion control TypeId " << tcp);
+    }
+    if (prefix.empty()) {
+        std::string::size_type pos = tcp.rfind("::");
+        std::string variant = (pos == std::string::npos) ? tcp : tcp.substr(pos + 2);
+        std::ostringstream oss;
+        oss << "multi_hop_scenario_" << scenario << "_" << variant;
+        prefix = oss.str();
+    }
+
+    // set TCP protocol
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", TypeIdValue(tcpTid));
+
+    NS_LOG_INFO("Create nodes.");
+    NodeContainer nodes;
+    nodes.Create(nNodes);
+
+    NS_LOG_INFO("Create channels.");
+
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue(dataRate));
+    pointToPoint.SetChannelAttribute("Delay", StringValue(delay));
+
+    NetDeviceContainer devices;
+
+    // Connect nodes with point-to-point channels
+    for (uint32_t i = 0; i + 1 < nNodes; ++i) {
+        devices.Add(pointToPoint.Install(nodes.Get(i), nodes.Get(i + 1)));
+    }
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    AssignStreamBlock(STREAM_STACK, internet.AssignStreams(nodes, STREAM_STACK));
+
+    NS_LOG_INFO("Assign IP Addresses.");
+
+    // One subnet per link so packets are forwarded hop by hop.
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces;
+    for (uint32_t i = 0; i < devices.GetN(); i += 2) {
+        NetDeviceContainer link;
+        link.Add(devices.Get(i));
+        link.Add(devices.Get(i + 1));
+        interfaces.Add(ipv4.Assign(link));
+        ipv4.NewNetwork();
+    }
+    // Global routing runs an SPF from every node, which dominates the setup
+    // of long chains; the chain layout gives the routes directly.
+    if (routing == "fast") {
+        FastRouting::PopulateChain(nodes, devices);
+    } else {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
+
+    // The last device in the container belongs to the last node.
+    Ipv4Address sourceAddress = interfaces.GetAddress(0);
+    Ipv4Address sinkAddress = interfaces.GetAddress(interfaces.GetN() - 1);
+
+    NS_LOG_INFO("Create Applications.");
+
+    uint16_t port = 9;
+
+    // Source application on the first node
+    BulkSendHelper source("ns3::TcpSocketFactory",
+                          InetSocketAddress(sinkAddress, port));
+    source.SetAttribute("MaxBytes", UintegerValue(maxBytes));
+    ApplicationContainer sourceApps = source.Install(nodes.Get(0));
+    sourceApps.Start(Seconds(0.0));
+    sourceApps.Stop(Seconds(simulationTime));
+
+    // Sink application on the last node
+    PacketSinkHelper sink("ns3::TcpSocketFactory",
+                          InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinkApps = sink.Install(nodes.Get(nNodes - 1));
+    sinkApps.Start(Seconds(0.0));
+    sinkApps.Stop(Seconds(simulationTime));
+
+    // The source's first hop is where the BulkSend backlog queues up.
+    NetDeviceContainer firstHop(devices.Get(0));
+    tracePolicy.EnableAscii(pointToPoint, prefix + ".tr", devices, firstHop);
+    tracePolicy.EnablePcap(prefix, devices, firstHop);
+
+    Ptr<LinkTraceAnalyzer> analyzer;
+    if (tracePolicy.WantsSummary()) {
+        analyzer = Create<LinkTraceAnalyzer>(Seconds(1.0));
+        analyzer->Attach(devices);
+    }
+
+    // Link outages ("link0" is the source's hop) drop packets on the channel
+    // and leave the routes alone.
+    failures->AddChainLinks(devices);
+    failures->ApplyOptions(Seconds(0), Seconds(simulationTime));
+    failures->MonitorSinks(sinkApps);
+    failures->Schedule();
+
+    FlowMonitorHelper flowMonitor;
+    Ptr<FlowMonitor> monitor = flowMonitor.InstallAll();
+
+    NS_LOG_INFO("Run Simulation.");
+    Simulator::Stop(Seconds(simulationTime));
+    Simulator::Run();
+    NS_LOG_INFO("Done.");
+    if (analyzer && !analyzer->Write(prefix + "_summary.tsv")) {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_summary.tsv");
+    }
+    if (!WriteRunMetrics(prefix + "_metrics.tsv", flowMonitor, monitor, port, replication)) {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_metrics.tsv");
+    }
+    if (failures->GetNOutages() > 0 && !failures->WriteReport(prefix + "_outages.tsv")) {
+        NS_FATAL_ERROR("Cannot write " << prefix << "_outages.tsv");
+    }
+
+    Ptr<PacketSink> sink1 = DynamicCast<PacketSink>(sinkApps.Get(0));
+    std::cout << "Total Bytes Received: " << sink1->GetTotalRx() << std::endl;
+
+    // Print FlowMonitor metrics
+    monitor->CheckForLostPackets();
+    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowMonitor.GetClassifier());
+    FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats();
+
+    for (auto const& entry : stats) {
+        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(entry.first);
+
+        std::cout << "Flow " << entry.first << " (" << t.sourceAddress << " -> " << t.destinationAddress << ")\n";
+        if (t.sourceAddress == sourceAddress && t.destinationAddress == sinkAddress) {
+            double duration = entry.second.timeLastRxPacket.GetSeconds() - entry.second.timeFirstTxPacket.GetSeconds();
+            if (duration > 0) {
+                std::cout << "  Throughput: " << entry.second.txBytes * 8.0 / duration / 1e6 << " Mbps\n";
+                std::cout << "  Total Data Sent: " << entry.second.txBytes << " bytes\n";
+                std::cout << "  Packets Sent: " << entry.second.txPackets << " packets\n";
+
+            } else {
+                std::cout << "  Throughput: N/A (duration is zero or negative)\n";
+            }
+            std::cout << "  Average Delay: " << entry.second.delaySum / entry.second.rxPackets << " seconds\n";
+            std::cout << "  Packet Loss: " << entry.second.lostPackets << " packets\n";
+            std::cout << "Simulation Stop: " << Simulator::Now().GetSeconds() << "s\n";
+        }
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/netanim-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/flow-monitor-module.h"
+#include "../../common/link_trace_analyzer.h"
+#include "../../common/trace_policy.h"
+#include "../../common/replication.h"
+#include "../../common/run_metrics.h"
+#include "../../common/fast_routing.h"
+#include "../../common/failure_injector.h"
+#include "../../common/aqm_helper.h"
+#include "../../common/event_profiler.h"
+
+// Network topology (default)
+//
+//        n2 n3 n4              .
+//         \ | /                .
+//          \|/                 .
+//     n1--- n0---n5            .
+//          /|\                 .
+//         / | \                .
+//        n8 n7 n6              .
+//
+// Star used by the Slide_1 TCP experiments. The congestion control TypeId is
+// a runtime option, e.g.
+//
+//   ./ns3 run "star_scenario --scenario=3 --tcp=ns3::TcpDctcp"
+//
+// Scenario 1 has no failures, scenario 2 takes every spoke interface down
+// between 2s and 4s, scenario 3 takes the first nDown spokes down between 2s
+// and 4s. --failures and --mtbf/--mttr add outages of the spokes ("spoke0",
+// "spoke1", ...) to any scenario; <prefix>_outages.tsv has the throughput at
+// the hub around each outage.
+//
+// --queue puts a queue disc on the spoke->hub side of every spoke link;
+// --queue=ECN is the step marking queue for DCTCP (marking at --ecnK
+// packets, ECN negotiated on every socket).
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("StarScenario");
+
+// "ns3::TcpCubic" -> "tcp_cubic", used in the output file names.
+static std::string
+VariantName (const std::string &tcp)
+{
+    std::string::size_type pos = tcp.rfind ("::");
+    std::string name = (pos == std::string::npos) ? tcp : tcp.substr (pos + 2);
+    std::string out;
+    for (std::string::size_type i = 0; i < name.size (); ++i)
+    {
+        char c = name[i];
+        if (std::isupper (static_cast<unsigned char> (c)))
+        {
+            if (i > 0)
+            {
+                out += '_';
+            }
+            c = static_cast<char> (std::tolower (static_cast<unsigned char> (c)));
+        }
+        out += c;
+    }
+    return out;
+}
+
+int main (int argc, char *argv[])
+{
+    // Set up some default values for the simulation.
+    Config::SetDefault ("ns3::OnOffApplication::PacketSize", UintegerValue (137));
+
+    // ??? try and stick 15kb/s into the data rate
+    Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue ("14kb/s"));
+
+    // Default number of nodes in the star.  Overridable by command line argument.
+    uint32_t nSpokes = 8;
+    uint32_t scenario = 1;
+    uint32_t nDown = 3;
+    std::string tcp = "ns3::TcpCubic";
+    std::string dataRate = "5Mbps";
+    std::string delay = "2ms";
+    std::string prefix = "";
+    TracePolicy tracePolicy ("full");
+    ReplicationOptions replication;
+    bool metrics = true;
+    bool profile = false;
+    std::string routing = "fast";
+    std::string queue = "FIFO";
+    std::string queueSize = "100p";
+    uint32_t ecnK = 5;
+    Ptr<FailureInjector> failures = Create<FailureInjector> ();
+
+    CommandLine cmd;
+    cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+    cmd.AddValue ("scenario", "1: no failures, 2: all spokes down 2-4s, 3: nDown spokes down 2-4s", scenario);
+    cmd.AddValue ("nDown", "Number of spokes taken down in scenario 3", nDown);
+    cmd.AddValue ("tcp", "Congestion control TypeId, e.g. ns3::TcpNewReno", tcp);
+    cmd.AddValue ("dataRate", "Spoke link data rate", dataRate);
+    cmd.AddValue ("delay", "Spoke link delay", delay);
+    cmd.AddValue ("prefix", "Output file prefix (default derived from scenario/tcp)", prefix);
+    tracePolicy.AddCommandLineOptions (cmd);
+    replication.AddCommandLineOptions (cmd);
+    cmd.AddValue ("metrics", "Write throughput/delay/loss of the run to <prefix>_metrics.tsv", metrics);
+    cmd.AddValue ("profile", "Write where the wall clock time goes per event type to <prefix>_profile.tsv", profile);
+    cmd.AddValue ("queue", "Spoke queue: FIFO (device DropTail), RED, FqCoDel, PIE or ECN (step marking at ecnK)", queue);
+    cmd.AddValue ("queueSize", "Spoke queue limit", queueSize);
+    cmd.AddValue ("ecnK", "Marking threshold of the ECN queue in packets", ecnK);
+    cmd.AddValue ("routing", "fast: static routes from the star layout, global: Ipv4GlobalRoutingHelper", routing);
+    failures->AddCommandLineOptions (cmd);
+    cmd.Parse (argc, argv);
+    tracePolicy.Validate ();
+    replication.Apply ();
+    if (profile)
+    {
+        EventProfiler::Enable (Seconds (0.1));
+    }
+
+    if (scenario < 1 || scenario > 3)
+    {
+        NS_FATAL_ERROR ("Unknown scenario " << scenario << ", expected 1, 2 or 3");
+    }
+    if (routing != "fast" && routing != "global")
+    {
+        NS_FATAL_ERROR ("Unknown routing " << routing << ", expected fast or global");
+    }
+    if (!AqmHelper::IsKnown (queue))
+    {
+        NS_FATAL_ERROR ("Unknown queue " << queue << ", expected FIFO, RED, FqCoDel, PIE or ECN");
+    }
+    AqmHelper aqm (queue, queueSize, ecnK);
+    TypeId tcpTid;
+    if (!TypeId::LookupByNameFailSafe (tcp, &tcpTid))
+    {
+        NS_FATAL_ERROR ("Unknown congestion control TypeId " << tcp);
+    }
+    if (prefix.empty ())
+    {
+        std::ostringstream oss;
+        oss << "slide_1_scenario_" << scenario << "_";
+        if (!aqm.IsFifo ())
+        {
+            oss << queue << "_";
+        }
+        oss << VariantName (tcp);
+        prefix = oss.str ();
+    }
+
+    // set TCP protocol
+    Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (tcpTid));
+    if (aqm.IsEcn ())
+    {
+        AqmHelper::EnableEcn ();
+    }
+
+    NS_LOG_INFO ("Build star topology.");
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+    pointToPoint.SetChannelAttribute ("Delay", StringValue (delay));
+    if (!aqm.IsFifo ())
+    {
+        pointToPoint.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue (aqm.GetDeviceQueueSize ()));
+    }
+    PointToPointStarHelper star (nSpokes, pointToPoint);
+
+    NS_LOG_INFO ("Install internet stack on all nodes.");
+    InternetStackHelper internet;
+    star.InstallStack (internet);
+    AssignStreamBlock (STREAM_STACK, internet.AssignStreams (NodeContainer::GetGlobal (), STREAM_STACK));
+
+    // The queue discs go on the spokes' devices, where each flow enters its
+    // link, before the addresses are assigned.
+    NetDeviceContainer spokeDevices;
+    for (uint32_t i = 0; i < star.SpokeCount (); ++i)
+    {
+        Ptr<Node> spoke = star.GetSpokeNode (i);
+        for (uint32_t j = 0; j < spoke->GetNDevices (); ++j)
+        {
+            if (DynamicCast<PointToPointNetDevice> (spoke->GetDevice (j)))
+            {
+                spokeDevices.Add (spoke->GetDevice (j));
+            }
+        }
+    }
+    QueueDiscContainer queueDiscs = aqm.Install (spokeDevices);
+    AssignStreamBlock (STREAM_QUEUE, AqmHelper::AssignStreams (queueDiscs, STREAM_QUEUE));
+
+    NS_LOG_INFO ("Assign IP Addresses.");
+    star.AssignIpv4Addresses (Ipv4AddressHelper ("10.1.1.0", "255.255.255.0"));
+
+    NS_LOG_INFO ("Create applications.");
+    //
+    // Create a packet sink on the star "hub" to receive packets.
+    //
+    uint16_t port = 50000;
+    Address hubLocalAddress (InetSocketAddress (Ipv4Address::GetAny (), port));
+    PacketSinkHelper packetSinkHelper ("ns3::TcpSocketFactory", hubLocalAddress);
+    ApplicationContainer hubApp = packetSinkHelper.Install (star.GetHub ());
+    hubApp.Start (Seconds (1.0));
+    hubApp.Stop (Seconds (10.0));
+
+    //
+    // Create OnOff applications to send TCP to the hub, one on each spoke node.
+    //
+    OnOffHelper onOffHelper ("ns3::TcpSocketFactory", Address ());
+    onOffHelper.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+    onOffHelper.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+
+    ApplicationContainer spokeApps;
+
+    for (uint32_t i = 0; i < star.SpokeCount (); ++i)
+    {
+        AddressValue remoteAddress (InetSocketAddress (star.GetHubIpv4Address (i), port));
+        onOffHelper.SetAttribute ("Remote", remoteAddress);
+        spokeApps.Add (onOffHelper.Install (star.GetSpokeNode (i)));
+    }
+    spokeApps.Start (Seconds (1.0));
+    spokeApps.Stop (Seconds (10.0));
+    AssignStreamBlock (STREAM_APPS, onOffHelper.AssignStreams (NodeContainer::GetGlobal (), STREAM_APPS));
+
+    NS_LOG_INFO ("Populate routing tables.");
+    //
+    // The hub reaches every spoke subnet directly, so each spoke only needs
+    // a default route to the hub; global routing gives the same tables but
+    // runs an SPF from every node.
+    //
+    if (routing == "fast")
+    {
+        FastRouting::PopulateStar (star);
+    }
+    else
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    }
+
+    NS_LOG_INFO ("Enable tracing.");
+    //
+    // Every flow ends at the hub, so the hub's devices are the bottleneck.
+    //
+    NetDeviceContainer hubDevices;
+    NetDeviceContainer allDevices;
+    for (uint32_t i = 0; i < star.GetHub ()->GetNDevices (); ++i)
+    {
+        Ptr<NetDevice> device = star.GetHub ()->GetDevice (i);
+        if (DynamicCast<PointToPointNetDevice> (device))
+        {
+            hubDevices.Add (device);
+            allDevices.Add (device);
+        }
+    }
+    allDevices.Add (spokeDevices);
+    tracePolicy.EnablePcap (prefix, allDevices, hubDevices);
+    tracePolicy.EnableAscii (pointToPoint, prefix + ".tr", allDevices, hubDevices);
+
+    Ptr<LinkTraceAnalyzer> analyzer;
+    if (tracePolicy.WantsSummary ())
+    {
+        analyzer = Create<LinkTraceAnalyzer> ();
+        analyzer->Attach (allDevices);
+    }
+
+    uint32_t firstSpoke = failures->AddStarSpokes (star);
+    if (scenario == 2)
+    {
+        nDown = star.SpokeCount ();
+    }
+    if (scenario == 2 || scenario == 3)
+    {
+        for (uint32_t i = 0; i < std::min (nDown, star.SpokeCount ()); ++i)
+        {
+            failures->AddOutage (firstSpoke + i, Seconds (2), Seconds (2));
+        }
+    }
+    failures->ApplyOptions (Seconds (1), Seconds (10));
+    if (routing == "fast")
+    {
+        // SetDown removes the spoke's static default route.
+        failures->SetInterfaceUpCallback (MakeCallback (&FastRouting::RestoreDefaultRoute));
+    }
+    failures->MonitorSinks (hubApp);
+    failures->Schedule ();
+
+    FlowMonitorHelper flowMonitor;
+    Ptr<FlowMonitor> monitor;
+    if (metrics)
+    {
+        monitor = flowMonitor.InstallAll ();
+    }
+
+    NS_LOG_INFO ("Run Simulation.");
+
+    // FlowMonitor checks for lost packets every second for as long as the
+    // run goes on, so the run needs an explicit end.
+    Simulator::Stop (Seconds (10.0));
+    Simulator::Run ();
+    if (profile && !EventProfiler::Write (prefix + "_profile.tsv", prefix + "_queue_depth.tsv"))
+    {
+        NS_FATAL_ERROR ("Cannot write " << prefix << "_profile.tsv");
+    }
+    if (monitor && !WriteRunMetrics (prefix + "_metrics.tsv", flowMonitor, monitor, port, replication))
+    {
+        NS_FATAL_ERROR ("Cannot write " << prefix << "_metrics.tsv");
+    }
+    if (monitor && queueDiscs.GetN () > 0 && !AqmHelper::AppendMetrics (prefix + "_metrics.tsv", queueDiscs))
+    {
+        NS_FATAL_ERROR ("Cannot write " << prefix << "_metrics.tsv");
+    }
+    if (analyzer && !analyzer->Write (prefix + "_summary.tsv"))
+    {
+        NS_FATAL_ERROR ("Cannot write " << prefix << "_summary.tsv");
+    }
+    if (failures->GetNOutages () > 0 && !failures->WriteReport (prefix + "_outages.tsv"))
+    {
+        NS_FATAL_ERROR ("Cannot write " << prefix << "_outages.tsv");
+    }
+    Simulator::Destroy ();
+    NS_LOG_INFO ("Done.");
+
+    return 0;
+}
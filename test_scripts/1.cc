@@ -4,10 +4,18 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/endpoint_flow_monitor.h"
 
 using namespace ns3;
 
-int main() {
+int main(int argc, char *argv[]) {
+    // all: FlowMonitor on every node; endpoints: only the node 0 -> node 21
+    // flow, probed on those two nodes.
+    std::string flowMonitorMode = "all";
+    CommandLine cmd;
+    cmd.AddValue("flowMonitor", "all or endpoints", flowMonitorMode);
+    cmd.Parse(argc, argv);
+
     NodeContainer nodes;
     nodes.Create(22); // 1 source, 1 Destination, 20 intermediate hops
 
@@ -46,21 +54,38 @@ int main() {
     clientApps.Start(Seconds(1.0));
     clientApps.Stop(Seconds(10000));
 
-    // Install FlowMonitor on all nodes
+    // Install FlowMonitor on all nodes, or only watch the flow of interest
+    // at its two ends
     FlowMonitorHelper flowMonitor;
-    Ptr<FlowMonitor> monitor = flowMonitor.InstallAll();
+    Ptr<FlowMonitor> monitor;
+    Ptr<EndpointFlowMonitor> endpointMonitor;
+    if (flowMonitorMode == "endpoints") {
+        endpointMonitor = Create<EndpointFlowMonitor>();
+        endpointMonitor->Watch(interfaces.GetAddress(21), port, interfaces.GetAddress(0));
+        endpointMonitor->Install(NodeContainer(nodes.Get(0), nodes.Get(21)));
+    } else {
+        monitor = flowMonitor.InstallAll();
+    }
 
     // Run the simulation
     Simulator::Stop(Seconds(10000));
     Simulator::Run();
 
-    monitor->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowMonitor.GetClassifier());
-    FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats();
+    FlowMonitor::FlowStatsContainer stats;
+    std::function<Ipv4FlowClassifier::FiveTuple(FlowId)> findFlow;
+    if (endpointMonitor) {
+        stats = endpointMonitor->GetFlowStats();
+        findFlow = [endpointMonitor](FlowId id) { return endpointMonitor->FindFlow(id); };
+    } else {
+        monitor->CheckForLostPackets();
+        Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowMonitor.GetClassifier());
+        stats = monitor->GetFlowStats();
+        findFlow = [classifier](FlowId id) { return classifier->FindFlow(id); };
+    }
     uint64_t totalBytesSent = 0; // Variable to store the total bytes sent
 
     for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin(); i != stats.end(); ++i) {
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(i->first);
+        Ipv4FlowClassifier::FiveTuple t = findFlow(i->first);
 
         if (t.sourceAddress == "10.1.1.1" && t.destinationAddress == "10.1.1.22") {
             // Only print metrics for the flow from source (10.1.1.1) to destination (10.1.1.22)
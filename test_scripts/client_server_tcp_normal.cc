@@ -6,6 +6,7 @@
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
@@ -19,10 +20,13 @@ int main(int argc, char *argv[])
 
     // Default number of nodes in the star.  Overridable by command line argument.
     uint32_t nSpokes = 8;
+    TracePolicy tracePolicy("full");
 
     CommandLine cmd;
     cmd.AddValue("nSpokes", "Number of nodes to place in the star", nSpokes);
+    tracePolicy.AddCommandLineOptions(cmd);
     cmd.Parse(argc, argv);
+    tracePolicy.Validate();
 
     NS_LOG_INFO("Build star topology.");
     PointToPointHelper pointToPoint;
@@ -69,7 +73,8 @@ int main(int argc, char *argv[])
     Ipv4GlobalRoutingHelper::PopulateRoutingTables();
 
     NS_LOG_INFO("Enable pcap tracing.");
-    pointToPoint.EnablePcapAll("star");
+    // Every flow ends at the hub, so the hub's devices are the bottleneck.
+    tracePolicy.EnablePcap("star", TracePolicy::Devices(NodeContainer::GetGlobal()), TracePolicy::Devices(star.GetHub()));
 
     // Add Flow Monitor
     NS_LOG_INFO("Enable Flow Monitor.");
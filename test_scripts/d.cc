@@ -4,6 +4,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
@@ -13,8 +14,13 @@ void DeleteNode(Ptr<Node> node) {
     std::cout << "Node deleted at t = " << Simulator::Now() << std::endl;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     // Initialize NS-3
+    TracePolicy tracePolicy("full");
+    CommandLine cmd;
+    tracePolicy.AddCommandLineOptions(cmd);
+    cmd.Parse(argc, argv);
+    tracePolicy.Validate();
 
     // Create nodes
     NodeContainer nodes;
@@ -56,9 +62,8 @@ int main() {
     //Simulator::Schedule(Seconds(5.0), &DeleteNode, nodeToDelete);
 
 
-    // Create a packet trace file
-    AsciiTraceHelper ascii;
-    pointToPoint.EnableAsciiAll(ascii.CreateFileStream("point-to-point_no_dispose.tr"));
+    // Create a packet trace file; the single link is its own bottleneck
+    tracePolicy.EnableAscii(pointToPoint, "point-to-point_no_dispose.tr", devices, devices);
 
     // Stop the simulation after scheduling node deletion
     Simulator::Stop();
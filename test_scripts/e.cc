@@ -23,6 +23,7 @@
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/trace_policy.h"
 
 // Network topology (default)
 //
@@ -56,10 +57,13 @@ main (int argc, char *argv[])
   // Default number of nodes in the star.  Overridable by command line argument.
   //
   uint32_t nSpokes = 8;
+  TracePolicy tracePolicy ("full");
 
   CommandLine cmd;
   cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+  tracePolicy.AddCommandLineOptions (cmd);
   cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
 
   NS_LOG_INFO ("Build star topology.");
   PointToPointHelper pointToPoint;
@@ -109,18 +113,18 @@ main (int argc, char *argv[])
   //
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-  NS_LOG_INFO ("Enable pcap tracing.");
+  NS_LOG_INFO ("Enable tracing.");
   //
-  // Do pcap tracing on all point-to-point devices on all nodes.
+  // Every flow ends at the hub, so the hub's devices are the bottleneck.
   //
-  pointToPoint.EnablePcapAll ("star");
+  NetDeviceContainer allDevices = TracePolicy::Devices (NodeContainer::GetGlobal ());
+  NetDeviceContainer hubDevices = TracePolicy::Devices (star.GetHub ());
+  tracePolicy.EnablePcap ("star", allDevices, hubDevices);
+  tracePolicy.EnableAscii (pointToPoint, "512_tcp.tr", allDevices, hubDevices);
     FlowMonitorHelper flowmon;
   Ptr<FlowMonitor> monitor = flowmon.Install(star.GetHub());
 
 
-  AsciiTraceHelper ascii;
-  pointToPoint.EnableAsciiAll(ascii.CreateFileStream("512_tcp.tr"));
-
   NS_LOG_INFO ("Run Simulation.");
   Simulator::Run ();
   Simulator::Destroy ();
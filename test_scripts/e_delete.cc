@@ -6,6 +6,7 @@
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/trace_policy.h"
 
 // Network topology (default)
 //
@@ -44,10 +45,13 @@ main (int argc, char *argv[])
   //
   // Default number of nodes in the star.  Overridable by command line argument.  //
   uint32_t nSpokes = 8;
+  TracePolicy tracePolicy ("full");
 
   CommandLine cmd;
   cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+  tracePolicy.AddCommandLineOptions (cmd);
   cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
 
   NS_LOG_INFO ("Build star topology.");
   PointToPointHelper pointToPoint;
@@ -97,11 +101,14 @@ main (int argc, char *argv[])
   //
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-  NS_LOG_INFO ("Enable pcap tracing.");
+  NS_LOG_INFO ("Enable tracing.");
   //
-  // Do pcap tracing on all point-to-point devices on all nodes.
+  // Every flow ends at the hub, so the hub's devices are the bottleneck.
   //
-  pointToPoint.EnablePcapAll ("star");
+  NetDeviceContainer allDevices = TracePolicy::Devices (NodeContainer::GetGlobal ());
+  NetDeviceContainer hubDevices = TracePolicy::Devices (star.GetHub ());
+  tracePolicy.EnablePcap ("star", allDevices, hubDevices);
+  tracePolicy.EnableAscii (pointToPoint, "512_tcp_no_del.tr", allDevices, hubDevices);
   //Ptr<Node> nodeToDelete = nSpokes.Get(1);
   //Ptr<Node> node = star.GetSpokeNode(1);
   //nodeToDelete->Dispose();
@@ -122,9 +129,6 @@ main (int argc, char *argv[])
 
 
 
-  AsciiTraceHelper ascii;
-  pointToPoint.EnableAsciiAll(ascii.CreateFileStream("512_tcp_no_del.tr"));
-
   NS_LOG_INFO ("Run Simulation.");
   Simulator::Stop(Seconds(10.0));
   //Simulator::Schedule(Seconds(5.0), &DeleteNode, star.GetSpokeNode(1));
@@ -7,6 +7,7 @@
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-helper.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/trace_policy.h"
 
 // Network topology (default)
 //
@@ -53,10 +54,13 @@ int main (int argc, char *argv[])
 
   // Default number of nodes in the star.  Overridable by command line argument.
   uint32_t nSpokes = 8;
+  TracePolicy tracePolicy ("full");
 
   CommandLine cmd;
   cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+  tracePolicy.AddCommandLineOptions (cmd);
   cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
 
   NS_LOG_INFO ("Build star topology.");
   PointToPointHelper pointToPoint;
@@ -107,14 +111,14 @@ int main (int argc, char *argv[])
   //
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-  NS_LOG_INFO ("Enable pcap tracing.");
+  NS_LOG_INFO ("Enable tracing.");
   //
-  // Do pcap tracing on all point-to-point devices on all nodes.
+  // Every flow ends at the hub, so the hub's devices are the bottleneck.
   //
-  pointToPoint.EnablePcapAll ("star");
-  //For ascii trace
-  AsciiTraceHelper ascii;
-  pointToPoint.EnableAsciiAll(ascii.CreateFileStream("e_delete_udp.tr"));
+  NetDeviceContainer allDevices = TracePolicy::Devices (NodeContainer::GetGlobal ());
+  NetDeviceContainer hubDevices = TracePolicy::Devices (star.GetHub ());
+  tracePolicy.EnablePcap ("star", allDevices, hubDevices);
+  tracePolicy.EnableAscii (pointToPoint, "e_delete_udp.tr", allDevices, hubDevices);
 
   NS_LOG_INFO ("Run Simulation.");
   //Simulator::Schedule (Seconds (2), SetInterfacesDown, star);
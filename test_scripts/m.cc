@@ -7,6 +7,8 @@
 #include "ns3/network-module.h"
 #include "ns3/packet-sink.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/latency_probe.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
@@ -14,13 +16,14 @@ NS_LOG_COMPONENT_DEFINE("TcpBulkSendExample");
 
 int main(int argc, char *argv[]) {
 
-    bool tracing = false;
+    TracePolicy tracePolicy("off");
     uint32_t maxBytes = 0;
 
     CommandLine cmd;
-    cmd.AddValue("tracing", "Flag to enable/disable tracing", tracing);
+    tracePolicy.AddCommandLineOptions(cmd);
     cmd.AddValue("maxBytes", "Total number of bytes for application to send", maxBytes);
     cmd.Parse(argc, argv);
+    tracePolicy.Validate();
 
     NS_LOG_INFO("Create nodes.");
     NodeContainer nodes;
@@ -33,7 +36,6 @@ int main(int argc, char *argv[]) {
     pointToPoint.SetChannelAttribute("Delay", StringValue("10ms"));
 pointToPoint.SetDeviceAttribute("Mtu", UintegerValue(1500)); // Set MTU to 1500 bytes
     //pointToPoint.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("500p"));
-    pointToPoint.EnablePcapAll("output-file-prefix");
 
     NetDeviceContainer devices;
 
@@ -82,14 +84,17 @@ for (uint32_t i = 0; i < 4; ++i) {
     sinkApps.Stop(Seconds(3000.0));
 
 
-    if (tracing) {
-        AsciiTraceHelper ascii;
-        pointToPoint.EnableAsciiAll(ascii.CreateFileStream("tcp-bulk-send.tr"));
-        pointToPoint.EnablePcapAll("tcp-bulk-send", false);
-    }
+    // The bulk flow runs over the first link.
+    NetDeviceContainer firstHop(devices.Get(0));
+    tracePolicy.EnableAscii(pointToPoint, "tcp-bulk-send.tr", devices, firstHop);
+    tracePolicy.EnablePcap("tcp-bulk-send", devices, firstHop);
 
     FlowMonitorHelper flowMonitor;
     Ptr<FlowMonitor> monitor = flowMonitor.InstallAll();
+    // Per-packet delay and jitter histograms, for the percentiles the
+    // FlowMonitor means hide
+    Ptr<LatencyProbe> latency = Create<LatencyProbe>();
+    latency->InstallAll();
 
     NS_LOG_INFO("Run Simulation.");
     Simulator::Stop(Seconds(3000.0));
@@ -123,10 +128,12 @@ for (uint32_t i = 0; i < 4; ++i) {
                 std::cout << "  Throughput: N/A (duration is zero or negative)\n";
             }
             std::cout << "  Average Delay: " << entry.second.delaySum / entry.second.rxPackets << " seconds\n";
+            latency->Print(std::cout, t);
             std::cout << "  Packet Loss: " << entry.second.lostPackets << " packets\n";
             std::cout << "Simulation Stop: " << Simulator::Now().GetSeconds() << "s\n";
         }
     }
+    latency->WriteFiles("m");
 
     Simulator::Destroy();
     return 0;
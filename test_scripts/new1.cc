@@ -3,10 +3,17 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/internet-module.h"
 #include "ns3/applications-module.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
-int main() {
+int main(int argc, char *argv[]) {
+  TracePolicy tracePolicy("full");
+  CommandLine cmd;
+  tracePolicy.AddCommandLineOptions(cmd);
+  cmd.Parse(argc, argv);
+  tracePolicy.Validate();
+
   // Create nodes
   NodeContainer nodes;
   nodes.Create(3);
@@ -47,8 +54,7 @@ int main() {
   staticRoutingTable->AddHostRouteTo(interfaces.GetAddress(2), 1); // Route to Node 2 via Node 1
 
   // Set up tracing
-  AsciiTraceHelper ascii;
-  p2p.EnableAsciiAll(ascii.CreateFileStream("multi_hop_tcp.tr"));
+  tracePolicy.EnableAscii(p2p, "multi_hop_tcp.tr", devices, devices);
 
   // Run the simulation
   Simulator::Run();
@@ -7,29 +7,38 @@
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-helper.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/incremental_routing.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("Star");
 
-void SetInterfacesDown(PointToPointStarHelper& star, const std::vector<uint32_t>& nodesToBringDown) {
+// With incremental routing the engine picks up the interface events itself
+// and applies the whole batch in one update; global routing has to be
+// recomputed from scratch.
+void SetInterfacesDown(PointToPointStarHelper& star, const std::vector<uint32_t>& nodesToBringDown, bool global) {
     for (uint32_t i : nodesToBringDown) {
         Ptr<Node> node = star.GetSpokeNode(i);
         Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
         uint32_t ifIndex = 1; // Assuming the first point-to-point interface, adjust if needed
         ipv4->SetDown(ifIndex);
     }
-    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    if (global) {
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    }
 }
 
-void SetInterfacesUp(PointToPointStarHelper& star, const std::vector<uint32_t>& nodesToBringUp) {
+void SetInterfacesUp(PointToPointStarHelper& star, const std::vector<uint32_t>& nodesToBringUp, bool global) {
     for (uint32_t i : nodesToBringUp) {
         Ptr<Node> node = star.GetSpokeNode(i);
         Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
         uint32_t ifIndex = 1; // Assuming the first point-to-point interface, adjust if needed
         ipv4->SetUp(ifIndex);
     }
-    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    if (global) {
+        Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    }
 }
 
 int main (int argc, char *argv[])
@@ -39,14 +48,28 @@ int main (int argc, char *argv[])
 
     // ??? try and stick 15kb/s into the data rate
     Config::SetDefault ("ns3::OnOffApplication::DataRate", StringValue ("14kb/s"));
-    Config::SetDefault ("ns3::Ipv4GlobalRouting::RespondToInterfaceEvents", BooleanValue (true));
 
     // Default number of nodes in the star.  Overridable by command line argument.
     uint32_t nSpokes = 8;
+    std::string routing = "incremental";
+
+    TracePolicy tracePolicy ("full");
 
     CommandLine cmd;
     cmd.AddValue ("nSpokes", "Number of nodes to place in the star", nSpokes);
+    cmd.AddValue ("routing", "incremental: update only the affected routes, global: recompute on every event", routing);
+    tracePolicy.AddCommandLineOptions (cmd);
     cmd.Parse (argc, argv);
+    tracePolicy.Validate ();
+    if (routing != "incremental" && routing != "global")
+    {
+        NS_FATAL_ERROR ("Unknown routing " << routing << ", expected incremental or global");
+    }
+    bool global = (routing == "global");
+    if (global)
+    {
+        Config::SetDefault ("ns3::Ipv4GlobalRouting::RespondToInterfaceEvents", BooleanValue (true));
+    }
 
     NS_LOG_INFO ("Build star topology.");
     PointToPointHelper pointToPoint;
@@ -90,31 +113,37 @@ int main (int argc, char *argv[])
     spokeApps.Start (Seconds (1.0));
     spokeApps.Stop (Seconds (10.0));
 
-    NS_LOG_INFO ("Enable static global routing.");
-    //
-    // Turn on global static routing so we can actually be routed across the star.
-    //
-    Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    NS_LOG_INFO ("Populate routing tables.");
+    Ptr<IncrementalRouting> incremental;
+    if (global)
+    {
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    }
+    else
+    {
+        incremental = Create<IncrementalRouting> ();
+        incremental->Install ();
+    }
 
-    NS_LOG_INFO ("Enable pcap tracing."); 
+    NS_LOG_INFO ("Enable tracing."); 
     LogComponentEnableAll(LOG_LEVEL_INFO);
     //
-    // Do pcap tracing on all point-to-point devices on all nodes.
+    // Every flow ends at the hub, so the hub's devices are the bottleneck.
     //
-    pointToPoint.EnablePcapAll ("star-new");
-    //For ascii trace
-    AsciiTraceHelper ascii;
-    pointToPoint.EnableAsciiAll(ascii.CreateFileStream("slide_1_scenario_2_tcp.tr"));
+    NetDeviceContainer allDevices = TracePolicy::Devices (NodeContainer::GetGlobal ());
+    NetDeviceContainer hubDevices = TracePolicy::Devices (star.GetHub ());
+    tracePolicy.EnablePcap ("star-new", allDevices, hubDevices);
+    tracePolicy.EnableAscii (pointToPoint, "slide_1_scenario_2_tcp.tr", allDevices, hubDevices);
 
     FlowMonitorHelper flowmonHelper;
     //Ptr<FlowMonitor> flowmon = flowmonHelper.Install(star.GetHub()); 
 
 
     std::vector<uint32_t> nodesToBringDown = {0, 1, 2};
-    Simulator::Schedule (Seconds (2), SetInterfacesDown, star, nodesToBringDown);
+    Simulator::Schedule (Seconds (2), SetInterfacesDown, star, nodesToBringDown, global);
     
     std::vector<uint32_t> nodesToBringUp = {0, 1, 2}; // Adjust as needed
-    Simulator::Schedule (Seconds (4), SetInterfacesUp, star, nodesToBringUp); 
+    Simulator::Schedule (Seconds (4), SetInterfacesUp, star, nodesToBringUp, global);
 
     NS_LOG_INFO ("Run Simulation.");
 
@@ -122,6 +151,10 @@ int main (int argc, char *argv[])
     //Simulator::Schedule (Seconds (4), SetInterfacesUp, star);
 
     Simulator::Run ();
+    if (incremental)
+    {
+        incremental->PrintStats (std::cout);
+    }
     Simulator::Destroy ();
     NS_LOG_INFO ("Done.");
 
@@ -3,6 +3,7 @@
 #include "ns3/internet-module.h"
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
@@ -10,8 +11,11 @@ NS_LOG_COMPONENT_DEFINE ("LargeFileTransfer");
 
 int main (int argc, char *argv[])
 {
+  TracePolicy tracePolicy ("full");
   CommandLine cmd;
+  tracePolicy.AddCommandLineOptions (cmd);
   cmd.Parse (argc, argv);
+  tracePolicy.Validate ();
 
   // Set up nodes
   NodeContainer nodes;
@@ -49,7 +53,7 @@ int main (int argc, char *argv[])
   clientApps.Stop (Seconds (10.0));
 
   // Enable packet capturing on the server
-  pointToPoint.EnablePcapAll ("large_file_transfer");
+  tracePolicy.EnablePcap ("large_file_transfer", devices, devices);
 
   // Run the simulation
   Simulator::Run ();
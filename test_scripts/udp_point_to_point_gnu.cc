@@ -4,9 +4,17 @@
 #include "ns3/internet-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/flow_snapshot.h"
+#include "../common/latency_probe.h"
 #include "ns3/gnuplot.h"
 
-int main() {
+int main(int argc, char *argv[]) {
+    // Interval of the per-flow counter snapshots behind the throughput plot.
+    double snapshotInterval = 0.5;
+    ns3::CommandLine cmd;
+    cmd.AddValue("snapshotInterval", "Seconds between FlowMonitor snapshots", snapshotInterval);
+    cmd.Parse(argc, argv);
+
     // Creates a container to hold ns3 nodes.
     ns3::NodeContainer nodes;
     // create two nodes
@@ -52,15 +60,32 @@ int main() {
     // Install and configure the flow-level monitor to collect flow-level statistics.
     ns3::FlowMonitorHelper flowMonitor;
     ns3::Ptr<ns3::FlowMonitor> monitor = flowMonitor.InstallAll();
+    // Per-packet delay and jitter histograms, for the percentiles the
+    // FlowMonitor means hide
+    ns3::Ptr<ns3::LatencyProbe> latency = ns3::Create<ns3::LatencyProbe>();
+    latency->InstallAll();
+
+    // Streams what each flow's counters gained every snapshotInterval.
+    ns3::Ptr<ns3::Ipv4FlowClassifier> classifier = ns3::DynamicCast<ns3::Ipv4FlowClassifier>(flowMonitor.GetClassifier());
+    std::string snapshotFileName = "udp_point_to_point_gnu.snap";
+    ns3::Ptr<ns3::FlowSnapshotWriter> snapshots = ns3::Create<ns3::FlowSnapshotWriter>(monitor, classifier, ns3::Seconds(snapshotInterval));
+    if (!snapshots->Open(snapshotFileName)) {
+        std::cerr << "Cannot write " << snapshotFileName << "\n";
+        return 1;
+    }
+    snapshots->Start(ns3::Seconds(0.0), ns3::Seconds(20.0));
 
     ns3::Simulator::Stop(ns3::Seconds(20.0));
     ns3::Simulator::Run();
+    if (!snapshots->Finish()) {
+        std::cerr << "Cannot write " << snapshotFileName << "\n";
+        return 1;
+    }
 
     // Checks for the Lost packets.
     monitor->CheckForLostPackets();
 
     // Retrieves flow statistics from Flow Monitor
-    ns3::Ptr<ns3::Ipv4FlowClassifier> classifier = ns3::DynamicCast<ns3::Ipv4FlowClassifier>(flowMonitor.GetClassifier());
     ns3::FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats();
 
     // Create a Gnuplot object
@@ -75,19 +100,23 @@ int main() {
     gnuplot.SetTerminal("png");
     gnuplot.SetLegend("Time (s)", "Throughput (Mbps)");
 
+    // One throughput point per flow and snapshot interval.
+    std::map<ns3::FlowId, ns3::Gnuplot2dDataset> series;
+    FlowSnapshotFileHeader snapshotHeader;
+    ForEachFlowSnapshot(snapshotFileName.c_str(), snapshotHeader, [&series](const FlowSnapshotRecord &r, int64_t durationNs) {
+        series[r.flow].Add(r.timeNs / 1e9, r.rxBytes * 8.0 / durationNs * 1e3);
+    });
+
     // Inside your simulation loop
     for (auto it = stats.begin(); it != stats.end(); ++it) {
-        double time = ns3::Simulator::Now().GetSeconds();
         double throughput = it->second.rxBytes * 8.0 / 20.0 / 1000 / 1000;
 
 	ns3::Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(it->first);
 
-        // Create the 2-D dataset.
-        ns3::Gnuplot2dDataset dataset;
+        // The 2-D dataset of the flow's snapshots.
+        ns3::Gnuplot2dDataset &dataset = series[it->first];
         dataset.SetTitle(dataTitle);
-        dataset.SetStyle(ns3::Gnuplot2dDataset::POINTS);
-        dataset.SetErrorBars(ns3::Gnuplot2dDataset::XY);
-        dataset.Add(time, throughput, 0.0, 0.0);
+        dataset.SetStyle(ns3::Gnuplot2dDataset::LINES_POINTS);
 
         // Add the dataset to the plot.
         gnuplot.AddDataset(dataset);
@@ -98,9 +127,12 @@ int main() {
     std::cout << "  Packet Loss: " << it->second.lostPackets << "\n";
     std::cout << "  Packet Loss Ratio: " << it->second.lostPackets / static_cast<double>(it->second.txPackets) << "\n";
     std::cout << "  Delay: " << it->second.delaySum / it->second.rxPackets << " seconds\n";
+    latency->Print(std::cout, t);
 
     }
 
+    latency->WriteFiles("udp_point_to_point_gnu");
+
     // Open the plot file.
     std::ofstream plotFile(plotFileName.c_str());
 
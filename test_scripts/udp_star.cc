@@ -6,6 +6,7 @@
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/flow-monitor-module.h"
+#include "../common/trace_policy.h"
 
 using namespace ns3;
 
@@ -22,10 +23,13 @@ int main(int argc, char *argv[]) {
   // Default number of nodes in the star.  Overridable by command line argument.
   //
   uint32_t nSpokes = 8;
+  TracePolicy tracePolicy("full");
 
   CommandLine cmd;
   cmd.AddValue("nSpokes", "Number of nodes to place in the star", nSpokes);
+  tracePolicy.AddCommandLineOptions(cmd);
   cmd.Parse(argc, argv);
+  tracePolicy.Validate();
 
   NS_LOG_INFO("Build star topology.");
   PointToPointHelper pointToPoint;
@@ -80,9 +84,9 @@ int main(int argc, char *argv[]) {
 
   NS_LOG_INFO("Enable pcap tracing.");
   //
-  // Do pcap tracing on all point-to-point devices on all nodes.
+  // Every flow ends at the hub, so the hub's devices are the bottleneck.
   //
-  pointToPoint.EnablePcapAll("star");
+  tracePolicy.EnablePcap("star", TracePolicy::Devices(NodeContainer::GetGlobal()), TracePolicy::Devices(star.GetHub()));
 
   NS_LOG_INFO("Run Simulation.");
   Simulator::Stop(Seconds(10.0));
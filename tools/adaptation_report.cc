@@ -0,0 +1,241 @@
+// Compares how variants adapt to capacity changes, from the
+// <prefix>_adaptation.tsv files of the runs (common/adaptation_monitor.h).
+//
+//   g++ -std=c++17 -O2 -o adaptation_report tools/adaptation_report.cc
+//   ./adaptation_report --dir=results --where=slide=6 --where=scenario=2
+//   ./adaptation_report --dir=results --group-by=queue
+//
+// Prints one line per group (the tcp key by default) and rate change: the
+// flows seen, the mean re-convergence time of the ones that re-converged
+// and the share that did, and the mean peak queueing delay, drops and lost
+// utilization of the transitions.
+
+#include <dirent.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+static void
+Usage ()
+{
+  std::cerr << "usage: adaptation_report --dir=DIR... [--where=KEY=VALUE]... [--group-by=KEY]\n";
+}
+
+struct Group
+{
+  Group ()
+    : flows (0),
+      converged (0),
+      reconverge (0),
+      transitions (0),
+      peakDelay (0),
+      drops (0),
+      lostUtil (0)
+  {
+  }
+
+  uint32_t flows;
+  uint32_t converged;
+  double reconverge;     // sum over the converged flows
+  uint32_t transitions;  // one per file and change
+  double peakDelay;
+  double drops;
+  double lostUtil;
+  std::string rates;     // "old->new", from the first file
+};
+
+static std::vector<std::string>
+Split (const std::string &line)
+{
+  std::vector<std::string> fields;
+  std::istringstream iss (line);
+  std::string field;
+  while (std::getline (iss, field, '\t'))
+    {
+      fields.push_back (field);
+    }
+  return fields;
+}
+
+// Adds the rows of one file to the groups it matches. False when the file
+// cannot be read or has no adaptation header.
+static bool
+ReadFile (const std::string &path, const std::vector<std::pair<std::string, std::string> > &where,
+          const std::string &groupBy, std::map<std::pair<std::string, uint32_t>, Group> &groups)
+{
+  std::ifstream in (path.c_str ());
+  if (!in)
+    {
+      return false;
+    }
+  std::map<std::string, std::string> meta;
+  std::map<std::string, uint32_t> columns;
+  std::string line;
+  while (std::getline (in, line))
+    {
+      if (line.compare (0, 2, "# ") == 0)
+        {
+          std::string::size_type eq = line.find ('=');
+          if (eq != std::string::npos)
+            {
+              meta[line.substr (2, eq - 2)] = line.substr (eq + 1);
+            }
+          continue;
+        }
+      std::vector<std::string> fields = Split (line);
+      for (uint32_t i = 0; i < fields.size (); ++i)
+        {
+          columns[fields[i]] = i;
+        }
+      break;
+    }
+  const char *needed[] = { "change", "old_mbps", "new_mbps", "reconverge_s", "peak_qdelay_ms", "drops", "lost_util" };
+  for (const char *name : needed)
+    {
+      if (columns.find (name) == columns.end ())
+        {
+          return false;
+        }
+    }
+  for (const std::pair<std::string, std::string> &kv : where)
+    {
+      if (meta[kv.first] != kv.second)
+        {
+          return true;
+        }
+    }
+
+  // The transition values repeat on every flow line of a change; they are
+  // counted once per change.
+  std::string key = meta[groupBy];
+  int64_t lastChange = -1;
+  while (std::getline (in, line))
+    {
+      std::vector<std::string> fields = Split (line);
+      if (fields.size () < columns.size ())
+        {
+          continue;
+        }
+      uint32_t change = std::strtoul (fields[columns["change"]].c_str (), 0, 10);
+      Group &group = groups[std::make_pair (key, change)];
+      if (group.rates.empty ())
+        {
+          group.rates = fields[columns["old_mbps"]] + "->" + fields[columns["new_mbps"]];
+        }
+      ++group.flows;
+      const std::string &reconverge = fields[columns["reconverge_s"]];
+      if (reconverge != "-")
+        {
+          ++group.converged;
+          group.reconverge += std::atof (reconverge.c_str ());
+        }
+      if (int64_t (change) != lastChange)
+        {
+          lastChange = change;
+          ++group.transitions;
+          group.peakDelay += std::atof (fields[columns["peak_qdelay_ms"]].c_str ());
+          group.drops += std::atof (fields[columns["drops"]].c_str ());
+          group.lostUtil += std::atof (fields[columns["lost_util"]].c_str ());
+        }
+    }
+  return true;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::vector<std::string> dirs;
+  std::vector<std::pair<std::string, std::string> > where;
+  std::string groupBy = "tcp";
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 6, "--dir=") == 0)
+        {
+          dirs.push_back (arg.substr (6));
+        }
+      else if (arg.compare (0, 8, "--where=") == 0)
+        {
+          std::string kv = arg.substr (8);
+          std::string::size_type eq = kv.find ('=');
+          if (eq == std::string::npos)
+            {
+              Usage ();
+              return 2;
+            }
+          where.push_back (std::make_pair (kv.substr (0, eq), kv.substr (eq + 1)));
+        }
+      else if (arg.compare (0, 11, "--group-by=") == 0)
+        {
+          groupBy = arg.substr (11);
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (dirs.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+
+  static const std::string suffix = "_adaptation.tsv";
+  std::map<std::pair<std::string, uint32_t>, Group> groups;
+  uint32_t nFiles = 0;
+  for (const std::string &dir : dirs)
+    {
+      DIR *d = ::opendir (dir.c_str ());
+      if (!d)
+        {
+          std::cerr << "Cannot open " << dir << std::endl;
+          return 1;
+        }
+      while (struct dirent *entry = ::readdir (d))
+        {
+          std::string name = entry->d_name;
+          if (name.size () <= suffix.size ()
+              || name.compare (name.size () - suffix.size (), suffix.size (), suffix) != 0)
+            {
+              continue;
+            }
+          if (!ReadFile (dir + "/" + name, where, groupBy, groups))
+            {
+              std::cerr << dir << "/" << name << ": not an adaptation file" << std::endl;
+              continue;
+            }
+          ++nFiles;
+        }
+      ::closedir (d);
+    }
+
+  std::cout << groupBy << "\tchange\trates\ttransitions\tflows\tconverged\treconverge_s\tpeak_qdelay_ms\tdrops\tlost_util\n";
+  for (std::map<std::pair<std::string, uint32_t>, Group>::const_iterator it = groups.begin ();
+       it != groups.end (); ++it)
+    {
+      const Group &group = it->second;
+      std::cout << it->first.first << "\t" << it->first.second << "\t" << group.rates << "\t"
+                << group.transitions << "\t" << group.flows << "\t"
+                << double (group.converged) / group.flows << "\t";
+      if (group.converged)
+        {
+          std::cout << group.reconverge / group.converged;
+        }
+      else
+        {
+          std::cout << "-";
+        }
+      std::cout << "\t" << group.peakDelay / group.transitions << "\t" << group.drops / group.transitions
+                << "\t" << group.lostUtil / group.transitions << "\n";
+    }
+  std::cerr << nFiles << " files" << std::endl;
+  return 0;
+}
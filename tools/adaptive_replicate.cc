@@ -0,0 +1,513 @@
+// Replicates every cell of a sweep until its metrics are known well
+// enough: a cell stops as soon as the 95% confidence interval half-width of
+// each target metric is below its threshold, so stable cells finish after a
+// few replications and noisy ones get more.
+//
+//   g++ -std=c++17 -O2 -o adaptive_replicate tools/adaptive_replicate.cc
+//   ./adaptive_replicate --program=<built csma_bus_scenario> --out=adaptive
+//       --target=throughput_mbps:2% --target=delay_ms:5% --nClients=10,20,30,40,50,60
+//
+// The built-in cells are the slide 4 presets (2a, 2b, 3, 4) x the four TCP
+// variants, optionally crossed with --nClients; --cells=FILE replaces them
+// with "<id> <arguments...>" lines. A target is METRIC:WIDTH with an
+// absolute half-width, or METRIC:WIDTH% relative to the mean; the metrics
+// are the ones of <prefix>_metrics.tsv (common/run_metrics.h), and a target
+// naming none of them stops the command after the first round.
+//
+// Runs get --trace=off unless --trace=LEVEL says otherwise (an empty level
+// passes nothing, for programs without the option); cell arguments and
+// --extra come after it and win.
+//
+// Replications run in rounds of up to --jobs processes. Every cell gets
+// --min-reps first and never more than --max-reps. A replication that runs
+// longer than --timeout=SECONDS is killed and its cell counts as failed. Results live in
+// <out>/<cell>/run<k>/ and are reused when the command is repeated.
+
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "process_pool.h"
+#include "replication_stats.h"
+
+static const char *g_variants[] = { "TcpCubic", "TcpDctcp", "TcpNewReno", "TcpWestwood" };
+
+struct Target
+{
+  std::string metric;
+  double width;
+  bool relative;
+};
+
+struct Cell
+{
+  std::string id;
+  std::vector<std::string> args;
+  double weight;
+  unsigned reps;                  // replications launched so far
+  bool active;
+  std::string state;              // converged, max-reps or failed once inactive
+  std::map<std::string, SampleStats> stats;
+};
+
+static std::vector<std::string>
+Split (const std::string &s, char sep)
+{
+  std::vector<std::string> parts;
+  std::istringstream iss (s);
+  std::string part;
+  while (std::getline (iss, part, sep))
+    {
+      if (!part.empty ())
+        {
+          parts.push_back (part);
+        }
+    }
+  return parts;
+}
+
+static void
+AddSlide4Cells (const std::vector<std::string> &clientCounts, std::vector<Cell> &cells)
+{
+  // scenario, relative cost (clients x simulated seconds)
+  struct Preset
+  {
+    const char *scenario;
+    double clients;
+    double seconds;
+  };
+  static const Preset presets[] = {
+    { "2a", 30, 10 }, { "2b", 30, 10 }, { "3", 60, 100 }, { "4", 60, 100 },
+  };
+  std::vector<std::string> counts = clientCounts;
+  if (counts.empty ())
+    {
+      counts.push_back ("");
+    }
+  for (const Preset &preset : presets)
+    {
+      for (const std::string &count : counts)
+        {
+          for (const char *variant : g_variants)
+            {
+              Cell cell;
+              cell.id = std::string ("Slide4_scen") + preset.scenario + "_" + variant;
+              cell.args.push_back ("--slide=4");
+              cell.args.push_back (std::string ("--scenario=") + preset.scenario);
+              cell.args.push_back (std::string ("--tcp=ns3::") + variant);
+              cell.weight = preset.clients * preset.seconds;
+              if (!count.empty ())
+                {
+                  cell.id += "_n" + count;
+                  cell.args.push_back ("--nClients=" + count);
+                  cell.weight = std::atof (count.c_str ()) * preset.seconds;
+                }
+              cells.push_back (cell);
+            }
+        }
+    }
+}
+
+static bool
+LoadCellsFile (const std::string &path, std::vector<Cell> &cells)
+{
+  std::ifstream in (path.c_str ());
+  if (!in)
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (in, line))
+    {
+      std::istringstream iss (line);
+      Cell cell;
+      if (!(iss >> cell.id) || cell.id[0] == '#')
+        {
+          continue;
+        }
+      if (!PoolValidId (cell.id))
+        {
+          std::cerr << path << ": run id \"" << cell.id << "\" has to be a relative path of plain names, without '.', '..', backslashes, quotes or '$'" << std::endl;
+          return false;
+        }
+      std::string arg;
+      while (iss >> arg)
+        {
+          cell.args.push_back (arg);
+        }
+      cell.weight = 1.0;
+      cells.push_back (cell);
+    }
+  return true;
+}
+
+static bool
+ParseTarget (const std::string &spec, Target &target)
+{
+  std::string::size_type colon = spec.rfind (':');
+  if (colon == std::string::npos || colon + 1 >= spec.size ())
+    {
+      return false;
+    }
+  target.metric = spec.substr (0, colon);
+  std::string width = spec.substr (colon + 1);
+  target.relative = width[width.size () - 1] == '%';
+  target.width = std::atof (width.c_str ()) / (target.relative ? 100.0 : 1.0);
+  return target.width > 0;
+}
+
+static bool
+MeetsTargets (const Cell &cell, const std::vector<Target> &targets)
+{
+  for (const Target &target : targets)
+    {
+      std::map<std::string, SampleStats>::const_iterator it = cell.stats.find (target.metric);
+      if (it == cell.stats.end () || it->second.n < 2)
+        {
+          return false;
+        }
+      double limit = target.relative ? target.width * std::fabs (it->second.mean) : target.width;
+      if (!(it->second.halfWidth <= limit))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+// The first metrics file read decides which target names exist.
+static bool
+CheckTargets (const std::map<std::string, double> &metrics, const std::vector<Target> &targets)
+{
+  bool ok = true;
+  for (const Target &target : targets)
+    {
+      if (!metrics.count (target.metric))
+        {
+          std::cerr << "unknown target metric \"" << target.metric << "\"" << std::endl;
+          ok = false;
+        }
+    }
+  if (!ok)
+    {
+      std::cerr << "the runs report:";
+      for (std::map<std::string, double>::const_iterator it = metrics.begin (); it != metrics.end (); ++it)
+        {
+          std::cerr << " " << it->first;
+        }
+      std::cerr << std::endl;
+    }
+  return ok;
+}
+
+static std::string
+AbsolutePath (const std::string &path)
+{
+  if (path.find ('/') == std::string::npos)
+    {
+      return path; // resolved through PATH
+    }
+  char buf[PATH_MAX];
+  return realpath (path.c_str (), buf) ? std::string (buf) : path;
+}
+
+static void
+Usage ()
+{
+  std::cerr << "usage: adaptive_replicate --program=PATH [--cells=FILE] [--nClients=N,N,...]\n"
+               "                          [--target=METRIC:WIDTH[%]]... [--min-reps=N] [--max-reps=N]\n"
+               "                          [--seed=S] [--out=DIR] [--jobs=N] [--trace=LEVEL] [--extra=ARG]...\n"
+               "                          [--timeout=S] [--filter=SUBSTR]\n";
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string program;
+  std::string cellsFile;
+  std::string out = "adaptive";
+  std::string filter;
+  std::string trace = "off";
+  double timeout = 0;
+  std::vector<std::string> clientCounts;
+  std::vector<Target> targets;
+  std::vector<std::string> extra;
+  unsigned minReps = 3;
+  unsigned maxReps = 50;
+  unsigned seed = 1;
+  unsigned jobs = std::thread::hardware_concurrency ();
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      std::string::size_type eq = arg.find ('=');
+      std::string key = arg.substr (0, eq);
+      std::string value = (eq == std::string::npos) ? "" : arg.substr (eq + 1);
+      Target target;
+      if (key == "--program")
+        {
+          program = value;
+        }
+      else if (key == "--cells")
+        {
+          cellsFile = value;
+        }
+      else if (key == "--nClients")
+        {
+          clientCounts = Split (value, ',');
+        }
+      else if (key == "--target" && ParseTarget (value, target))
+        {
+          targets.push_back (target);
+        }
+      else if (key == "--min-reps")
+        {
+          minReps = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--max-reps")
+        {
+          maxReps = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--seed")
+        {
+          seed = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--out")
+        {
+          out = value;
+        }
+      else if (key == "--jobs")
+        {
+          jobs = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--trace")
+        {
+          trace = value;
+        }
+      else if (key == "--timeout")
+        {
+          timeout = std::atof (value.c_str ());
+        }
+      else if (key == "--extra")
+        {
+          extra.push_back (value);
+        }
+      else if (key == "--filter")
+        {
+          filter = value;
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (program.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+  program = AbsolutePath (program);
+  jobs = jobs ? jobs : 1;
+  minReps = std::max (minReps, 2u);
+  maxReps = std::max (maxReps, minReps);
+  if (targets.empty ())
+    {
+      Target target;
+      ParseTarget ("throughput_mbps:5%", target);
+      targets.push_back (target);
+      ParseTarget ("delay_ms:5%", target);
+      targets.push_back (target);
+    }
+
+  std::vector<Cell> cells;
+  if (!cellsFile.empty ())
+    {
+      if (!LoadCellsFile (cellsFile, cells))
+        {
+          std::cerr << "cannot read " << cellsFile << std::endl;
+          return 2;
+        }
+    }
+  else
+    {
+      AddSlide4Cells (clientCounts, cells);
+    }
+  std::vector<Cell> kept;
+  for (Cell &cell : cells)
+    {
+      if (filter.empty () || cell.id.find (filter) != std::string::npos)
+        {
+          cell.reps = 0;
+          cell.active = true;
+          kept.push_back (cell);
+        }
+    }
+  cells.swap (kept);
+
+  ProcessPool pool (out, jobs);
+  pool.SetVerbose (false);
+  pool.SetTimeout (timeout);
+  unsigned round = 0;
+  bool targetsChecked = false;
+  while (true)
+    {
+      unsigned active = 0;
+      for (const Cell &cell : cells)
+        {
+          active += cell.active ? 1 : 0;
+        }
+      if (active == 0)
+        {
+          break;
+        }
+      // Enough replications per cell to keep every slot busy this round.
+      unsigned batch = std::max (1u, jobs / active);
+
+      std::vector<PoolRun> runs;
+      std::vector<size_t> owner;
+      for (size_t c = 0; c < cells.size (); ++c)
+        {
+          Cell &cell = cells[c];
+          if (!cell.active)
+            {
+              continue;
+            }
+          unsigned want = std::min (maxReps, std::max (minReps, cell.reps + batch));
+          for (unsigned k = cell.reps + 1; k <= want; ++k)
+            {
+              PoolRun run;
+              run.id = cell.id + "/run" + std::to_string (k);
+              run.argv.push_back (program);
+              if (!trace.empty ())
+                {
+                  run.argv.push_back ("--trace=" + trace);
+                }
+              run.argv.insert (run.argv.end (), cell.args.begin (), cell.args.end ());
+              run.argv.insert (run.argv.end (), extra.begin (), extra.end ());
+              run.argv.push_back ("--seed=" + std::to_string (seed));
+              run.argv.push_back ("--run=" + std::to_string (k));
+              run.argv.push_back ("--prefix=run");
+              run.weight = cell.weight;
+              runs.push_back (run);
+              owner.push_back (c);
+            }
+          cell.reps = want;
+        }
+
+      if (pool.Run (runs) < 0)
+        {
+          return 130;
+        }
+      round++;
+
+      for (size_t r = 0; r < runs.size (); ++r)
+        {
+          if (runs[r].status != 0 && cells[owner[r]].active)
+            {
+              cells[owner[r]].active = false;
+              cells[owner[r]].state = "failed";
+              std::cerr << runs[r].id << " failed, see " << runs[r].dir << "/run.log" << std::endl;
+            }
+        }
+      for (Cell &cell : cells)
+        {
+          if (!cell.active)
+            {
+              continue;
+            }
+          std::map<std::string, std::vector<double> > samples;
+          for (unsigned k = 1; k <= cell.reps; ++k)
+            {
+              std::map<std::string, double> metrics;
+              if (ReadRunMetrics (out + "/" + cell.id + "/run" + std::to_string (k) + "/run_metrics.tsv", metrics))
+                {
+                  if (!targetsChecked)
+                    {
+                      if (!CheckTargets (metrics, targets))
+                        {
+                          return 2;
+                        }
+                      targetsChecked = true;
+                    }
+                  for (const Target &target : targets)
+                    {
+                      if (metrics.count (target.metric))
+                        {
+                          samples[target.metric].push_back (metrics[target.metric]);
+                        }
+                    }
+                }
+            }
+          cell.stats.clear ();
+          for (std::map<std::string, std::vector<double> >::const_iterator it = samples.begin ();
+               it != samples.end (); ++it)
+            {
+              cell.stats[it->first] = ComputeSampleStats (it->second);
+            }
+          if (MeetsTargets (cell, targets))
+            {
+              cell.active = false;
+              cell.state = "converged";
+            }
+          else if (cell.reps >= maxReps)
+            {
+              cell.active = false;
+              cell.state = "max-reps";
+            }
+        }
+      std::cout << "round " << round << ": " << runs.size () << " runs, "
+                << active << " cells were open" << std::endl;
+    }
+
+  std::ofstream summary ((out + "/adaptive_summary.tsv").c_str ());
+  std::ostream *streams[] = { &std::cout, &summary };
+  unsigned total = 0;
+  for (const Cell &cell : cells)
+    {
+      total += cell.reps;
+    }
+  for (std::ostream *os : streams)
+    {
+      *os << "cell\treps\tstate";
+      for (const Target &target : targets)
+        {
+          *os << "\t" << target.metric << "_mean\t" << target.metric << "_ci95";
+        }
+      *os << "\n";
+      for (const Cell &cell : cells)
+        {
+          *os << cell.id << "\t" << cell.reps << "\t" << cell.state;
+          for (const Target &target : targets)
+            {
+              std::map<std::string, SampleStats>::const_iterator it = cell.stats.find (target.metric);
+              if (it == cell.stats.end ())
+                {
+                  *os << "\t-\t-";
+                }
+              else
+                {
+                  *os << "\t" << it->second.mean << "\t" << it->second.halfWidth;
+                }
+            }
+          *os << "\n";
+        }
+    }
+  std::cout << total << " replications over " << cells.size () << " cells" << std::endl;
+  unsigned failedCells = 0;
+  for (const Cell &cell : cells)
+    {
+      failedCells += cell.state == "failed" ? 1 : 0;
+    }
+  if (failedCells)
+    {
+      std::cerr << failedCells << " cells failed" << std::endl;
+    }
+  return failedCells == 0 ? 0 : 1;
+}
@@ -0,0 +1,690 @@
+// Performance benchmark of the scenario programs, with regression checks
+// against a stored baseline.
+//
+// Every scenario family has a small, a medium and a large canonical
+// instance:
+//
+//   two_hop   slide 5 dumbbell: one flow for 10s; Cubic + NewReno x 4 flows
+//             for 30s; Cubic + NewReno + Westwood x 8 flows for 60s
+//   csma_bus  slide 2 scenario 1 (10 clients), slide 2 scenario 2 (50),
+//             slide 4 scenario 3 (60 clients, 100s)
+//   star      8, 32 and 128 spokes
+//   chain     4, 12 and 23 nodes at 100Mbps (the 23 node chain for 30s)
+//
+// run one after another (never in parallel, so they do not compete for
+// cores and memory bandwidth) with --trace=off. Each one runs --repeat
+// times in <out>/<benchmark>/; the fastest repetition counts, and the
+// largest peak RSS. The event count and the simulated time come from the
+// run's <prefix>_metrics.tsv (common/run_metrics.h), the wall clock time
+// and peak RSS from the process itself, so program start-up and topology
+// construction are part of the measurement.
+//
+//   g++ -std=c++17 -O2 -o bench_suite tools/bench_suite.cc
+//   ./bench_suite --two-hop=<built two_hop_scenario> --csma-bus=<built csma_bus_scenario>
+//       --star=<built star_scenario> --chain=<built multi_hop_scenario>
+//       --baseline=bench_baseline.tsv
+//
+// Families without a program are skipped. A repetition that runs longer
+// than --timeout=SECONDS (default 1800) is killed and its benchmark fails,
+// so a program that does not end cannot stall the suite. The results go to
+// <out>/results.tsv:
+//
+//   benchmark events sim_s wall_s events_per_s sim_s_per_s peak_rss_mb
+//
+// With --baseline=FILE (a results.tsv of an earlier run, typically the
+// last release build on the same machine) every metric is compared, and
+// one that moved the wrong way by more than its --threshold=METRIC:PCT%
+// is a regression: the exit status is 1. The default thresholds are
+// wall_s:10%, events_per_s:10% and peak_rss_mb:20%. A changed event count
+// is reported but is not a regression by itself; it means the simulated
+// behaviour changed, and wall_s follows the amount of work while
+// events_per_s does not. --update-baseline writes the results to the
+// baseline file instead of comparing.
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+#include "process_pool.h"
+#include "replication_stats.h"
+
+struct Benchmark
+{
+  std::string id;                 // <family>_<size>, also the directory name
+  std::vector<std::string> argv;  // program and arguments
+};
+
+struct Result
+{
+  Result ()
+    : events (0),
+      simSeconds (0),
+      wallSeconds (0),
+      peakRssMb (0),
+      ok (false)
+  {
+  }
+
+  double events;
+  double simSeconds;
+  double wallSeconds;             // fastest repetition
+  double peakRssMb;               // largest of the repetitions
+  bool ok;
+};
+
+struct Threshold
+{
+  std::string metric;
+  double limit;                   // relative, 0.1 for 10%
+};
+
+// The compared metrics, and which way is worse.
+struct MetricInfo
+{
+  const char *name;
+  bool higherIsWorse;
+};
+
+static const MetricInfo g_metrics[] = {
+  { "wall_s", true },
+  { "events_per_s", false },
+  { "sim_s_per_s", false },
+  { "peak_rss_mb", true },
+};
+
+static void
+AddFamily (const std::string &family, const std::string &program, const char *const sizes[3][2],
+           std::vector<Benchmark> &benchmarks)
+{
+  if (program.empty ())
+    {
+      return;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+      Benchmark benchmark;
+      benchmark.id = family + "_" + sizes[i][0];
+      benchmark.argv.push_back (program);
+      std::istringstream iss (sizes[i][1]);
+      std::string arg;
+      while (iss >> arg)
+        {
+          benchmark.argv.push_back (arg);
+        }
+      benchmark.argv.push_back ("--trace=off");
+      benchmark.argv.push_back ("--prefix=bench");
+      benchmarks.push_back (benchmark);
+    }
+}
+
+static const char *const g_twoHop[3][2] = {
+  { "small", "--slide=5 --scenario=1 --tcp=ns3::TcpCubic --simulationTime=10" },
+  { "medium", "--slide=5 --scenario=1 --compete=ns3::TcpCubic,ns3::TcpNewReno --flowsPerVariant=4 "
+              "--simulationTime=30" },
+  { "large", "--slide=5 --scenario=1 --compete=ns3::TcpCubic,ns3::TcpNewReno,ns3::TcpWestwood "
+             "--flowsPerVariant=8 --simulationTime=60" },
+};
+
+static const char *const g_csmaBus[3][2] = {
+  { "small", "--slide=2 --scenario=1 --tcp=ns3::TcpCubic" },
+  { "medium", "--slide=2 --scenario=2 --tcp=ns3::TcpCubic" },
+  { "large", "--slide=4 --scenario=3 --tcp=ns3::TcpCubic" },
+};
+
+static const char *const g_star[3][2] = {
+  { "small", "--scenario=1 --tcp=ns3::TcpCubic --nSpokes=8" },
+  { "medium", "--scenario=1 --tcp=ns3::TcpCubic --nSpokes=32" },
+  { "large", "--scenario=1 --tcp=ns3::TcpCubic --nSpokes=128" },
+};
+
+static const char *const g_chain[3][2] = {
+  { "small", "--scenario=1 --tcp=ns3::TcpCubic --nNodes=4 --dataRate=100Mbps --simulationTime=10" },
+  { "medium", "--scenario=1 --tcp=ns3::TcpCubic --nNodes=12 --dataRate=100Mbps --simulationTime=10" },
+  { "large", "--scenario=1 --tcp=ns3::TcpCubic --nNodes=23 --dataRate=100Mbps --simulationTime=30" },
+};
+
+// Runs argv in dir with its output in dir/run.log; the exit status, or
+// 128 + signal, and the wall time and peak RSS of the process. The process
+// is killed after timeout seconds (0 for no limit).
+static int
+RunTimed (const std::vector<std::string> &argv, const std::string &dir, double timeout, double &wallSeconds,
+          double &peakRssMb)
+{
+  // SIGCHLD stays blocked so sigtimedwait below returns the moment the
+  // child exits; polling would add its interval to the wall time.
+  sigset_t childSet;
+  sigset_t oldSet;
+  sigemptyset (&childSet);
+  sigaddset (&childSet, SIGCHLD);
+  sigprocmask (SIG_BLOCK, &childSet, &oldSet);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      sigprocmask (SIG_SETMASK, &oldSet, 0);
+      return 127;
+    }
+  if (pid == 0)
+    {
+      sigprocmask (SIG_SETMASK, &oldSet, 0);
+      if (chdir (dir.c_str ()) != 0)
+        {
+          _exit (126);
+        }
+      int fd = open ("run.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd >= 0)
+        {
+          dup2 (fd, STDOUT_FILENO);
+          dup2 (fd, STDERR_FILENO);
+          close (fd);
+        }
+      std::vector<char *> args;
+      for (std::size_t i = 0; i < argv.size (); ++i)
+        {
+          args.push_back (const_cast<char *> (argv[i].c_str ()));
+        }
+      args.push_back (0);
+      execvp (args[0], args.data ());
+      std::perror ("execvp");
+      _exit (127);
+    }
+
+  int wstatus = 0;
+  struct rusage usage;
+  bool killed = false;
+  while (true)
+    {
+      pid_t done = wait4 (pid, &wstatus, timeout > 0 ? WNOHANG : 0, &usage);
+      if (done == pid)
+        {
+          break;
+        }
+      if (done < 0 && errno != EINTR)
+        {
+          sigprocmask (SIG_SETMASK, &oldSet, 0);
+          return 127;
+        }
+      if (done == 0)
+        {
+          double left = timeout - std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+          if (left <= 0 && !killed)
+            {
+              kill (pid, SIGKILL);
+              killed = true;
+            }
+          left = killed ? 1.0 : left;
+          struct timespec wait;
+          wait.tv_sec = static_cast<time_t> (left);
+          wait.tv_nsec = static_cast<long> ((left - wait.tv_sec) * 1e9);
+          sigtimedwait (&childSet, 0, &wait);
+        }
+    }
+  sigprocmask (SIG_SETMASK, &oldSet, 0);
+  wallSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  peakRssMb = usage.ru_maxrss / 1024.0;   // kilobytes on Linux
+  return WIFEXITED (wstatus) ? WEXITSTATUS (wstatus) : 128 + WTERMSIG (wstatus);
+}
+
+static bool
+RunBenchmark (const Benchmark &benchmark, const std::string &out, unsigned repeat, double timeout, Result &result)
+{
+  std::string dir = out + "/" + benchmark.id;
+  if (!PoolMakeDirs (dir))
+    {
+      std::cerr << "cannot create " << dir << ": " << std::strerror (errno) << std::endl;
+      return false;
+    }
+  // A metrics file left by an earlier invocation must not stand in for
+  // this one's.
+  std::remove ((dir + "/bench_metrics.tsv").c_str ());
+  for (unsigned k = 0; k < repeat; ++k)
+    {
+      double wallSeconds = 0;
+      double peakRssMb = 0;
+      int status = RunTimed (benchmark.argv, dir, timeout, wallSeconds, peakRssMb);
+      if (status == 128 + SIGKILL && timeout > 0 && wallSeconds > timeout)
+        {
+          std::cerr << benchmark.id << ": killed after the " << timeout << " s time limit, see " << dir
+                    << "/run.log" << std::endl;
+          return false;
+        }
+      if (status != 0)
+        {
+          std::cerr << benchmark.id << ": exit status " << status << ", see " << dir << "/run.log" << std::endl;
+          return false;
+        }
+      result.wallSeconds = k ? std::min (result.wallSeconds, wallSeconds) : wallSeconds;
+      result.peakRssMb = std::max (result.peakRssMb, peakRssMb);
+    }
+  std::map<std::string, double> metrics;
+  if (!ReadRunMetrics (dir + "/bench_metrics.tsv", metrics) || !metrics.count ("events"))
+    {
+      std::cerr << benchmark.id << ": no event count in " << dir << "/bench_metrics.tsv" << std::endl;
+      return false;
+    }
+  result.events = metrics["events"];
+  result.simSeconds = metrics["sim_s"];
+  result.ok = true;
+  return true;
+}
+
+static std::map<std::string, double>
+Metrics (const Result &result)
+{
+  std::map<std::string, double> metrics;
+  metrics["events"] = result.events;
+  metrics["sim_s"] = result.simSeconds;
+  metrics["wall_s"] = result.wallSeconds;
+  metrics["events_per_s"] = result.wallSeconds > 0 ? result.events / result.wallSeconds : 0;
+  metrics["sim_s_per_s"] = result.wallSeconds > 0 ? result.simSeconds / result.wallSeconds : 0;
+  metrics["peak_rss_mb"] = result.peakRssMb;
+  return metrics;
+}
+
+static const char *g_columns[] = { "events", "sim_s", "wall_s", "events_per_s", "sim_s_per_s", "peak_rss_mb" };
+
+static bool
+WriteResults (const std::string &path, const std::vector<Benchmark> &benchmarks,
+              const std::map<std::string, Result> &results, unsigned repeat)
+{
+  std::ofstream out (path.c_str ());
+  if (!out)
+    {
+      return false;
+    }
+  char host[256] = "";
+  gethostname (host, sizeof (host) - 1);
+  std::time_t now = std::time (0);
+  char date[32];
+  std::strftime (date, sizeof (date), "%Y-%m-%dT%H:%M:%S", std::localtime (&now));
+  out << "# host=" << host << "\n";
+  out << "# date=" << date << "\n";
+  out << "# repeat=" << repeat << "\n";
+  out << "benchmark";
+  for (const char *column : g_columns)
+    {
+      out << "\t" << column;
+    }
+  out << "\n";
+  for (const Benchmark &benchmark : benchmarks)
+    {
+      std::map<std::string, Result>::const_iterator it = results.find (benchmark.id);
+      if (it == results.end () || !it->second.ok)
+        {
+          continue;
+        }
+      std::map<std::string, double> metrics = Metrics (it->second);
+      out << benchmark.id;
+      for (const char *column : g_columns)
+        {
+          out << "\t" << metrics[column];
+        }
+      out << "\n";
+    }
+  return true;
+}
+
+// benchmark -> metric -> value, from a results.tsv.
+static bool
+ReadResults (const std::string &path, std::map<std::string, std::map<std::string, double> > &table)
+{
+  std::ifstream in (path.c_str ());
+  if (!in)
+    {
+      return false;
+    }
+  std::vector<std::string> header;
+  std::string line;
+  while (std::getline (in, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::istringstream iss (line);
+      std::vector<std::string> fields;
+      std::string field;
+      while (std::getline (iss, field, '\t'))
+        {
+          fields.push_back (field);
+        }
+      if (header.empty ())
+        {
+          header = fields;
+          continue;
+        }
+      for (std::size_t i = 1; i < fields.size () && i < header.size (); ++i)
+        {
+          table[fields[0]][header[i]] = std::atof (fields[i].c_str ());
+        }
+    }
+  return !header.empty ();
+}
+
+static bool
+ParseThreshold (const std::string &spec, Threshold &threshold)
+{
+  std::string::size_type colon = spec.rfind (':');
+  if (colon == std::string::npos || colon + 1 >= spec.size ())
+    {
+      return false;
+    }
+  threshold.metric = spec.substr (0, colon);
+  threshold.limit = std::atof (spec.c_str () + colon + 1) / 100.0;
+  for (const MetricInfo &info : g_metrics)
+    {
+      if (threshold.metric == info.name)
+        {
+          return threshold.limit > 0;
+        }
+    }
+  return false;
+}
+
+// Prints and writes to path one line per benchmark and compared metric:
+//   benchmark metric baseline current change_pct limit_pct verdict
+// and returns the number of regressions.
+static int
+Compare (const std::string &path, const std::vector<Benchmark> &benchmarks,
+         const std::map<std::string, Result> &results,
+         std::map<std::string, std::map<std::string, double> > &baseline,
+         const std::vector<Threshold> &thresholds)
+{
+  std::ofstream file (path.c_str ());
+  std::ostream *streams[] = { &std::cout, &file };
+  for (std::ostream *os : streams)
+    {
+      *os << "benchmark\tmetric\tbaseline\tcurrent\tchange_pct\tlimit_pct\tverdict\n";
+    }
+
+  int regressions = 0;
+  for (const Benchmark &benchmark : benchmarks)
+    {
+      std::map<std::string, Result>::const_iterator result = results.find (benchmark.id);
+      if (result == results.end () || !result->second.ok)
+        {
+          continue;
+        }
+      if (!baseline.count (benchmark.id))
+        {
+          for (std::ostream *os : streams)
+            {
+              *os << benchmark.id << "\t-\t-\t-\t-\t-\tnot in baseline\n";
+            }
+          continue;
+        }
+      std::map<std::string, double> &base = baseline[benchmark.id];
+      std::map<std::string, double> current = Metrics (result->second);
+      std::ostringstream lines;
+      lines << std::fixed << std::setprecision (3);
+
+      if (base.count ("events") && base["events"] != current["events"])
+        {
+          lines << benchmark.id << "\tevents\t" << std::setprecision (0) << base["events"] << "\t"
+                << current["events"] << "\t" << std::setprecision (1)
+                << (base["events"] > 0 ? (current["events"] / base["events"] - 1) * 100 : 0)
+                << "\t-\tchanged\n" << std::setprecision (3);
+        }
+      for (const Threshold &threshold : thresholds)
+        {
+          if (!base.count (threshold.metric) || base[threshold.metric] <= 0)
+            {
+              continue;
+            }
+          bool higherIsWorse = true;
+          for (const MetricInfo &info : g_metrics)
+            {
+              if (threshold.metric == info.name)
+                {
+                  higherIsWorse = info.higherIsWorse;
+                }
+            }
+          double change = current[threshold.metric] / base[threshold.metric] - 1;
+          double worse = higherIsWorse ? change : -change;
+          const char *verdict = "ok";
+          if (worse > threshold.limit)
+            {
+              verdict = "REGRESSION";
+              ++regressions;
+            }
+          else if (-worse > threshold.limit)
+            {
+              verdict = "improved";
+            }
+          lines << benchmark.id << "\t" << threshold.metric << "\t" << base[threshold.metric] << "\t"
+                << current[threshold.metric] << "\t" << std::setprecision (1) << change * 100 << "\t"
+                << threshold.limit * 100 << "\t" << verdict << "\n" << std::setprecision (3);
+        }
+      for (std::ostream *os : streams)
+        {
+          *os << lines.str ();
+        }
+    }
+  return regressions;
+}
+
+static std::string
+AbsolutePath (const std::string &path)
+{
+  if (path.find ('/') == std::string::npos)
+    {
+      return path; // resolved through PATH
+    }
+  char buf[PATH_MAX];
+  return realpath (path.c_str (), buf) ? std::string (buf) : path;
+}
+
+static void
+Usage ()
+{
+  std::cerr << "usage: bench_suite [--two-hop=PATH] [--csma-bus=PATH] [--star=PATH] [--chain=PATH]\n"
+               "                   [--out=DIR] [--repeat=N] [--timeout=S] [--filter=SUBSTR] [--baseline=FILE]\n"
+               "                   [--threshold=METRIC:PCT%]... [--update-baseline] [--list]\n";
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string twoHop;
+  std::string csmaBus;
+  std::string star;
+  std::string chain;
+  std::string out = "bench";
+  std::string filter;
+  std::string baselinePath;
+  std::vector<Threshold> thresholds;
+  unsigned repeat = 3;
+  double timeout = 1800;
+  bool updateBaseline = false;
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      std::string::size_type eq = arg.find ('=');
+      std::string key = arg.substr (0, eq);
+      std::string value = (eq == std::string::npos) ? "" : arg.substr (eq + 1);
+      Threshold threshold;
+      if (key == "--two-hop")
+        {
+          twoHop = AbsolutePath (value);
+        }
+      else if (key == "--csma-bus")
+        {
+          csmaBus = AbsolutePath (value);
+        }
+      else if (key == "--star")
+        {
+          star = AbsolutePath (value);
+        }
+      else if (key == "--chain")
+        {
+          chain = AbsolutePath (value);
+        }
+      else if (key == "--out")
+        {
+          out = value;
+        }
+      else if (key == "--repeat")
+        {
+          repeat = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--timeout")
+        {
+          timeout = std::atof (value.c_str ());
+        }
+      else if (key == "--filter")
+        {
+          filter = value;
+        }
+      else if (key == "--baseline")
+        {
+          baselinePath = value;
+        }
+      else if (key == "--threshold" && ParseThreshold (value, threshold))
+        {
+          thresholds.push_back (threshold);
+        }
+      else if (key == "--update-baseline")
+        {
+          updateBaseline = true;
+        }
+      else if (key == "--list")
+        {
+          list = true;
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (repeat == 0 || (updateBaseline && baselinePath.empty ()))
+    {
+      Usage ();
+      return 2;
+    }
+  if (thresholds.empty ())
+    {
+      for (const char *spec : { "wall_s:10%", "events_per_s:10%", "peak_rss_mb:20%" })
+        {
+          Threshold threshold;
+          ParseThreshold (spec, threshold);
+          thresholds.push_back (threshold);
+        }
+    }
+
+  std::vector<Benchmark> benchmarks;
+  AddFamily ("two_hop", twoHop, g_twoHop, benchmarks);
+  AddFamily ("csma_bus", csmaBus, g_csmaBus, benchmarks);
+  AddFamily ("star", star, g_star, benchmarks);
+  AddFamily ("chain", chain, g_chain, benchmarks);
+  if (!filter.empty ())
+    {
+      std::vector<Benchmark> kept;
+      for (const Benchmark &benchmark : benchmarks)
+        {
+          if (benchmark.id.find (filter) != std::string::npos)
+            {
+              kept.push_back (benchmark);
+            }
+        }
+      benchmarks.swap (kept);
+    }
+  if (benchmarks.empty ())
+    {
+      std::cerr << "no benchmarks: give at least one of --two-hop, --csma-bus, --star, --chain" << std::endl;
+      return 2;
+    }
+
+  if (list)
+    {
+      for (const Benchmark &benchmark : benchmarks)
+        {
+          std::cout << benchmark.id;
+          for (std::size_t i = 1; i < benchmark.argv.size (); ++i)
+            {
+              std::cout << " " << benchmark.argv[i];
+            }
+          std::cout << "\n";
+        }
+      return 0;
+    }
+
+  std::map<std::string, std::map<std::string, double> > baseline;
+  if (!baselinePath.empty () && !updateBaseline && !ReadResults (baselinePath, baseline))
+    {
+      std::cerr << "cannot read " << baselinePath << std::endl;
+      return 2;
+    }
+  if (!PoolMakeDirs (out))
+    {
+      std::cerr << "cannot create " << out << ": " << std::strerror (errno) << std::endl;
+      return 2;
+    }
+
+  std::map<std::string, Result> results;
+  int failed = 0;
+  for (std::size_t i = 0; i < benchmarks.size (); ++i)
+    {
+      const Benchmark &benchmark = benchmarks[i];
+      Result &result = results[benchmark.id];
+      if (!RunBenchmark (benchmark, out, repeat, timeout, result))
+        {
+          ++failed;
+          continue;
+        }
+      std::map<std::string, double> metrics = Metrics (result);
+      std::cout << "[" << i + 1 << "/" << benchmarks.size () << "] " << benchmark.id << ": "
+                << metrics["events"] << " events in " << result.wallSeconds << " s, "
+                << metrics["events_per_s"] << " events/s, " << metrics["sim_s_per_s"]
+                << " sim s/s, " << result.peakRssMb << " MB" << std::endl;
+    }
+
+  if (!WriteResults (out + "/results.tsv", benchmarks, results, repeat))
+    {
+      std::cerr << "cannot write " << out << "/results.tsv" << std::endl;
+      return 2;
+    }
+  if (updateBaseline && failed)
+    {
+      std::cerr << failed << " benchmarks failed, baseline " << baselinePath << " left as it was" << std::endl;
+      return 1;
+    }
+  if (updateBaseline)
+    {
+      if (!WriteResults (baselinePath, benchmarks, results, repeat))
+        {
+          std::cerr << "cannot write " << baselinePath << std::endl;
+          return 2;
+        }
+      std::cout << "baseline " << baselinePath << " updated" << std::endl;
+    }
+
+  int regressions = 0;
+  if (!baseline.empty ())
+    {
+      regressions = Compare (out + "/compare.tsv", benchmarks, results, baseline, thresholds);
+    }
+  if (failed)
+    {
+      std::cerr << failed << " benchmarks failed" << std::endl;
+    }
+  if (regressions)
+    {
+      std::cerr << regressions << " regressions against " << baselinePath << std::endl;
+    }
+  return failed || regressions ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+// Converts tab separated .cwnd files ("time old new", as in
+// NS3_Sim_Run_Results) to .cols column files (common/column_store.h).
+//
+//   g++ -std=c++17 -O2 -o cwnd_import tools/cwnd_import.cc
+//   ./cwnd_import --out=store NS3_Sim_Run_Results/*/*.cwnd NS3_Sim_Run_Results/*/*/*.cwnd
+//
+// slide, scenario, queue and tcp are taken from names like
+// Slide6_scen2_RED_TcpDctcp_cwnd.cwnd; --meta=key=value adds or overrides
+// metadata for every file of the invocation.
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/column_store.h"
+
+static void
+Usage ()
+{
+  std::cerr << "usage: cwnd_import --out=DIR [--meta=KEY=VALUE]... FILE.cwnd...\n";
+}
+
+static std::string
+BaseName (const std::string &path)
+{
+  std::string::size_type slash = path.rfind ('/');
+  return slash == std::string::npos ? path : path.substr (slash + 1);
+}
+
+// Slide<s>_scen<n>_[<queue>_]<variant>[_DR_change]_cwnd.cwnd
+static void
+MetaFromName (const std::string &name, ColumnFileWriter &writer)
+{
+  std::vector<std::string> parts;
+  std::string::size_type start = 0;
+  while (start <= name.size ())
+    {
+      std::string::size_type end = name.find ('_', start);
+      if (end == std::string::npos)
+        {
+          end = name.size ();
+        }
+      parts.push_back (name.substr (start, end - start));
+      start = end + 1;
+    }
+  std::string queue = "FIFO";
+  for (const std::string &part : parts)
+    {
+      if (part.compare (0, 5, "Slide") == 0)
+        {
+          writer.SetMeta ("slide", part.substr (5));
+        }
+      else if (part.compare (0, 4, "scen") == 0)
+        {
+          writer.SetMeta ("scenario", part.substr (4));
+        }
+      else if (part == "FIFO" || part == "RED")
+        {
+          queue = part;
+        }
+      else if (part.compare (0, 3, "Tcp") == 0)
+        {
+          writer.SetMeta ("tcp", part);
+        }
+    }
+  writer.SetMeta ("queue", queue);
+}
+
+static bool
+Import (const std::string &path, const std::string &outDir,
+        const std::vector<std::pair<std::string, std::string> > &meta)
+{
+  std::FILE *in = std::fopen (path.c_str (), "r");
+  if (!in)
+    {
+      std::perror (path.c_str ());
+      return false;
+    }
+  std::vector<double> time;
+  std::vector<uint32_t> oldCwnd;
+  std::vector<uint32_t> newCwnd;
+  double t;
+  unsigned long o, n;
+  while (std::fscanf (in, "%lf %lu %lu", &t, &o, &n) == 3)
+    {
+      time.push_back (t);
+      oldCwnd.push_back (o);
+      newCwnd.push_back (n);
+    }
+  bool complete = std::feof (in);
+  std::fclose (in);
+  if (!complete)
+    {
+      std::cerr << path << ": parse error after " << time.size () << " rows" << std::endl;
+      return false;
+    }
+
+  std::string name = BaseName (path);
+  ColumnFileWriter writer;
+  writer.SetMeta ("series", "cwnd");
+  writer.SetMeta ("source", name);
+  MetaFromName (name, writer);
+  for (const std::pair<std::string, std::string> &kv : meta)
+    {
+      writer.SetMeta (kv.first, kv.second);
+    }
+  writer.AddColumn ("time", time);
+  writer.AddColumn ("old", oldCwnd);
+  writer.AddColumn ("new", newCwnd);
+
+  std::string stem = name.substr (0, name.rfind ('.'));
+  std::string out = outDir + "/" + stem + ".cols";
+  if (!writer.Write (out))
+    {
+      std::cerr << "cannot write " << out << std::endl;
+      return false;
+    }
+  return true;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string outDir;
+  std::vector<std::pair<std::string, std::string> > meta;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 6, "--out=") == 0)
+        {
+          outDir = arg.substr (6);
+        }
+      else if (arg.compare (0, 7, "--meta=") == 0)
+        {
+          std::string kv = arg.substr (7);
+          std::string::size_type eq = kv.find ('=');
+          if (eq == std::string::npos)
+            {
+              Usage ();
+              return 2;
+            }
+          meta.push_back (std::make_pair (kv.substr (0, eq), kv.substr (eq + 1)));
+        }
+      else if (arg.compare (0, 2, "--") != 0)
+        {
+          inputs.push_back (arg);
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (outDir.empty () || inputs.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+  ::mkdir (outDir.c_str (), 0755);
+
+  int failed = 0;
+  for (const std::string &input : inputs)
+    {
+      if (!Import (input, outDir, meta))
+        {
+          failed++;
+        }
+    }
+  std::cerr << inputs.size () - failed << " imported, " << failed << " failed" << std::endl;
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+// Compares cwnd series of a column store (common/column_store.h) without
+// re-parsing the text traces.
+//
+//   g++ -std=c++17 -O2 -o cwnd_query tools/cwnd_query.cc
+//   ./cwnd_query --store=store --where=slide=6 --where=scenario=2
+//   ./cwnd_query --store=store --where=slide=6 --group-by=tcp --from=2 --to=4
+//
+// Prints one line per matching series (time weighted mean, max and final
+// cwnd over [--from, --to]), or with --group-by the average of those per
+// value of a metadata key.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/column_store.h"
+
+static void
+Usage ()
+{
+  std::cerr << "usage: cwnd_query --store=DIR [--where=KEY=VALUE]... [--from=S] [--to=S] [--group-by=KEY]\n";
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::vector<std::string> stores;
+  std::vector<std::pair<std::string, std::string> > where;
+  double from = 0;
+  double to = std::numeric_limits<double>::max ();
+  std::string groupBy;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 8, "--store=") == 0)
+        {
+          stores.push_back (arg.substr (8));
+        }
+      else if (arg.compare (0, 8, "--where=") == 0)
+        {
+          std::string kv = arg.substr (8);
+          std::string::size_type eq = kv.find ('=');
+          if (eq == std::string::npos)
+            {
+              Usage ();
+              return 2;
+            }
+          where.push_back (std::make_pair (kv.substr (0, eq), kv.substr (eq + 1)));
+        }
+      else if (arg.compare (0, 7, "--from=") == 0)
+        {
+          from = std::atof (arg.c_str () + 7);
+        }
+      else if (arg.compare (0, 5, "--to=") == 0)
+        {
+          to = std::atof (arg.c_str () + 5);
+        }
+      else if (arg.compare (0, 11, "--group-by=") == 0)
+        {
+          groupBy = arg.substr (11);
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (stores.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now ();
+  ColumnStore store;
+  for (const std::string &dir : stores)
+    {
+      store.OpenDirectory (dir);
+    }
+  where.push_back (std::make_pair (std::string ("series"), std::string ("cwnd")));
+  std::vector<const ColumnFile *> files = store.Select (where);
+
+  // An open ended window stops at the last change of each series.
+  std::map<std::string, std::pair<double, uint32_t> > groups;
+  if (groupBy.empty ())
+    {
+      std::cout << "slide\tscenario\tqueue\ttcp\tchanges\tmean\tmax\tlast\n";
+    }
+  for (const ColumnFile *file : files)
+    {
+      double end = to;
+      const double *time = file->GetColumn<double> ("time");
+      if (end == std::numeric_limits<double>::max ())
+        {
+          end = (time && file->GetRows ()) ? time[file->GetRows () - 1] : from;
+        }
+      CwndStats stats;
+      if (!ComputeCwndStats (*file, from, end, stats))
+        {
+          std::cerr << file->GetPath () << ": not a cwnd series" << std::endl;
+          continue;
+        }
+      if (groupBy.empty ())
+        {
+          std::cout << file->GetMeta ("slide") << "\t" << file->GetMeta ("scenario") << "\t"
+                    << file->GetMeta ("queue") << "\t" << file->GetMeta ("tcp") << "\t"
+                    << stats.changes << "\t" << stats.mean << "\t" << stats.max << "\t"
+                    << stats.last << "\n";
+        }
+      else
+        {
+          std::pair<double, uint32_t> &group = groups[file->GetMeta (groupBy)];
+          group.first += stats.mean;
+          group.second++;
+        }
+    }
+  if (!groupBy.empty ())
+    {
+      std::cout << groupBy << "\truns\tmean\n";
+      for (std::map<std::string, std::pair<double, uint32_t> >::const_iterator it = groups.begin ();
+           it != groups.end (); ++it)
+        {
+          std::cout << it->first << "\t" << it->second.second << "\t"
+                    << it->second.first / it->second.second << "\n";
+        }
+    }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - begin;
+  std::cerr << files.size () << " of " << store.GetN () << " series, "
+            << elapsed.count () * 1e3 << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,157 @@
+// Merges the per-flow latency histograms of runs (the <prefix>_latency.hdr
+// files of common/latency_probe.h) and prints their percentiles.
+//
+//   g++ -std=c++17 -O2 -o latency_merge tools/latency_merge.cc
+//   ./latency_merge run1_latency.hdr run2_latency.hdr
+//   ./latency_merge --dir=results --flow=10.1.1.1: --by-flow
+//
+// Without --by-flow all matching flows of all files go into one delay and
+// one jitter histogram, so the percentiles are those of every packet of
+// every replication, not an average of per-run percentiles. --flow keeps
+// the flows whose name ("src:port->dst:port/proto") contains the text.
+
+#include <dirent.h>
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../common/latency_histogram.h"
+
+static void
+Usage ()
+{
+  std::cerr << "usage: latency_merge [--dir=DIR]... [--flow=TEXT] [--by-flow] [FILE]...\n";
+}
+
+typedef std::map<std::pair<std::string, std::string>, LatencyHistogram> Histograms;
+
+// Merges the histograms of one file into histograms, keyed by (flow, kind)
+// or ("all", kind). False when a line cannot be read or its layout does
+// not match the histograms already merged.
+static bool
+ReadFile (const std::string &path, const std::string &flowFilter, bool byFlow, Histograms &histograms)
+{
+  std::ifstream in (path.c_str ());
+  if (!in)
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (in, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::string::size_type tab1 = line.find ('\t');
+      std::string::size_type tab2 = tab1 == std::string::npos ? tab1 : line.find ('\t', tab1 + 1);
+      if (tab2 == std::string::npos)
+        {
+          return false;
+        }
+      std::string flow = line.substr (0, tab1);
+      std::string kind = line.substr (tab1 + 1, tab2 - tab1 - 1);
+      if (flow.find (flowFilter) == std::string::npos)
+        {
+          continue;
+        }
+      LatencyHistogram histogram;
+      if (!LatencyHistogram::Read (line.substr (tab2 + 1), histogram))
+        {
+          return false;
+        }
+      std::pair<std::string, std::string> key (byFlow ? flow : "all", kind);
+      Histograms::iterator it = histograms.find (key);
+      if (it == histograms.end ())
+        {
+          histograms.insert (std::make_pair (key, histogram));
+        }
+      else if (!it->second.Merge (histogram))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::vector<std::string> files;
+  std::string flowFilter;
+  bool byFlow = false;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 6, "--dir=") == 0)
+        {
+          std::string dir = arg.substr (6);
+          DIR *d = ::opendir (dir.c_str ());
+          if (!d)
+            {
+              std::cerr << "Cannot open " << dir << std::endl;
+              return 1;
+            }
+          static const std::string suffix = "_latency.hdr";
+          while (struct dirent *entry = ::readdir (d))
+            {
+              std::string name = entry->d_name;
+              if (name.size () > suffix.size ()
+                  && name.compare (name.size () - suffix.size (), suffix.size (), suffix) == 0)
+                {
+                  files.push_back (dir + "/" + name);
+                }
+            }
+          ::closedir (d);
+        }
+      else if (arg.compare (0, 7, "--flow=") == 0)
+        {
+          flowFilter = arg.substr (7);
+        }
+      else if (arg == "--by-flow")
+        {
+          byFlow = true;
+        }
+      else if (arg.compare (0, 2, "--") == 0)
+        {
+          Usage ();
+          return 2;
+        }
+      else
+        {
+          files.push_back (arg);
+        }
+    }
+  if (files.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+
+  Histograms histograms;
+  for (const std::string &file : files)
+    {
+      if (!ReadFile (file, flowFilter, byFlow, histograms))
+        {
+          std::cerr << "Cannot read " << file << std::endl;
+          return 1;
+        }
+    }
+
+  std::cout << "# files=" << files.size () << "\n";
+  std::cout << "flow\tkind\tpackets\tmean_ms\tp50_ms\tp90_ms\tp99_ms\tp999_ms\tmax_ms\n";
+  for (const auto &entry : histograms)
+    {
+      const LatencyHistogram &h = entry.second;
+      std::cout << entry.first.first << "\t" << entry.first.second << "\t" << h.GetCount () << "\t"
+                << h.GetMean () / 1e6 << "\t" << h.GetQuantile (0.5) / 1e6 << "\t" << h.GetQuantile (0.9) / 1e6
+                << "\t" << h.GetQuantile (0.99) / 1e6 << "\t" << h.GetQuantile (0.999) / 1e6 << "\t"
+                << h.GetMax () / 1e6 << "\n";
+    }
+  return 0;
+}
@@ -0,0 +1,397 @@
+#ifndef PROCESS_POOL_H
+#define PROCESS_POOL_H
+
+// Runs a list of scenario processes with at most N of them alive at once.
+// Every run gets its own working directory; a run whose directory already
+// holds a ".done" marker and the same command line is skipped, so an
+// interrupted sweep picks up where it stopped, while a run whose program
+// or arguments changed since is repeated. Runs are handed out from a
+// shared queue to whichever slot frees first, heaviest runs first. A slot
+// is only freed when its process exits, so SetTimeout bounds the wall time
+// of a run: one that never ends is killed and counts as failed.
+//
+// POSIX only, no ns-3 dependency.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <ftw.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+struct PoolRun
+{
+  std::string id;                 // unique name, also the directory name
+  std::vector<std::string> argv;  // program and arguments
+  std::string dir;                // working directory, filled in by the pool
+  double weight;                  // expected relative cost, larger starts first
+  int status;                     // exit status once finished, -1 before
+};
+
+static volatile sig_atomic_t g_poolInterrupted = 0;
+
+static void
+PoolSignalHandler (int)
+{
+  g_poolInterrupted = 1;
+}
+
+// mkdir -p
+static bool
+PoolMakeDirs (const std::string &path)
+{
+  std::string partial;
+  for (std::string::size_type i = 0; i <= path.size (); ++i)
+    {
+      if (i == path.size () || path[i] == '/')
+        {
+          if (!partial.empty () && mkdir (partial.c_str (), 0755) != 0 && errno != EEXIST)
+            {
+              return false;
+            }
+        }
+      if (i < path.size ())
+        {
+          partial += path[i];
+        }
+    }
+  return true;
+}
+
+static bool
+PoolFileExists (const std::string &path)
+{
+  struct stat st;
+  return stat (path.c_str (), &st) == 0;
+}
+
+// A run id names a directory inside the output directory, so it may not
+// leave it or carry characters a shell would interpret. '/' separates
+// nested directories ("<cell>/run<k>"); every part has to be a plain name.
+static bool
+PoolValidId (const std::string &id)
+{
+  if (id.find_first_of ("\\'\"`$") != std::string::npos)
+    {
+      return false;
+    }
+  std::string::size_type begin = 0;
+  while (true)
+    {
+      std::string::size_type end = id.find ('/', begin);
+      std::string part = id.substr (begin, end == std::string::npos ? std::string::npos : end - begin);
+      if (part.empty () || part == "." || part == "..")
+        {
+          return false;
+        }
+      if (end == std::string::npos)
+        {
+          return true;
+        }
+      begin = end + 1;
+    }
+}
+
+static int
+PoolRemoveEntry (const char *path, const struct stat *, int, struct FTW *)
+{
+  return remove (path);
+}
+
+// rm -rf, without following symbolic links.
+static bool
+PoolRemoveTree (const std::string &path)
+{
+  return nftw (path.c_str (), &PoolRemoveEntry, 16, FTW_DEPTH | FTW_PHYS) == 0;
+}
+
+class ProcessPool
+{
+public:
+  ProcessPool (const std::string &outputDir, unsigned jobs)
+    : m_outputDir (outputDir),
+      m_jobs (jobs ? jobs : 1),
+      m_verbose (true),
+      m_timeout (0)
+  {
+  }
+
+  // Wall clock limit of one run in seconds, 0 for none.
+  void SetTimeout (double seconds)
+  {
+    m_timeout = seconds;
+  }
+
+  void SetVerbose (bool verbose)
+  {
+    m_verbose = verbose;
+  }
+
+  std::string RunDir (const PoolRun &run) const
+  {
+    return m_outputDir + "/" + run.id;
+  }
+
+  // Finished, with the command line run has now.
+  bool IsDone (const PoolRun &run) const
+  {
+    return PoolFileExists (RunDir (run) + "/.done") && SavedCommandLine (run) == CommandLine (run);
+  }
+
+  // Finished, but with another command line.
+  bool IsStale (const PoolRun &run) const
+  {
+    return PoolFileExists (RunDir (run) + "/.done") && SavedCommandLine (run) != CommandLine (run);
+  }
+
+  static std::string CommandLine (const PoolRun &run)
+  {
+    std::string line;
+    for (std::size_t i = 0; i < run.argv.size (); ++i)
+      {
+        line += (i ? " " : "") + run.argv[i];
+      }
+    return line;
+  }
+
+  // Runs every entry of runs that is not done yet. Returns the number of
+  // failed runs, or -1 if the sweep was interrupted.
+  int Run (std::vector<PoolRun> &runs)
+  {
+    std::vector<PoolRun *> pending;
+    std::size_t stale = 0;
+    for (PoolRun &run : runs)
+      {
+        run.dir = RunDir (run);
+        run.status = -1;
+        if (IsDone (run))
+          {
+            run.status = 0;
+            continue;
+          }
+        if (IsStale (run))
+          {
+            ++stale;
+          }
+        pending.push_back (&run);
+      }
+    std::stable_sort (pending.begin (), pending.end (),
+                      [] (const PoolRun *a, const PoolRun *b) { return a->weight > b->weight; });
+
+    if (m_verbose)
+      {
+        std::cout << runs.size () - pending.size () << " runs already done, "
+                  << pending.size () << " to run on " << m_jobs << " slots" << std::endl;
+        if (stale)
+          {
+            std::cout << stale << " of them finished before with another command line, rerunning" << std::endl;
+          }
+      }
+
+    struct sigaction sa;
+    struct sigaction oldInt;
+    struct sigaction oldTerm;
+    std::memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = &PoolSignalHandler;
+    sigaction (SIGINT, &sa, &oldInt);
+    sigaction (SIGTERM, &sa, &oldTerm);
+
+    typedef std::chrono::steady_clock Clock;
+    std::map<pid_t, PoolRun *> running;
+    std::map<pid_t, Clock::time_point> started;
+    std::map<pid_t, bool> timedOut;
+    std::size_t next = 0;
+    std::size_t finished = 0;
+    int failed = 0;
+
+    while ((next < pending.size () || !running.empty ()) && !g_poolInterrupted)
+      {
+        while (next < pending.size () && running.size () < m_jobs && !g_poolInterrupted)
+          {
+            PoolRun *run = pending[next++];
+            pid_t pid = Launch (*run);
+            if (pid < 0)
+              {
+                run->status = 127;
+                ++failed;
+                continue;
+              }
+            running[pid] = run;
+            started[pid] = Clock::now ();
+          }
+        if (running.empty ())
+          {
+            break;
+          }
+
+        int wstatus = 0;
+        pid_t pid = waitpid (-1, &wstatus, m_timeout > 0 ? WNOHANG : 0);
+        if (pid == 0)
+          {
+            // Nothing exited yet: kill the runs over the limit, look again
+            // in a moment.
+            for (std::map<pid_t, Clock::time_point>::iterator it = started.begin (); it != started.end (); ++it)
+              {
+                if (!timedOut[it->first]
+                    && std::chrono::duration<double> (Clock::now () - it->second).count () > m_timeout)
+                  {
+                    kill (it->first, SIGKILL);
+                    timedOut[it->first] = true;
+                  }
+              }
+            usleep (100000);
+            continue;
+          }
+        if (pid < 0)
+          {
+            if (errno == EINTR)
+              {
+                continue;
+              }
+            break;
+          }
+        std::map<pid_t, PoolRun *>::iterator it = running.find (pid);
+        if (it == running.end ())
+          {
+            continue;
+          }
+        PoolRun *run = it->second;
+        running.erase (it);
+        started.erase (pid);
+        bool killed = timedOut[pid];
+        timedOut.erase (pid);
+        run->status = WIFEXITED (wstatus) ? WEXITSTATUS (wstatus) : 128 + WTERMSIG (wstatus);
+        ++finished;
+        if (killed)
+          {
+            std::ofstream log ((run->dir + "/run.log").c_str (), std::ios::app);
+            log << "killed after the " << m_timeout << " s time limit\n";
+          }
+        if (run->status == 0)
+          {
+            std::ofstream done ((run->dir + "/.done").c_str ());
+            done << "0\n";
+          }
+        else
+          {
+            ++failed;
+          }
+        if (m_verbose)
+          {
+            std::cout << "[" << finished << "/" << pending.size () << "] " << run->id
+                      << (run->status == 0 ? " ok" : killed ? " TIMED OUT" : " FAILED (status ")
+                      << (run->status == 0 || killed ? "" : std::to_string (run->status) + ")")
+                      << std::endl;
+          }
+      }
+
+    if (g_poolInterrupted)
+      {
+        // Leave no half-written run behind that could be mistaken for a
+        // finished one; the missing ".done" marker reruns them next time.
+        for (std::map<pid_t, PoolRun *>::iterator it = running.begin (); it != running.end (); ++it)
+          {
+            kill (it->first, SIGTERM);
+          }
+        for (std::map<pid_t, PoolRun *>::iterator it = running.begin (); it != running.end (); ++it)
+          {
+            waitpid (it->first, 0, 0);
+          }
+      }
+
+    sigaction (SIGINT, &oldInt, 0);
+    sigaction (SIGTERM, &oldTerm, 0);
+    if (g_poolInterrupted)
+      {
+        std::cerr << "interrupted, rerun the same command to resume" << std::endl;
+        return -1;
+      }
+    return failed;
+  }
+
+private:
+  std::string SavedCommandLine (const PoolRun &run) const
+  {
+    std::ifstream in ((RunDir (run) + "/cmdline").c_str ());
+    std::string line;
+    std::getline (in, line);
+    return line;
+  }
+
+  pid_t Launch (PoolRun &run)
+  {
+    if (!PoolValidId (run.id))
+      {
+        std::cerr << "invalid run id \"" << run.id << "\"" << std::endl;
+        return -1;
+      }
+    // A directory without ".done" belongs to an interrupted or failed
+    // attempt; start that run from an empty directory.
+    if (PoolFileExists (run.dir))
+      {
+        if (!PoolRemoveTree (run.dir))
+          {
+            std::cerr << "cannot clean " << run.dir << std::endl;
+            return -1;
+          }
+      }
+    if (!PoolMakeDirs (run.dir))
+      {
+        std::cerr << "cannot create " << run.dir << ": " << std::strerror (errno) << std::endl;
+        return -1;
+      }
+    {
+      std::ofstream cmdline ((run.dir + "/cmdline").c_str ());
+      cmdline << CommandLine (run) << "\n";
+    }
+
+    pid_t pid = fork ();
+    if (pid != 0)
+      {
+        return pid;
+      }
+
+    // Child: own directory, own log, default signal handling.
+    signal (SIGINT, SIG_DFL);
+    signal (SIGTERM, SIG_DFL);
+    if (chdir (run.dir.c_str ()) != 0)
+      {
+        _exit (126);
+      }
+    int fd = open ("run.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+      {
+        dup2 (fd, STDOUT_FILENO);
+        dup2 (fd, STDERR_FILENO);
+        close (fd);
+      }
+    std::vector<char *> args;
+    for (std::size_t i = 0; i < run.argv.size (); ++i)
+      {
+        args.push_back (const_cast<char *> (run.argv[i].c_str ()));
+      }
+    args.push_back (0);
+    execvp (args[0], args.data ());
+    std::perror ("execvp");
+    _exit (127);
+  }
+
+  std::string m_outputDir;
+  unsigned m_jobs;
+  bool m_verbose;
+  double m_timeout;   // seconds, 0 for none
+};
+
+#endif /* PROCESS_POOL_H */
@@ -0,0 +1,181 @@
+// Runs N replications of one scenario configuration in parallel and reports
+// 95% confidence intervals of the run metrics (throughput, delay, loss).
+//
+//   g++ -std=c++17 -O2 -o replicate tools/replicate.cc
+//   ./replicate --program=<built two_hop_scenario> --reps=20 --out=rep --
+//       --slide=6 --scenario=2 --queue=RED --tcp=ns3::TcpDctcp --trace=summary
+//
+// Replication k runs as "<program> <args> --seed=S --run=k --prefix=run" in
+// <out>/run<k>/, so one replication can be rerun alone with the same
+// arguments to debug it. Finished replications are kept when the command
+// is repeated, and --reps can be raised to add more. Runs get --trace=off
+// unless --trace=LEVEL says otherwise (an empty level passes nothing); the
+// program arguments come after it and win. --timeout=SECONDS kills a
+// replication that runs longer.
+
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "process_pool.h"
+#include "replication_stats.h"
+
+static void
+Usage ()
+{
+  std::cerr << "usage: replicate --program=PATH [--reps=N] [--seed=S] [--first-run=K] [--out=DIR]\n"
+               "                 [--jobs=N] [--trace=LEVEL] [--timeout=S]\n"
+               "                 -- PROGRAM ARGS...\n";
+}
+
+static std::string
+AbsolutePath (const std::string &path)
+{
+  if (path.find ('/') == std::string::npos)
+    {
+      return path; // resolved through PATH
+    }
+  char buf[PATH_MAX];
+  return realpath (path.c_str (), buf) ? std::string (buf) : path;
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string program;
+  std::string out = "replications";
+  std::string trace = "off";
+  double timeout = 0;
+  unsigned reps = 10;
+  unsigned seed = 1;
+  unsigned firstRun = 1;
+  unsigned jobs = std::thread::hardware_concurrency ();
+  std::vector<std::string> args;
+
+  int i = 1;
+  for (; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg == "--")
+        {
+          ++i;
+          break;
+        }
+      std::string::size_type eq = arg.find ('=');
+      std::string key = arg.substr (0, eq);
+      std::string value = (eq == std::string::npos) ? "" : arg.substr (eq + 1);
+      if (key == "--program")
+        {
+          program = value;
+        }
+      else if (key == "--reps")
+        {
+          reps = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--seed")
+        {
+          seed = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--first-run")
+        {
+          firstRun = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--out")
+        {
+          out = value;
+        }
+      else if (key == "--jobs")
+        {
+          jobs = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--trace")
+        {
+          trace = value;
+        }
+      else if (key == "--timeout")
+        {
+          timeout = std::atof (value.c_str ());
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  for (; i < argc; ++i)
+    {
+      args.push_back (argv[i]);
+    }
+  if (program.empty () || reps == 0)
+    {
+      Usage ();
+      return 2;
+    }
+  program = AbsolutePath (program);
+
+  std::vector<PoolRun> runs;
+  for (unsigned k = firstRun; k < firstRun + reps; ++k)
+    {
+      PoolRun run;
+      run.id = "run" + std::to_string (k);
+      run.argv.push_back (program);
+      if (!trace.empty ())
+        {
+          run.argv.push_back ("--trace=" + trace);
+        }
+      run.argv.insert (run.argv.end (), args.begin (), args.end ());
+      run.argv.push_back ("--seed=" + std::to_string (seed));
+      run.argv.push_back ("--run=" + std::to_string (k));
+      run.argv.push_back ("--prefix=run");
+      run.weight = 1.0;
+      runs.push_back (run);
+    }
+
+  ProcessPool pool (out, jobs);
+  pool.SetTimeout (timeout);
+  int failed = pool.Run (runs);
+  if (failed < 0)
+    {
+      return 130;
+    }
+
+  std::map<std::string, std::vector<double> > samples;
+  for (const PoolRun &run : runs)
+    {
+      std::map<std::string, double> metrics;
+      if (!ReadRunMetrics (pool.RunDir (run) + "/run_metrics.tsv", metrics))
+        {
+          continue;
+        }
+      for (std::map<std::string, double>::const_iterator it = metrics.begin (); it != metrics.end (); ++it)
+        {
+          if (it->first != "seed" && it->first != "run")
+            {
+              samples[it->first].push_back (it->second);
+            }
+        }
+    }
+
+  std::ofstream summary ((out + "/summary.tsv").c_str ());
+  std::ostream *streams[] = { &std::cout, &summary };
+  for (std::ostream *os : streams)
+    {
+      *os << "metric\tn\tmean\tstddev\tci95_low\tci95_high\n";
+      for (std::map<std::string, std::vector<double> >::const_iterator it = samples.begin ();
+           it != samples.end (); ++it)
+        {
+          SampleStats stats = ComputeSampleStats (it->second);
+          *os << it->first << "\t" << stats.n << "\t" << stats.mean << "\t" << stats.stddev << "\t"
+              << stats.mean - stats.halfWidth << "\t" << stats.mean + stats.halfWidth << "\n";
+        }
+    }
+  if (failed)
+    {
+      std::cerr << failed << " replications failed" << std::endl;
+    }
+  return failed == 0 ? 0 : 1;
+}
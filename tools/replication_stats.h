@@ -0,0 +1,109 @@
+#ifndef REPLICATION_STATS_H
+#define REPLICATION_STATS_H
+
+// Reading the <prefix>_metrics.tsv files of replications
+// (common/run_metrics.h) and Student t confidence intervals over them.
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct SampleStats
+{
+  uint32_t n;
+  double mean;
+  double stddev;           // sample standard deviation
+  double halfWidth;        // of the 95% confidence interval
+};
+
+// Two sided 95% Student t quantile for df degrees of freedom.
+inline double
+StudentT975 (uint32_t df)
+{
+  static const double table[] = {
+    0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+  };
+  if (df == 0)
+    {
+      return INFINITY;
+    }
+  if (df <= 30)
+    {
+      return table[df];
+    }
+  if (df <= 40)
+    {
+      return 2.021;
+    }
+  if (df <= 60)
+    {
+      return 2.000;
+    }
+  if (df <= 120)
+    {
+      return 1.980;
+    }
+  return 1.960;
+}
+
+inline SampleStats
+ComputeSampleStats (const std::vector<double> &values)
+{
+  SampleStats stats;
+  stats.n = values.size ();
+  stats.mean = 0;
+  stats.stddev = 0;
+  stats.halfWidth = INFINITY;
+  if (values.empty ())
+    {
+      return stats;
+    }
+  for (double v : values)
+    {
+      stats.mean += v;
+    }
+  stats.mean /= values.size ();
+  if (values.size () < 2)
+    {
+      return stats;
+    }
+  double ss = 0;
+  for (double v : values)
+    {
+      ss += (v - stats.mean) * (v - stats.mean);
+    }
+  stats.stddev = std::sqrt (ss / (values.size () - 1));
+  stats.halfWidth = StudentT975 (values.size () - 1) * stats.stddev / std::sqrt (double (values.size ()));
+  return stats;
+}
+
+// Adds the "<metric>\t<value>" lines of path to metrics.
+inline bool
+ReadRunMetrics (const std::string &path, std::map<std::string, double> &metrics)
+{
+  std::ifstream in (path.c_str ());
+  if (!in)
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (in, line))
+    {
+      std::istringstream iss (line);
+      std::string key;
+      double value;
+      if (iss >> key >> value)
+        {
+          metrics[key] = value;
+        }
+    }
+  return true;
+}
+
+#endif /* REPLICATION_STATS_H */
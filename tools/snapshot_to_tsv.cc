@@ -0,0 +1,120 @@
+// Converts a FlowMonitor snapshot stream (common/flow_snapshot.h) to tab
+// separated per-interval rows:
+//
+//   time flow source destination tx_packets rx_packets lost throughput_mbps mean_delay_ms
+//
+// with the receive throughput and the mean delay of the packets received
+// during the interval ending at time.
+//
+//   g++ -std=c++17 -O2 -o snapshot_to_tsv tools/snapshot_to_tsv.cc
+//   ./snapshot_to_tsv udp_point_to_point_gnu.snap --flow=1 > flow1.tsv
+//
+// --flow=N keeps one flow.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../common/flow_snapshot_record.h"
+
+static void
+Usage ()
+{
+  std::cerr << "usage: snapshot_to_tsv [--flow=N] [--out=FILE] SNAPSHOTS\n";
+}
+
+static std::string
+Endpoint (uint32_t address, uint16_t port)
+{
+  std::ostringstream oss;
+  oss << (address >> 24) << "." << ((address >> 16) & 0xff) << "." << ((address >> 8) & 0xff) << "."
+      << (address & 0xff) << ":" << port;
+  return oss.str ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  long flow = -1;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 7, "--flow=") == 0)
+        {
+          flow = std::atol (arg.c_str () + 7);
+        }
+      else if (arg.compare (0, 6, "--out=") == 0)
+        {
+          output = arg.substr (6);
+        }
+      else if (input.empty () && arg.compare (0, 2, "--") != 0)
+        {
+          input = arg;
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (input.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file)
+        {
+          std::cerr << "cannot write " << output << std::endl;
+          return 1;
+        }
+    }
+  std::ostream &out = output.empty () ? std::cout : file;
+
+  bool first = true;
+  FlowSnapshotFileHeader header;
+  bool ok = ForEachFlowSnapshot (input.c_str (), header, [&] (const FlowSnapshotRecord &r, int64_t durationNs) {
+    if (first)
+      {
+        out << "# interval_s=" << header.intervalNs / 1e9 << "\n";
+        out << "time\tflow\tsource\tdestination\ttx_packets\trx_packets\tlost\tthroughput_mbps\tmean_delay_ms\n";
+        first = false;
+      }
+    if (flow >= 0 && r.flow != static_cast<uint32_t> (flow))
+      {
+        return;
+      }
+    out << r.timeNs / 1e9 << "\t" << r.flow << "\t" << Endpoint (r.source, r.sourcePort) << "\t"
+        << Endpoint (r.destination, r.destinationPort) << "\t" << r.txPackets << "\t" << r.rxPackets << "\t"
+        << r.lostPackets << "\t" << r.rxBytes * 8.0 / durationNs * 1e3 << "\t";
+    if (r.rxPackets)
+      {
+        out << r.delaySumNs / 1e6 / r.rxPackets;
+      }
+    else
+      {
+        out << "-";
+      }
+    out << "\n";
+  });
+  if (!ok)
+    {
+      std::cerr << input << ": not a flow snapshot file" << std::endl;
+      return 1;
+    }
+  if (first)
+    {
+      out << "# interval_s=" << header.intervalNs / 1e9 << "\n";
+    }
+  return 0;
+}
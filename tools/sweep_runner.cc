@@ -0,0 +1,290 @@
+// Parallel sweep over the scenario matrix.
+//
+// Build the scenario programs once, then point the runner at the binary:
+//
+//   g++ -std=c++17 -O2 -o sweep_runner tools/sweep_runner.cc
+//   ./sweep_runner --program=build/scratch/.../ns3-dev-two_hop_scenario-default --out=sweep
+//
+// Every run executes in <out>/<run id>/ with its own run.log. Rerunning the
+// same command skips runs that finished and repeats the ones that did not.
+//
+// Families:
+//   two_hop   slide 5 (scenario 1-3) and slide 6 (scenario 1-3 x FIFO/RED)
+//   csma_bus  slide 2 (scenario 1-3) and slide 4 (scenario 2a, 2b, 3, 4)
+// each crossed with Cubic, DCTCP, NewReno and Westwood. --runs=FILE replaces
+// the built-in grid with one "<id> <arguments...>" line per run.
+// --trace=off|summary|bottleneck|full is passed on to every run, so a sweep
+// only writes the traces it is going to read. --timeout=SECONDS kills a run
+// that takes longer, so a hung program cannot hold a slot for good.
+
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "process_pool.h"
+
+static const char *g_variants[] = { "TcpCubic", "TcpDctcp", "TcpNewReno", "TcpWestwood" };
+
+static void
+AddTwoHopGrid (const std::string &program, std::vector<PoolRun> &runs)
+{
+  for (int slide = 5; slide <= 6; ++slide)
+    {
+      for (int scenario = 1; scenario <= 3; ++scenario)
+        {
+          std::vector<std::string> queues;
+          queues.push_back ("FIFO");
+          if (slide == 6)
+            {
+              queues.push_back ("RED");
+            }
+          for (const std::string &queue : queues)
+            {
+              for (const char *variant : g_variants)
+                {
+                  std::ostringstream id;
+                  id << "Slide" << slide << "_scen" << scenario << "_";
+                  if (slide == 6)
+                    {
+                      id << queue << "_";
+                    }
+                  id << variant;
+
+                  PoolRun run;
+                  run.id = id.str ();
+                  run.argv.push_back (program);
+                  run.argv.push_back ("--slide=" + std::to_string (slide));
+                  run.argv.push_back ("--scenario=" + std::to_string (scenario));
+                  run.argv.push_back ("--queue=" + queue);
+                  run.argv.push_back (std::string ("--tcp=ns3::") + variant);
+                  run.weight = 1.0;
+                  runs.push_back (run);
+                }
+            }
+        }
+    }
+}
+
+static void
+AddCsmaBusGrid (const std::string &program, std::vector<PoolRun> &runs)
+{
+  // slide, scenario, relative cost (clients x simulated seconds)
+  struct Cell
+  {
+    int slide;
+    const char *scenario;
+    double weight;
+  };
+  static const Cell cells[] = {
+    { 2, "1", 10 * 10 }, { 2, "2", 50 * 10 }, { 2, "3", 50 * 10 },
+    { 4, "2a", 30 * 10 }, { 4, "2b", 30 * 10 }, { 4, "3", 60 * 100 }, { 4, "4", 60 * 100 },
+  };
+  for (const Cell &cell : cells)
+    {
+      for (const char *variant : g_variants)
+        {
+          PoolRun run;
+          run.id = "Slide" + std::to_string (cell.slide) + "_scen" + cell.scenario + "_" + variant;
+          run.argv.push_back (program);
+          run.argv.push_back ("--slide=" + std::to_string (cell.slide));
+          run.argv.push_back (std::string ("--scenario=") + cell.scenario);
+          run.argv.push_back (std::string ("--tcp=ns3::") + variant);
+          run.weight = cell.weight;
+          runs.push_back (run);
+        }
+    }
+}
+
+static bool
+LoadRunsFile (const std::string &path, const std::string &program, std::vector<PoolRun> &runs)
+{
+  std::ifstream in (path.c_str ());
+  if (!in)
+    {
+      return false;
+    }
+  std::string line;
+  while (std::getline (in, line))
+    {
+      std::istringstream iss (line);
+      PoolRun run;
+      if (!(iss >> run.id) || run.id[0] == '#')
+        {
+          continue;
+        }
+      if (!PoolValidId (run.id))
+        {
+          std::cerr << path << ": run id \"" << run.id << "\" has to be a relative path of plain names, without '.', '..', backslashes, quotes or '$'" << std::endl;
+          return false;
+        }
+      run.argv.push_back (program);
+      std::string arg;
+      while (iss >> arg)
+        {
+          run.argv.push_back (arg);
+        }
+      run.weight = 1.0;
+      runs.push_back (run);
+    }
+  return true;
+}
+
+static std::string
+AbsolutePath (const std::string &path)
+{
+  if (path.find ('/') == std::string::npos)
+    {
+      return path; // resolved through PATH
+    }
+  char buf[PATH_MAX];
+  return realpath (path.c_str (), buf) ? std::string (buf) : path;
+}
+
+static void
+Usage ()
+{
+  std::cerr << "usage: sweep_runner --program=PATH [--family=two_hop|csma_bus] [--runs=FILE]\n"
+               "                    [--out=DIR] [--jobs=N] [--filter=SUBSTR] [--trace=LEVEL]\n"
+               "                    [--timeout=S] [--list]\n";
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string program;
+  std::string family = "two_hop";
+  std::string runsFile;
+  std::string out = "sweep";
+  std::string filter;
+  std::string trace;
+  double timeout = 0;
+  unsigned jobs = std::thread::hardware_concurrency ();
+  bool list = false;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      std::string::size_type eq = arg.find ('=');
+      std::string key = arg.substr (0, eq);
+      std::string value = (eq == std::string::npos) ? "" : arg.substr (eq + 1);
+      if (key == "--program")
+        {
+          program = value;
+        }
+      else if (key == "--family")
+        {
+          family = value;
+        }
+      else if (key == "--runs")
+        {
+          runsFile = value;
+        }
+      else if (key == "--out")
+        {
+          out = value;
+        }
+      else if (key == "--jobs")
+        {
+          jobs = static_cast<unsigned> (std::atoi (value.c_str ()));
+        }
+      else if (key == "--filter")
+        {
+          filter = value;
+        }
+      else if (key == "--trace")
+        {
+          trace = value;
+        }
+      else if (key == "--timeout")
+        {
+          timeout = std::atof (value.c_str ());
+        }
+      else if (key == "--list")
+        {
+          list = true;
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (program.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+  program = AbsolutePath (program);
+
+  std::vector<PoolRun> runs;
+  if (!runsFile.empty ())
+    {
+      if (!LoadRunsFile (runsFile, program, runs))
+        {
+          std::cerr << "cannot read " << runsFile << std::endl;
+          return 2;
+        }
+    }
+  else if (family == "two_hop")
+    {
+      AddTwoHopGrid (program, runs);
+    }
+  else if (family == "csma_bus")
+    {
+      AddCsmaBusGrid (program, runs);
+    }
+  else
+    {
+      std::cerr << "unknown family " << family << std::endl;
+      return 2;
+    }
+
+  if (!filter.empty ())
+    {
+      std::vector<PoolRun> kept;
+      for (const PoolRun &run : runs)
+        {
+          if (run.id.find (filter) != std::string::npos)
+            {
+              kept.push_back (run);
+            }
+        }
+      runs.swap (kept);
+    }
+
+  if (!trace.empty ())
+    {
+      for (PoolRun &run : runs)
+        {
+          run.argv.push_back ("--trace=" + trace);
+        }
+    }
+
+  ProcessPool pool (out, jobs);
+  pool.SetTimeout (timeout);
+  if (list)
+    {
+      for (const PoolRun &run : runs)
+        {
+          std::cout << (pool.IsDone (run) ? "done    " : pool.IsStale (run) ? "changed " : "pending ") << run.id;
+          for (std::size_t i = 1; i < run.argv.size (); ++i)
+            {
+              std::cout << " " << run.argv[i];
+            }
+          std::cout << "\n";
+        }
+      return 0;
+    }
+
+  int failed = pool.Run (runs);
+  if (failed < 0)
+    {
+      return 130;
+    }
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+// Converts a binary TCP trace (common/tcp_trace_sink.h) to the tab
+// separated "time old new" format of the .cwnd files in
+// NS3_Sim_Run_Results.
+//
+//   g++ -std=c++17 -O2 -o trace_to_cwnd tools/trace_to_cwnd.cc
+//   ./trace_to_cwnd Slide5_scen1_TcpCubic_tcp.trace > Slide5_scen1_TcpCubic_cwnd.cwnd
+//
+// --kind=ssthresh|rtt emits the other series (RTT in seconds), or one of
+// the congestion control internals: wmax (Cubic W_max, segments), epoch
+// (Cubic epoch start, seconds), alpha (DCTCP), marked (DCTCP bytes acked
+// and marked per observation window) or bw (Westwood estimate, bit/s).
+// Only one flow is converted, the first (flow 0) unless --flow=N picks
+// another one of a multi-flow trace.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../common/tcp_trace_record.h"
+
+static void
+Usage ()
+{
+  std::cerr << "usage: trace_to_cwnd [--kind=cwnd|ssthresh|rtt|wmax|epoch|alpha|marked|bw] [--flow=N] [--out=FILE] TRACE\n";
+}
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint16_t kind = TCP_TRACE_CWND;
+  uint32_t flow = 0;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      std::string arg = argv[i];
+      if (arg.compare (0, 7, "--kind=") == 0)
+        {
+          std::string value = arg.substr (7);
+          if (value == "cwnd")
+            {
+              kind = TCP_TRACE_CWND;
+            }
+          else if (value == "ssthresh")
+            {
+              kind = TCP_TRACE_SSTHRESH;
+            }
+          else if (value == "rtt")
+            {
+              kind = TCP_TRACE_RTT;
+            }
+          else if (value == "wmax")
+            {
+              kind = TCP_TRACE_CUBIC_WMAX;
+            }
+          else if (value == "epoch")
+            {
+              kind = TCP_TRACE_CUBIC_EPOCH;
+            }
+          else if (value == "alpha")
+            {
+              kind = TCP_TRACE_DCTCP_ALPHA;
+            }
+          else if (value == "marked")
+            {
+              kind = TCP_TRACE_DCTCP_MARKED;
+            }
+          else if (value == "bw")
+            {
+              kind = TCP_TRACE_WESTWOOD_BW;
+            }
+          else
+            {
+              Usage ();
+              return 2;
+            }
+        }
+      else if (arg.compare (0, 7, "--flow=") == 0)
+        {
+          char *end;
+          unsigned long value = std::strtoul (arg.c_str () + 7, &end, 10);
+          if (end == arg.c_str () + 7 || *end || arg[7] == '-' || value > UINT32_MAX)
+            {
+              Usage ();
+              return 2;
+            }
+          flow = static_cast<uint32_t> (value);
+        }
+      else if (arg.compare (0, 6, "--out=") == 0)
+        {
+          output = arg.substr (6);
+        }
+      else if (input.empty () && arg.compare (0, 2, "--") != 0)
+        {
+          input = arg;
+        }
+      else
+        {
+          Usage ();
+          return 2;
+        }
+    }
+  if (input.empty ())
+    {
+      Usage ();
+      return 2;
+    }
+
+  std::FILE *in = std::fopen (input.c_str (), "rb");
+  if (!in)
+    {
+      std::perror (input.c_str ());
+      return 1;
+    }
+  TcpTraceFileHeader header;
+  if (std::fread (&header, sizeof (header), 1, in) != 1 || !IsTcpTraceFileHeader (header))
+    {
+      std::cerr << input << ": not a TCP trace file" << std::endl;
+      std::fclose (in);
+      return 1;
+    }
+
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file)
+        {
+          std::cerr << "cannot write " << output << std::endl;
+          std::fclose (in);
+          return 1;
+        }
+    }
+  std::ostream &out = output.empty () ? std::cout : file;
+
+  std::vector<TcpTraceRecord> block (65536);
+  size_t n;
+  while ((n = std::fread (block.data (), sizeof (TcpTraceRecord), block.size (), in)) > 0)
+    {
+      for (size_t i = 0; i < n; ++i)
+        {
+          const TcpTraceRecord &r = block[i];
+          if (r.kind != kind || r.flow != flow)
+            {
+              continue;
+            }
+          out << r.timeNs / 1e9 << "\t";
+          if (kind == TCP_TRACE_RTT || kind == TCP_TRACE_CUBIC_EPOCH)
+            {
+              out << r.oldValue / 1e9 << "\t" << r.newValue / 1e9 << "\n";
+            }
+          else if (kind == TCP_TRACE_DCTCP_ALPHA)
+            {
+              out << r.oldValue / TCP_TRACE_ALPHA_SCALE << "\t" << r.newValue / TCP_TRACE_ALPHA_SCALE << "\n";
+            }
+          else
+            {
+              out << r.oldValue << "\t" << r.newValue << "\n";
+            }
+        }
+    }
+  std::fclose (in);
+  return 0;
+}